@@ -0,0 +1,119 @@
+/**
+ * @file main.cpp
+ * @author UnnamedOrange
+ * @brief Measure the per-read overhead of static and virtual dispatch, and of runtime offsets.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <memory-reader/all.h>
+
+USING_MEMORY_READER_NAMESPACE;
+
+namespace {
+    /**
+     * @brief Read the current process by memcpy, so that the cost of dispatch is not hidden by system calls.
+     */
+    struct LocalReader final : IReadMemory {
+        bool read_to_buf(std::uintptr_t address, void* buf, std::size_t size) const noexcept override {
+            std::memcpy(buf, reinterpret_cast<const void*>(address), size);
+            return true;
+        }
+        std::vector<Region> regions() const noexcept override {
+            return {};
+        }
+    };
+
+    /**
+     * @brief Hide the dynamic type of @b p from the optimizer.
+     */
+    template <typename T>
+    const T* opaque(const T* p) noexcept {
+        const T* volatile ret = p;
+        return ret;
+    }
+
+    volatile std::uintptr_t sink;
+
+    /**
+     * @brief Run @b func @b count times and print the time of each run.
+     */
+    template <typename Func>
+    void run(const char* name, std::size_t count, Func&& func) {
+        using clock = std::chrono::steady_clock;
+        std::uintptr_t sum = 0;
+        auto start = clock::now();
+        for (std::size_t i = 0; i < count; i++) {
+            sum += func();
+        }
+        auto elapsed = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+        sink = sum;
+        std::printf("%-48s %10.2f ns/op\n", name, elapsed / static_cast<double>(count));
+    }
+
+    struct Leaf {
+        std::byte padding[0x94];
+        std::uint16_t value;
+    };
+    struct Middle {
+        std::byte padding[0x38];
+        Leaf* leaf;
+    };
+    struct Root {
+        std::byte padding[0x68];
+        Middle* middle;
+    };
+} // namespace
+
+int main() {
+    auto leaf = std::make_unique<Leaf>();
+    auto middle = std::make_unique<Middle>();
+    auto root = std::make_unique<Root>();
+    leaf->value = 727;
+    middle->leaf = leaf.get();
+    root->middle = middle.get();
+    // Volatile so that reads are not hoisted out of the loops.
+    volatile std::uintptr_t base = reinterpret_cast<std::uintptr_t>(root.get());
+    volatile std::uintptr_t leaf_address = reinterpret_cast<std::uintptr_t>(&leaf->value);
+    constexpr ValueOffsets<PtrWidth::IS_CURRENT, std::uint16_t, 0x68, 0x38, 0x94> offsets;
+    // Hidden from the optimizer, as if loaded from a config file.
+    const DynamicOffsets<PtrWidth::IS_CURRENT, std::uint16_t> dynamic_offsets_storage{0x68, 0x38, 0x94};
+    const auto& dynamic_offsets = *opaque(&dynamic_offsets_storage);
+
+    constexpr std::size_t local_count = 20'000'000;
+    LocalReader local;
+    const IReadMemory& erased_local = *opaque<IReadMemory>(&local);
+    std::printf("In-process reader (memcpy), %zu runs each:\n", local_count);
+    run("read_value, IReadMemory& (virtual)", local_count,
+        [&] { return *read_value<std::uint16_t>(erased_local, leaf_address); });
+    run("read_value, LocalReader& (static)", local_count,
+        [&] { return *read_value<std::uint16_t>(local, leaf_address); });
+    run("ValueOffsets (3 levels), IReadMemory& (virtual)", local_count,
+        [&] { return *offsets.read(erased_local, base); });
+    run("ValueOffsets (3 levels), LocalReader& (static)", local_count, [&] { return *offsets.read(local, base); });
+    run("DynamicOffsets (3 levels), LocalReader& (static)", local_count,
+        [&] { return *dynamic_offsets.read(local, base); });
+
+    auto process = Process::try_from_current_process();
+    if (process.empty()) {
+        std::printf("Cannot open the current process. Skip the rest.\n");
+        return 0;
+    }
+    constexpr std::size_t process_count = 200'000;
+    const IReadMemory& erased_process = *opaque<IReadMemory>(&process);
+    std::printf("Process reader (system calls), %zu runs each:\n", process_count);
+    run("ValueOffsets (3 levels), IReadMemory& (virtual)", process_count,
+        [&] { return *offsets.read(erased_process, base); });
+    run("ValueOffsets (3 levels), Process& (static)", process_count, [&] { return *offsets.read(process, base); });
+    run("DynamicOffsets (3 levels), Process& (static)", process_count,
+        [&] { return *dynamic_offsets.read(process, base); });
+}
@@ -23,11 +23,11 @@ private:
     // Change the process name as you want.
     SingleProcessDaemon process{"example-02-single-process-daemon"};
 
-    int cache_hint{};
+    std::uint64_t cache_hint{};
 
 public:
     auto read_feature() {
-        if (int new_cache_hint = process.get_cache_hint(); process.still_alive() && cache_hint != new_cache_hint) {
+        if (auto new_cache_hint = process.get_cache_hint(); process.still_alive() && cache_hint != new_cache_hint) {
             std::cout << "Cache hint changed. Regard it as a new process." << std::endl;
             cache_hint = new_cache_hint;
         }
@@ -23,6 +23,10 @@ struct Hub {
     // Static signature leverages template to avoid any dynamic allocation.
     // The string literal is converted to Pattern implicitly.
     Signature<"7D 15 A1 ?? ?? ?? ?? 85 C0"> sig_rulesets;
+    // Steps after the pattern turn the address of the pattern into the address of data.
+    // Here the absolute address following A1 is read, starting at the byte marked by "@".
+    // The resolved address is cached together with the scan result.
+    Signature<"7D 15 A1 @?? ?? ?? ?? 85 C0", abs32()> sig_rulesets_address;
     // For convenience in multi-threading scenarios, dynamic signature should
     // be wrapped in a shared_ptr.
     // To construct a dynamic signature, you need to pass a DynamicPattern.
@@ -41,6 +45,10 @@ public:
         return hub.sig_rulesets.scan(hub.process);
     }
 
+    std::optional<std::uintptr_t> resolve_rulesets_address() noexcept {
+        return hub.sig_rulesets_address.resolve(hub.process);
+    }
+
     std::optional<std::uintptr_t> dynamic_scan_base() noexcept {
         return hub.dynamic_sig_rulesets->scan(hub.process);
     }
@@ -57,6 +65,14 @@ int main() {
                 std::cout << "Not found." << std::endl;
             }
         }
+        {
+            auto address = server.resolve_rulesets_address();
+            if (address) {
+                std::cout << "Resolved address = " << std::hex << *address << std::endl;
+            } else {
+                std::cout << "Not resolved." << std::endl;
+            }
+        }
         {
             auto base = server.dynamic_scan_base();
             if (base) {
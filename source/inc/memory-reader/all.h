@@ -9,9 +9,30 @@
 
 #pragma once
 
+#include "process/CoreReader.h"
+#include "process/FileImageReader.h"
+#include "process/MappedReader.h"
+#include "process/MemoryReader.h"
 #include "process/Process.h"
+#include "process/Recording.h"
 #include "process/SingleProcessDaemon.h"
 
+#include "feature/AsyncReader.h"
+#include "feature/ChangedRange.h"
+#include "feature/Containers.h"
+#include "feature/DirtyPageTracker.h"
 #include "feature/Offsets.h"
 #include "feature/Pattern.h"
+#include "feature/PatternIndex.h"
+#include "feature/PointerScanner.h"
+#include "feature/RegionReader.h"
+#include "feature/Sampler.h"
+#include "feature/ScanScheduler.h"
+#include "feature/SharedExport.h"
 #include "feature/Signature.h"
+#include "feature/SignatureManifest.h"
+#include "feature/SignatureStep.h"
+#include "feature/Snapshot.h"
+#include "feature/Strings.h"
+#include "feature/ValueScanner.h"
+#include "feature/Watcher.h"
@@ -0,0 +1,178 @@
+/**
+ * @file AsyncReader.h
+ * @author UnnamedOrange
+ * @brief Read memory asynchronously with coroutines, batching concurrent reads.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "../process/IReadMemory.h"
+#include "../utils/macro.h"
+
+MEMORY_READER_NAMESPACE_BEGIN
+
+/**
+ * @brief Options of @ref AsyncReader.
+ */
+struct AsyncReaderOptions {
+    /**
+     * @brief The number of worker threads. One is usually enough, since reads are batched.
+     */
+    std::size_t threads = 1;
+    /**
+     * @brief At most this many reads are issued in one batch.
+     */
+    std::size_t max_batch = 1024;
+    /**
+     * @brief Called on a worker thread to resume a coroutine whose read has completed,
+     * e.g. by posting it to an event loop. If empty, the coroutine is resumed on the worker thread.
+     */
+    std::function<void(std::coroutine_handle<>)> resume{};
+};
+
+/**
+ * @brief Read memory asynchronously with coroutines.
+ *
+ * Each awaited read is queued to a small pool of worker threads.
+ * A worker takes all queued reads at once and issues them by one @ref IReadMemory::read_to_bufs,
+ * so many reads in flight cost few system calls. The awaiting coroutine is resumed on completion.
+ *
+ * @code
+ * Task read_combo(AsyncReader& reader, std::uintptr_t address) {
+ *     auto combo = co_await reader.read<std::uint16_t>(address);
+ * }
+ * @endcode
+ */
+class AsyncReader {
+    using Self = AsyncReader;
+
+public:
+    /**
+     * @brief A queued read. It lives in the awaitable, i.e. in the frame of the awaiting coroutine.
+     */
+    struct Operation {
+        ReadRequest request;
+        std::coroutine_handle<> handle;
+    };
+
+    /**
+     * @brief Awaitable of @ref read_to_buf. co_await returns whether all bytes have been read.
+     */
+    class BufferAwaitable {
+    private:
+        Self& owner;
+        Operation operation;
+
+    public:
+        BufferAwaitable(Self& owner, std::uintptr_t address, void* buf, std::size_t size) noexcept
+            : owner(owner), operation{.request = {.address = address, .buf = buf, .size = size}, .handle = {}} {}
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+        void await_suspend(std::coroutine_handle<> handle) {
+            operation.handle = handle;
+            owner.submit(operation);
+        }
+        bool await_resume() const noexcept {
+            return operation.request.ok;
+        }
+    };
+
+    /**
+     * @brief Awaitable of @ref read. co_await returns the value, or std::nullopt on failure.
+     */
+    template <typename T>
+    class ValueAwaitable {
+    private:
+        Self& owner;
+        T value;
+        Operation operation;
+
+    public:
+        ValueAwaitable(Self& owner, std::uintptr_t address) noexcept
+            : owner(owner),
+              operation{.request = {.address = address, .buf = nullptr, .size = sizeof(T)}, .handle = {}} {}
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+        void await_suspend(std::coroutine_handle<> handle) {
+            // The awaitable does not move once awaited, so the buffer can point into it.
+            operation.request.buf = &value;
+            operation.handle = handle;
+            owner.submit(operation);
+        }
+        std::optional<T> await_resume() const noexcept {
+            if (!operation.request.ok) {
+                return std::nullopt;
+            }
+            return value;
+        }
+    };
+
+private:
+    const IReadMemory& reader;
+    AsyncReaderOptions options;
+
+    mutable std::mutex m_queue;
+    std::condition_variable cv_queue;
+    std::deque<Operation*> queue;
+    bool should_exit = false;
+
+    std::vector<std::thread> workers;
+
+public:
+    /**
+     * @note @b reader MUST have a longer life span than this object.
+     */
+    AsyncReader(const IReadMemory& reader, AsyncReaderOptions options = {});
+    AsyncReader(const Self&) = delete;
+    Self& operator=(const Self&) = delete;
+    AsyncReader(Self&&) = delete;
+    Self& operator=(Self&&) = delete;
+
+    /**
+     * @brief Complete all queued reads, then stop the workers.
+     */
+    ~AsyncReader();
+
+private:
+    void worker_routine();
+    void submit(Operation& operation);
+
+public:
+    /**
+     * @brief Read memory to a buffer asynchronously.
+     *
+     * @note @b buf MUST stay valid until the awaiting coroutine is resumed.
+     */
+    [[nodiscard]] BufferAwaitable read_to_buf(std::uintptr_t address, void* buf, std::size_t size) noexcept {
+        return BufferAwaitable(*this, address, buf, size);
+    }
+    /**
+     * @brief Read a plain old data type asynchronously.
+     */
+    template <typename T>
+        requires std::is_trivial_v<T> && std::is_standard_layout_v<T>
+    [[nodiscard]] ValueAwaitable<T> read(std::uintptr_t address) noexcept {
+        return ValueAwaitable<T>(*this, address);
+    }
+};
+
+MEMORY_READER_NAMESPACE_END
@@ -0,0 +1,29 @@
+/**
+ * @file ChangedRange.h
+ * @author UnnamedOrange
+ * @brief A range of changed bytes, shared by snapshots, dirty page tracking and value scanning.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../utils/macro.h"
+
+MEMORY_READER_NAMESPACE_BEGIN
+
+/**
+ * @brief A range of bytes which differ between two snapshots, or which may have been written.
+ */
+struct ChangedRange {
+    std::uintptr_t address;
+    std::size_t size;
+
+    bool operator==(const ChangedRange&) const = default;
+};
+
+MEMORY_READER_NAMESPACE_END
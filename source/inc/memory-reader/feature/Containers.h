@@ -0,0 +1,176 @@
+/**
+ * @file Containers.h
+ * @author UnnamedOrange
+ * @brief Structures reading arrays and lists laid out in the to-be-read process.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include "../process/IReadMemory.h"
+#include "../process/MemoryReader.h"
+#include "../utils/macro.h"
+
+MEMORY_READER_NAMESPACE_BEGIN
+
+namespace __detail {
+    template <typename T, MemoryReader Reader>
+    inline std::optional<std::vector<T>> read_elements(const Reader& reader, std::uintptr_t address,
+                                                       std::size_t count) noexcept {
+        std::vector<T> ret;
+        try {
+            ret.resize(count);
+        } catch (...) {
+            return std::nullopt;
+        }
+        // Read into the result directly.
+        if (count && !reader.read_to_buf(address, ret.data(), count * sizeof(T))) {
+            return std::nullopt;
+        }
+        return ret;
+    }
+} // namespace __detail
+
+/**
+ * @brief One-dimensional zero-based array of .NET (T[]).
+ *
+ * The object is laid out as a method table pointer, a pointer-width length field
+ * (of which only the lower 32 bits are used), and then the elements.
+ *
+ * @tparam width The width of the pointer in the to-be-read process.
+ * @tparam T Type of the elements. For arrays of references, use @ref PtrType.
+ * @tparam max_count Arrays longer than this are regarded as corrupted.
+ */
+template <PtrWidth width, typename T, std::size_t max_count = 0x100000>
+    requires std::is_trivial_v<T> && std::is_standard_layout_v<T>
+class ClrArray {
+public:
+    static constexpr std::size_t length_offset = static_cast<std::size_t>(width);
+    static constexpr std::size_t data_offset = length_offset * 2;
+
+public:
+    /**
+     * @brief Read the length of the array only.
+     */
+    template <MemoryReader Reader>
+    std::optional<std::size_t> read_length(const Reader& reader, std::uintptr_t address) const noexcept {
+        if (!address) {
+            return std::nullopt;
+        }
+        auto length = read_value<std::int32_t>(reader, address + length_offset);
+        if (!length || *length < 0 || static_cast<std::size_t>(*length) > max_count) {
+            return std::nullopt;
+        }
+        return static_cast<std::size_t>(*length);
+    }
+    /**
+     * @brief Read all the elements with two reads, one for the length and one for the elements.
+     *
+     * @param address Address of the array object, i.e. the value of a reference to it.
+     * @return std::optional<std::vector<T>> If succeeded, return the elements. Otherwise, return std::nullopt.
+     */
+    template <MemoryReader Reader>
+    std::optional<std::vector<T>> read(const Reader& reader, std::uintptr_t address) const noexcept {
+        auto length = read_length(reader, address);
+        if (!length) {
+            return std::nullopt;
+        }
+        return __detail::read_elements<T>(reader, address + data_offset, *length);
+    }
+};
+
+/**
+ * @brief The .NET runtime, which decides the layout of some classes of the base class library.
+ */
+enum class ClrRuntime {
+    /**
+     * @brief .NET Core and .NET 5 or later.
+     */
+    CORE,
+    /**
+     * @brief .NET Framework.
+     */
+    FRAMEWORK,
+};
+
+/**
+ * @brief System.Collections.Generic.List<T> of .NET.
+ *
+ * The object is laid out as a method table pointer, a reference to the backing array,
+ * and then a 32-bit count. On .NET Framework, a reference to the sync root is between them.
+ * Only the first count elements of the backing array are valid.
+ *
+ * There is no default runtime, since reading with the wrong one silently takes the sync root as the count.
+ * osu! stable runs on .NET Framework.
+ *
+ * @tparam width The width of the pointer in the to-be-read process.
+ * @tparam T Type of the elements. For lists of references, use @ref PtrType.
+ * @tparam max_count Lists longer than this are regarded as corrupted.
+ */
+template <PtrWidth width, typename T, std::size_t max_count = 0x100000>
+    requires std::is_trivial_v<T> && std::is_standard_layout_v<T>
+class ClrList {
+private:
+    struct CoreHeader {
+        PtrType<width> items;
+        std::int32_t size;
+    };
+    struct FrameworkHeader {
+        PtrType<width> items;
+        PtrType<width> sync_root;
+        std::int32_t size;
+    };
+    static constexpr std::size_t header_offset = static_cast<std::size_t>(width);
+
+    ClrRuntime runtime;
+
+public:
+    /**
+     * @param runtime The runtime of the to-be-read process.
+     */
+    explicit ClrList(ClrRuntime runtime) noexcept : runtime(runtime) {}
+
+private:
+    template <typename Header, MemoryReader Reader>
+    static std::optional<std::vector<T>> read_impl(const Reader& reader, std::uintptr_t address) noexcept {
+        auto header = read_value<Header>(reader, address + header_offset);
+        if (!header || !header->items || header->size < 0 || static_cast<std::size_t>(header->size) > max_count) {
+            return std::nullopt;
+        }
+        return __detail::read_elements<T>(reader,
+                                          static_cast<std::uintptr_t>(header->items) +
+                                              ClrArray<width, T, max_count>::data_offset,
+                                          static_cast<std::size_t>(header->size));
+    }
+
+public:
+    /**
+     * @brief Read all the valid elements with two reads,
+     * one for the reference and the count, and one for the elements.
+     *
+     * The length of the backing array is not checked, to save a read.
+     *
+     * @param address Address of the list object, i.e. the value of a reference to it.
+     * @return std::optional<std::vector<T>> If succeeded, return the elements. Otherwise, return std::nullopt.
+     */
+    template <MemoryReader Reader>
+    std::optional<std::vector<T>> read(const Reader& reader, std::uintptr_t address) const noexcept {
+        if (!address) {
+            return std::nullopt;
+        }
+        if (runtime == ClrRuntime::FRAMEWORK) {
+            return read_impl<FrameworkHeader>(reader, address);
+        }
+        return read_impl<CoreHeader>(reader, address);
+    }
+};
+
+MEMORY_READER_NAMESPACE_END
@@ -0,0 +1,115 @@
+/**
+ * @file DirtyPageTracker.h
+ * @author UnnamedOrange
+ * @brief Find pages of a process written since a checkpoint, by soft-dirty bits.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "../process/IReadMemory.h"
+#include "../process/Process.h"
+#include "../utils/macro.h"
+#include "Snapshot.h"
+
+MEMORY_READER_NAMESPACE_BEGIN
+
+/**
+ * @brief Find pages of a process written since a checkpoint.
+ *
+ * On Linux, @ref checkpoint clears the soft-dirty bits of the process by /proc/<pid>/clear_refs,
+ * and @ref dirty_ranges collects the pages whose bits are set again from /proc/<pid>/pagemap.
+ * Pass the ranges to @ref Snapshot::capture_incremental or @ref ValueScanner::next_scan,
+ * so that only written pages are read.
+ *
+ * Tracking needs a kernel built with soft-dirty support and the permission to write clear_refs.
+ * If either is missing, @ref dirty_ranges returns std::nullopt, and everything should be read as usual.
+ * Currently only Linux is supported.
+ *
+ * @code
+ * DirtyPageTracker tracker(process);
+ * tracker.checkpoint();
+ * auto before = Snapshot::capture(process);
+ * // ...
+ * auto dirty = tracker.dirty_ranges(before);
+ * auto after = dirty ? Snapshot::capture_incremental(process, before, *dirty) : Snapshot::capture(process);
+ * @endcode
+ */
+class DirtyPageTracker {
+    using Self = DirtyPageTracker;
+
+private:
+    const Process& process;
+    std::size_t system_page_size;
+    bool is_supported;
+    /**
+     * @brief The cache hint of the process at the last checkpoint.
+     */
+    std::optional<std::uint64_t> checkpoint_cache_hint;
+
+public:
+    /**
+     * @note @b process MUST have a longer life span than this object.
+     */
+    explicit DirtyPageTracker(const Process& process) noexcept;
+
+private:
+    /**
+     * @brief Whether the kernel reports soft-dirty bits,
+     * probed by faulting in a page of the current process, which is always soft-dirty.
+     */
+    [[nodiscard]] static bool probe_support() noexcept;
+    [[nodiscard]] static std::size_t query_page_size() noexcept;
+
+public:
+    /**
+     * @brief Whether the kernel supports soft-dirty tracking.
+     * Tracking may still fail for lack of permission.
+     */
+    [[nodiscard]] bool supported() const noexcept {
+        return is_supported;
+    }
+    /**
+     * @brief The size of the pages reported by @ref dirty_ranges.
+     */
+    [[nodiscard]] std::size_t page_size() const noexcept {
+        return system_page_size;
+    }
+    /**
+     * @brief Clear the soft-dirty bits, so that pages written from now on are reported.
+     *
+     * @return true Succeeded.
+     * @return false Not supported or not permitted. Previous checkpoint is dropped.
+     */
+    bool checkpoint() noexcept;
+    /**
+     * @brief Get pages in @b regions written since the last checkpoint.
+     *
+     * Pages of mappings created after the checkpoint are reported as written.
+     * Regions not listed are not examined, so newly mapped regions should be handled by the caller.
+     *
+     * @return std::optional<std::vector<ChangedRange>> Sorted and merged page-aligned ranges.
+     * If there is no checkpoint, the process has been replaced, or pagemap cannot be read, return std::nullopt.
+     */
+    [[nodiscard]] std::optional<std::vector<ChangedRange>> dirty_ranges(std::span<const Region> regions) const;
+    /**
+     * @brief Get pages in regions satisfying @b filter written since the last checkpoint.
+     */
+    [[nodiscard]] std::optional<std::vector<ChangedRange>> dirty_ranges(const RegionFilter& filter = {}) const {
+        return dirty_ranges(process.query_regions(filter));
+    }
+    /**
+     * @brief Get pages in the regions of @b snapshot written since the last checkpoint.
+     */
+    [[nodiscard]] std::optional<std::vector<ChangedRange>> dirty_ranges(const Snapshot& snapshot) const;
+};
+
+MEMORY_READER_NAMESPACE_END
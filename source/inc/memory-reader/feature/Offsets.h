@@ -9,31 +9,39 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <initializer_list>
+#include <optional>
 #include <ranges>
 #include <span>
+#include <vector>
 
 #include "../process/IReadMemory.h"
+#include "../process/MemoryReader.h"
 #include "../utils/macro.h"
 
 MEMORY_READER_NAMESPACE_BEGIN
 
 namespace __detail {
-    template <typename T>
-    inline std::optional<T> offset_read_once(const IReadMemory& reader, std::uintptr_t base,
+    template <typename T, MemoryReader Reader>
+    inline std::optional<T> offset_read_once(const Reader& reader, std::uintptr_t base,
                                              std::intptr_t offset) noexcept {
         auto addr = base + static_cast<std::uintptr_t>(offset);
-        return reader.read<T>(addr);
+        return read_value<T>(reader, addr);
     }
-    template <PtrWidth width>
-    inline std::optional<std::uintptr_t> offset_read_ptr_once(const IReadMemory& reader, std::uintptr_t base,
+    template <PtrWidth width, MemoryReader Reader>
+    inline std::optional<std::uintptr_t> offset_read_ptr_once(const Reader& reader, std::uintptr_t base,
                                                               std::intptr_t offset) noexcept {
         auto addr = base + static_cast<std::uintptr_t>(offset);
         // Invoke type check here.
-        return reader.read<width>(addr);
+        return read_pointer<width>(reader, addr);
     }
-    template <PtrWidth width, typename T, std::intptr_t crt_offset, std::intptr_t... consequent_offsets>
-    inline std::optional<T> template_offsets_read(const IReadMemory& reader, std::uintptr_t base) noexcept {
+    template <PtrWidth width, typename T, std::intptr_t crt_offset, std::intptr_t... consequent_offsets,
+              MemoryReader Reader>
+    inline std::optional<T> template_offsets_read(const Reader& reader, std::uintptr_t base) noexcept {
         if constexpr (sizeof...(consequent_offsets) == 0) {
             return offset_read_once<T>(reader, base, crt_offset);
         } else {
@@ -49,7 +57,13 @@ namespace __detail {
 template <PtrWidth width, typename T, std::intptr_t... offsets>
 class ValueOffsets {
 public:
-    std::optional<T> read(const IReadMemory& reader, std::uintptr_t base) const noexcept {
+    using value_type = T;
+    static constexpr PtrWidth ptr_width = width;
+    static constexpr std::array<std::intptr_t, sizeof...(offsets)> offset_array{offsets...};
+
+public:
+    template <MemoryReader Reader>
+    std::optional<T> read(const Reader& reader, std::uintptr_t base) const noexcept {
         return __detail::template_offsets_read<width, T, offsets...>(reader, base);
     }
 };
@@ -57,4 +71,110 @@ public:
 template <PtrWidth width, std::intptr_t... offsets>
 using PtrOffsets = ValueOffsets<width, PtrType<width>, offsets...>;
 
+/**
+ * @brief Same as @ref ValueOffsets, but the offsets are given at runtime, e.g. loaded from a config file.
+ *
+ * Up to @ref inline_capacity offsets are stored inline, so typical chains need no heap allocation.
+ * If there is no offset, the value is read at the base directly.
+ */
+template <PtrWidth width, typename T>
+class DynamicOffsets {
+    using Self = DynamicOffsets;
+
+public:
+    using value_type = T;
+    static constexpr PtrWidth ptr_width = width;
+    static constexpr std::size_t inline_capacity = 8;
+
+private:
+    std::size_t count = 0;
+    std::array<std::intptr_t, inline_capacity> inline_offsets{};
+    /**
+     * @brief Used instead of @ref inline_offsets if there are more than @ref inline_capacity offsets.
+     */
+    std::vector<std::intptr_t> heap_offsets;
+
+public:
+    DynamicOffsets() noexcept = default;
+    DynamicOffsets(std::initializer_list<std::intptr_t> offsets) : Self(std::span(offsets.begin(), offsets.size())) {}
+    explicit DynamicOffsets(std::span<const std::intptr_t> offsets) : count(offsets.size()) {
+        if (count <= inline_capacity) {
+            std::ranges::copy(offsets, inline_offsets.begin());
+        } else {
+            heap_offsets.assign(offsets.begin(), offsets.end());
+        }
+    }
+    /**
+     * @brief Make it from the offsets of a @ref ValueOffsets.
+     */
+    template <std::intptr_t... offsets>
+    DynamicOffsets(const ValueOffsets<width, T, offsets...>&) : Self{offsets...} {}
+
+public:
+    [[nodiscard]] std::span<const std::intptr_t> offsets() const noexcept {
+        return {count <= inline_capacity ? inline_offsets.data() : heap_offsets.data(), count};
+    }
+    [[nodiscard]] std::size_t size() const noexcept {
+        return count;
+    }
+    [[nodiscard]] bool empty() const noexcept {
+        return !count;
+    }
+
+private:
+    /**
+     * @brief Follow exactly @b N offsets, unrolled like @ref ValueOffsets.
+     */
+    template <std::size_t N, MemoryReader Reader>
+    std::optional<T> read_unrolled(const Reader& reader, std::uintptr_t base) const noexcept {
+        const auto& list = inline_offsets;
+        bool ok = true;
+        [&]<std::size_t... i>(std::index_sequence<i...>) {
+            ((ok = ok && [&] {
+                 auto addr = __detail::offset_read_ptr_once<width>(reader, base, list[i]);
+                 base = addr.value_or(0);
+                 return addr.has_value();
+             }()),
+             ...);
+        }(std::make_index_sequence<N - 1>{});
+        if (!ok) {
+            return std::nullopt;
+        }
+        return __detail::offset_read_once<T>(reader, base, list[N - 1]);
+    }
+
+public:
+    template <MemoryReader Reader>
+    std::optional<T> read(const Reader& reader, std::uintptr_t base) const noexcept {
+        // Dispatch once on the depth, so that each level is as cheap as in ValueOffsets.
+        switch (count) {
+        case 0: return read_value<T>(reader, base);
+        case 1: return read_unrolled<1>(reader, base);
+        case 2: return read_unrolled<2>(reader, base);
+        case 3: return read_unrolled<3>(reader, base);
+        case 4: return read_unrolled<4>(reader, base);
+        case 5: return read_unrolled<5>(reader, base);
+        case 6: return read_unrolled<6>(reader, base);
+        case 7: return read_unrolled<7>(reader, base);
+        case 8: return read_unrolled<8>(reader, base);
+        default: break;
+        }
+        for (std::size_t i = 0; i + 1 < count; i++) {
+            auto addr = __detail::offset_read_ptr_once<width>(reader, base, heap_offsets[i]);
+            if (!addr) {
+                return std::nullopt;
+            }
+            base = *addr;
+        }
+        return __detail::offset_read_once<T>(reader, base, heap_offsets.back());
+    }
+
+    bool operator==(const Self& other) const noexcept {
+        return std::ranges::equal(offsets(), other.offsets());
+    }
+};
+
+template <PtrWidth width>
+using DynamicPtrOffsets = DynamicOffsets<width, PtrType<width>>;
+
 MEMORY_READER_NAMESPACE_END
@@ -9,13 +9,15 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
-#include <concepts>
 #include <cstddef>
 #include <cstdint>
-#include <numeric>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <span>
 #include <stdexcept>
-#include <string>
 #include <string_view>
 #include <vector>
 
@@ -25,69 +27,393 @@ MEMORY_READER_NAMESPACE_BEGIN
 
 inline constexpr auto DynamicPatternFlag = (std::numeric_limits<std::size_t>::max)();
 
+/**
+ * @brief One byte of a pattern. A byte matches if (byte & mask) equals the stored byte.
+ */
 struct PatternElement {
+    /**
+     * @brief The expected bits, already masked.
+     */
     std::byte byte;
+    /**
+     * @brief Whether any byte matches.
+     */
     bool is_mask;
+    /**
+     * @brief Bits to be compared. Ignored if @ref is_mask is true.
+     */
+    std::byte mask{0xFF};
 };
 
-template <std::size_t RAW_SIZE>
-    requires(RAW_SIZE != 0 && RAW_SIZE % 3 == 0)
-class Pattern : public std::array<PatternElement, RAW_SIZE / 3> {
-private:
+/**
+ * @brief Why a pattern string is invalid.
+ */
+struct PatternError {
+    /**
+     * @brief Index of the first character of the invalid token.
+     */
+    std::size_t position;
+    const char* message;
+};
+
+namespace __detail {
+    /**
+     * @brief The maximum number of bytes skipped by one "[n]".
+     */
+    inline constexpr std::size_t max_pattern_skip = 0x10000;
+
+    constexpr bool is_pattern_space(char ch) noexcept {
+        return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r' || ch == '\v' || ch == '\f';
+    }
     /**
      * @brief Convert a hexadecimal digit character to uint8_t.
+     *
+     * @return std::optional<std::uint8_t> If @b ch is not a hexadecimal digit, return std::nullopt.
      */
-    static consteval std::uint8_t to_digit(char ch) {
+    constexpr std::optional<std::uint8_t> to_digit(char ch) noexcept {
         if ('0' <= ch && ch <= '9')
             return ch - '0';
         else if ('A' <= ch && ch <= 'F')
             return ch - 'A' + 10;
         else if ('a' <= ch && ch <= 'f')
             return ch - 'a' + 10;
-        throw;
+        return std::nullopt;
     }
     /**
-     * @brief Concatenate two hexadecimal digits to one std::byte.
+     * @brief Parse two characters, each of which is a hexadecimal digit or '?' matching any nibble.
+     *
+     * @return std::optional<PatternElement> If any character is invalid, return std::nullopt.
      */
-    static consteval std::byte concat_digit(std::uint8_t low_digit, std::uint8_t high_digit) {
-        if (!(low_digit > 0xF || high_digit > 0xF))
-            return std::byte((high_digit << 4) | low_digit);
-        throw;
+    constexpr std::optional<PatternElement> parse_pattern_byte(char high_ch, char low_ch) noexcept {
+        std::uint8_t value = 0;
+        std::uint8_t mask = 0;
+        if (high_ch != '?') {
+            auto digit = to_digit(high_ch);
+            if (!digit)
+                return std::nullopt;
+            value |= *digit << 4;
+            mask |= 0xF0;
+        }
+        if (low_ch != '?') {
+            auto digit = to_digit(low_ch);
+            if (!digit)
+                return std::nullopt;
+            value |= *digit;
+            mask |= 0x0F;
+        }
+        return PatternElement{.byte = std::byte(value), .is_mask = mask == 0, .mask = std::byte(mask)};
     }
 
-public:
-    consteval Pattern(const char (&pattern_str)[RAW_SIZE]) noexcept {
-        for (std::size_t i = 0; i < this->size(); i++) {
-            char high_ch = pattern_str[i * 3 + 0];
-            char low_ch = pattern_str[i * 3 + 1];
-            if (low_ch == '?' || high_ch == '?') {
-                (*this)[i] = {.byte = std::byte{}, .is_mask = true};
+    /**
+     * @brief Parse a pattern string shared by @ref Pattern and @ref DynamicPattern, without throwing.
+     *
+     * Tokens are separated by whitespaces:
+     * - "8B": A byte.
+     * - "??" or "?": Any byte.
+     * - "4?" or "?4": A byte with one nibble being anything.
+     * - "40&F0": A byte whose masked bits equal the masked value.
+     * - "[4]": Skip 4 bytes, i.e., "?? ?? ?? ??".
+     * - "@": Mark the offset of the next byte, e.g., where an operand to be read starts.
+     *   It can also prefix a token, like "@??".
+     *
+     * Nothing is allocated. Elements are reported through the callbacks.
+     *
+     * @param on_element Called as on_element(element, count) for each element repeated count times.
+     * @param on_marker Called as on_marker() when the marker is met.
+     * @return std::optional<PatternError> The error, or std::nullopt if the string is valid.
+     */
+    template <typename OnElement, typename OnMarker>
+    constexpr std::optional<PatternError> try_parse_pattern(std::string_view str, OnElement&& on_element,
+                                                            OnMarker&& on_marker) {
+        bool marked = false;
+        bool pending_marker = false;
+        std::size_t i = 0;
+        while (true) {
+            while (i < str.size() && is_pattern_space(str[i]))
+                i++;
+            if (i == str.size())
+                break;
+            const auto position = i;
+            auto end = i;
+            while (end < str.size() && !is_pattern_space(str[end]))
+                end++;
+            auto token = str.substr(i, end - i);
+            i = end;
+            auto error = [position](const char* message) { return PatternError{position, message}; };
+
+            if (token.front() == '@') {
+                if (marked)
+                    return error("There should be at most one marker in pattern_str.");
+                marked = pending_marker = true;
+                on_marker();
+                token.remove_prefix(1);
+                if (token.empty())
+                    continue;
+            }
+            pending_marker = false;
+
+            if (token.front() == '[') {
+                if (token.size() < 3 || token.back() != ']')
+                    return error("Invalid skip in pattern_str.");
+                std::size_t count = 0;
+                for (auto ch : token.substr(1, token.size() - 2)) {
+                    if (ch < '0' || ch > '9')
+                        return error("Invalid skip in pattern_str.");
+                    count = count * 10 + static_cast<std::size_t>(ch - '0');
+                    if (count > max_pattern_skip)
+                        return error("Skip in pattern_str is too large.");
+                }
+                if (count)
+                    on_element(PatternElement{.byte = std::byte{}, .is_mask = true, .mask = std::byte{}}, count);
+            } else if (token == "?") {
+                on_element(PatternElement{.byte = std::byte{}, .is_mask = true, .mask = std::byte{}}, 1);
+            } else if (token.size() == 2) {
+                auto element = parse_pattern_byte(token[0], token[1]);
+                if (!element)
+                    return error("Invalid hexadecimal digit in pattern_str.");
+                on_element(*element, 1);
+            } else if (token.size() == 5 && token[2] == '&') {
+                auto value = parse_pattern_byte(token[0], token[1]);
+                auto mask = parse_pattern_byte(token[3], token[4]);
+                if (!value || !mask || value->mask != std::byte{0xFF} || mask->mask != std::byte{0xFF})
+                    return error("Invalid bit mask in pattern_str.");
+                on_element(PatternElement{
+                               .byte = value->byte & mask->byte,
+                               .is_mask = mask->byte == std::byte{},
+                               .mask = mask->byte,
+                           },
+                           1);
             } else {
-                (*this)[i] = {.byte = concat_digit(to_digit(low_ch), to_digit(high_ch)), .is_mask = false};
+                return error("Invalid token in pattern_str.");
             }
         }
+        if (pending_marker)
+            return PatternError{str.size(), "The marker should be followed by a byte in pattern_str."};
+        return std::nullopt;
+    }
+    /**
+     * @brief Same as @ref try_parse_pattern, but throws on errors.
+     *
+     * @throw std::invalid_argument If the string is invalid.
+     * In constant evaluation, this results in a compile error.
+     */
+    template <typename OnElement, typename OnMarker>
+    constexpr void parse_pattern(std::string_view str, OnElement&& on_element, OnMarker&& on_marker) {
+        if (auto error = try_parse_pattern(str, on_element, on_marker))
+            throw std::invalid_argument(error->message);
     }
+} // namespace __detail
+
+/**
+ * @brief Consecutive identical elements of a @ref Pattern.
+ */
+struct PatternToken {
+    PatternElement element;
+    std::size_t count;
 };
 
+/**
+ * @brief Pattern parsed at compile time. See @ref __detail::parse_pattern for the syntax.
+ *
+ * All members are public so that it can be used as a template parameter.
+ * Elements are stored as tokens, so skips take little space.
+ */
+template <std::size_t RAW_SIZE>
+    requires(RAW_SIZE != 0)
+class Pattern {
+public:
+    std::array<PatternToken, RAW_SIZE> tokens{};
+    std::size_t token_count = 0;
+    std::size_t length = 0;
+    std::size_t marker_offset = DynamicPatternFlag;
+
+public:
+    consteval Pattern(const char (&pattern_str)[RAW_SIZE]) {
+        __detail::parse_pattern(
+            std::string_view(pattern_str, RAW_SIZE - 1),
+            [this](PatternElement element, std::size_t count) {
+                tokens[token_count++] = {.element = element, .count = count};
+                length += count;
+            },
+            [this] { marker_offset = length; });
+        if (!length)
+            throw std::invalid_argument("pattern_str should not be empty.");
+    }
+
+public:
+    [[nodiscard]] constexpr std::size_t size() const noexcept {
+        return length;
+    }
+    [[nodiscard]] constexpr bool empty() const noexcept {
+        return !length;
+    }
+    [[nodiscard]] constexpr PatternElement operator[](std::size_t index) const noexcept {
+        for (std::size_t i = 0; i < token_count; i++) {
+            if (index < tokens[i].count)
+                return tokens[i].element;
+            index -= tokens[i].count;
+        }
+        return {};
+    }
+    /**
+     * @brief The offset marked by "@", if any.
+     */
+    [[nodiscard]] constexpr std::optional<std::size_t> marker() const noexcept {
+        if (marker_offset == DynamicPatternFlag)
+            return std::nullopt;
+        return marker_offset;
+    }
+};
+
+/**
+ * @brief Pattern parsed at runtime. See @ref __detail::parse_pattern for the syntax.
+ */
 class DynamicPattern : public std::vector<PatternElement> {
     using Self = DynamicPattern;
 
+private:
+    std::size_t marker_offset = DynamicPatternFlag;
+
 public:
     DynamicPattern() noexcept = default;
+    /**
+     * @throw std::invalid_argument If @b pattern_str is invalid.
+     */
     DynamicPattern(std::string_view pattern_str) {
-        Self& self = *this;
-        if ((pattern_str.length() + 1) % 3 != 0)
-            throw std::invalid_argument("Length of pattern_str is invalid.");
-        self.resize((pattern_str.length() + 1) / 3);
-        for (std::size_t i = 0; i < self.size(); i++) {
-            auto number = std::string(pattern_str.substr(i * 3, 2));
-            if (number[0] == '?' || number[1] == '?') {
-                self[i] = {.byte = std::byte{}, .is_mask = true};
-            } else {
-                self[i] = {.byte = static_cast<std::byte>(std::stoul(number, nullptr, 16)), .is_mask = false};
+        __detail::parse_pattern(
+            pattern_str, [this](PatternElement element, std::size_t count) { insert(end(), count, element); },
+            [this] { marker_offset = size(); });
+    }
+
+    /**
+     * @brief Parse @b pattern_str without throwing.
+     *
+     * @param error If not null, set to the reason on failure.
+     * @return std::optional<DynamicPattern> The pattern, or std::nullopt if @b pattern_str is invalid.
+     */
+    [[nodiscard]] static std::optional<Self> try_parse(std::string_view pattern_str,
+                                                       PatternError* error = nullptr) noexcept {
+        try {
+            Self ret;
+            // Reserve for the common case, where each byte takes 3 characters.
+            ret.reserve(pattern_str.size() / 3 + 1);
+            auto result = __detail::try_parse_pattern(
+                pattern_str,
+                [&ret](PatternElement element, std::size_t count) { ret.insert(ret.end(), count, element); },
+                [&ret] { ret.marker_offset = ret.size(); });
+            if (!result)
+                return ret;
+            if (error)
+                *error = *result;
+        } catch (...) {
+            if (error)
+                *error = PatternError{0, "Out of memory."};
+        }
+        return std::nullopt;
+    }
+
+public:
+    /**
+     * @brief The offset marked by "@", if any.
+     */
+    [[nodiscard]] std::optional<std::size_t> marker() const noexcept {
+        if (marker_offset == DynamicPatternFlag)
+            return std::nullopt;
+        return marker_offset;
+    }
+};
+
+/**
+ * @brief A pattern compiled to value and mask vectors for matching.
+ *
+ * Bytes are compared 8 at a time as (data ^ value) & mask.
+ * If the pattern has a fully specified byte, candidates are located by memchr on it first.
+ */
+class CompiledPattern {
+    using Self = CompiledPattern;
+
+private:
+    static constexpr std::size_t no_anchor = DynamicPatternFlag;
+
+    std::vector<std::uint64_t> value_words;
+    std::vector<std::uint64_t> mask_words;
+    std::size_t length = 0;
+    std::size_t anchor = no_anchor;
+    std::byte anchor_byte{};
+    std::optional<std::size_t> marker_offset;
+
+public:
+    CompiledPattern() noexcept = default;
+    template <typename pattern_t>
+    explicit CompiledPattern(const pattern_t& pattern)
+        : value_words((pattern.size() + 7) / 8), mask_words((pattern.size() + 7) / 8), length(pattern.size()),
+          marker_offset(pattern.marker()) {
+        for (std::size_t i = 0; i < length; i++) {
+            const auto element = pattern[i];
+            const auto mask = element.is_mask ? std::byte{} : element.mask;
+            const auto shift = (i % 8) * 8;
+            value_words[i / 8] |= std::uint64_t(element.byte & mask) << shift;
+            mask_words[i / 8] |= std::uint64_t(mask) << shift;
+            if (anchor == no_anchor && mask == std::byte{0xFF}) {
+                anchor = i;
+                anchor_byte = element.byte;
             }
         }
     }
+
+public:
+    [[nodiscard]] std::size_t size() const noexcept {
+        return length;
+    }
+    [[nodiscard]] std::optional<std::size_t> marker() const noexcept {
+        return marker_offset;
+    }
+    /**
+     * @brief Whether the pattern matches at @b data, which has at least @ref size bytes.
+     */
+    [[nodiscard]] bool match(const std::byte* data) const noexcept {
+        const auto full_words = length / 8;
+        for (std::size_t w = 0; w < full_words; w++) {
+            std::uint64_t word;
+            std::memcpy(&word, data + w * 8, sizeof(word));
+            if ((word ^ value_words[w]) & mask_words[w])
+                return false;
+        }
+        if (const auto rest = length % 8) {
+            std::uint64_t word = 0;
+            std::memcpy(&word, data + full_words * 8, rest);
+            if ((word ^ value_words[full_words]) & mask_words[full_words])
+                return false;
+        }
+        return true;
+    }
+    /**
+     * @brief Find the first match starting in [@b from, @b limit) of @b data,
+     * with the whole match inside @b data.
+     *
+     * @return std::optional<std::size_t> The position of the match.
+     */
+    [[nodiscard]] std::optional<std::size_t> find(std::span<const std::byte> data, std::size_t from,
+                                                  std::size_t limit) const noexcept {
+        if (!length || data.size() < length)
+            return std::nullopt;
+        limit = (std::min)(limit, data.size() - length + 1);
+        if (anchor == no_anchor) {
+            for (auto i = from; i < limit; i++)
+                if (match(data.data() + i))
+                    return i;
+            return std::nullopt;
+        }
+        for (auto i = from; i < limit; i++) {
+            auto found = std::memchr(data.data() + i + anchor, std::to_integer<int>(anchor_byte), limit - i);
+            if (!found)
+                return std::nullopt;
+            i = static_cast<std::size_t>(static_cast<const std::byte*>(found) - data.data()) - anchor;
+            if (match(data.data() + i))
+                return i;
+        }
+        return std::nullopt;
+    }
 };
 
 MEMORY_READER_NAMESPACE_END
@@ -0,0 +1,192 @@
+/**
+ * @file PatternIndex.h
+ * @author UnnamedOrange
+ * @brief Answer many pattern lookups on unchanged regions from a q-gram index.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "../process/IReadMemory.h"
+#include "../utils/macro.h"
+#include "Pattern.h"
+#include "ScanScheduler.h"
+#include "SignatureStep.h"
+
+MEMORY_READER_NAMESPACE_BEGIN
+
+/**
+ * @brief Options of @ref PatternIndex::build.
+ */
+struct PatternIndexOptions {
+    /**
+     * @brief Regions to be indexed. Executable regions by default.
+     */
+    RegionFilter filter{.required = RegionProtection::READ | RegionProtection::EXECUTE};
+    /**
+     * @brief Only grams starting at multiples of this are indexed, dividing the size of the index by it.
+     * A pattern then needs a fixed run of @ref PatternIndex::gram_size + stride - 1 bytes to use the index.
+     */
+    std::size_t stride = 1;
+    /**
+     * @brief If not null, reads are paced by it. It MUST have a longer life span than the build.
+     */
+    ScanScheduler* scheduler = nullptr;
+};
+
+namespace __detail {
+    /**
+     * @brief A run of fully specified bytes in a pattern.
+     */
+    struct FixedRun {
+        std::size_t offset;
+        std::vector<std::byte> bytes;
+    };
+
+    template <typename pattern_t>
+    std::vector<FixedRun> fixed_runs(const pattern_t& pattern) {
+        std::vector<FixedRun> ret;
+        bool in_run = false;
+        for (std::size_t i = 0; i < pattern.size(); i++) {
+            const auto element = pattern[i];
+            if (element.is_mask || element.mask != std::byte{0xFF}) {
+                in_run = false;
+                continue;
+            }
+            if (!in_run) {
+                ret.push_back(FixedRun{.offset = i, .bytes = {}});
+                in_run = true;
+            }
+            ret.back().bytes.push_back(element.byte);
+        }
+        return ret;
+    }
+} // namespace __detail
+
+/**
+ * @brief Regions read once and indexed by q-grams, to answer many pattern lookups without reading again.
+ *
+ * The bytes of the regions are kept, together with the positions of every @ref gram_size-byte gram
+ * in hashed posting lists. A lookup takes the rarest gram among the fixed runs of the pattern,
+ * and verifies the pattern only where that gram occurs. Verification on the kept bytes is cheaper
+ * than intersecting more posting lists, so no other list is consulted.
+ * Patterns without a long enough fixed run are matched against the kept bytes linearly.
+ *
+ * The index does not notice changes of the process. Build it again if the regions may have changed,
+ * e.g. when the cache hint changes.
+ */
+class PatternIndex {
+    using Self = PatternIndex;
+
+public:
+    static constexpr std::size_t gram_size = 4;
+
+private:
+    /**
+     * @brief A contiguous readable range of a region, stored at @ref offset of @ref bytes.
+     */
+    struct Image {
+        std::uintptr_t address{};
+        std::size_t size{};
+        std::size_t offset{};
+    };
+
+    std::vector<Image> images;
+    std::vector<std::byte> bytes;
+    std::size_t stride = 1;
+    unsigned bucket_bits = 0;
+    /**
+     * @brief Posting lists in CSR form: positions in @ref bytes of the grams in bucket b are
+     * positions[bucket_starts[b], bucket_starts[b + 1]), in ascending order.
+     */
+    std::vector<std::uint32_t> bucket_starts;
+    std::vector<std::uint32_t> positions;
+
+public:
+    PatternIndex() noexcept = default;
+
+    /**
+     * @brief Read regions satisfying the filter and index them.
+     * Unreadable chunks are left out. At most 4 GiB are indexed.
+     */
+    [[nodiscard]] static Self build(const IReadMemory& reader, const PatternIndexOptions& options = {});
+
+private:
+    [[nodiscard]] std::size_t bucket_of(std::uint32_t gram) const noexcept {
+        return static_cast<std::size_t>((gram * 0x9E3779B1u) >> (32 - bucket_bits));
+    }
+    [[nodiscard]] std::span<const std::uint32_t> postings(std::uint32_t gram) const noexcept;
+    /**
+     * @brief Find matches of a compiled pattern, using @b runs to locate candidates.
+     */
+    [[nodiscard]] std::vector<std::uintptr_t> find_all_impl(const CompiledPattern& pattern,
+                                                            std::span<const __detail::FixedRun> runs,
+                                                            std::size_t max_count) const;
+
+public:
+    /**
+     * @brief Find addresses where @b pattern matches, in ascending order.
+     *
+     * @param max_count Stop after this many matches.
+     */
+    template <typename pattern_t>
+    [[nodiscard]] std::vector<std::uintptr_t> find_all(const pattern_t& pattern,
+                                                       std::size_t max_count = SIZE_MAX) const {
+        if (pattern.empty()) {
+            return {};
+        }
+        return find_all_impl(CompiledPattern(pattern), __detail::fixed_runs(pattern), max_count);
+    }
+    /**
+     * @brief Find the lowest address where @b pattern matches.
+     */
+    template <typename pattern_t>
+    [[nodiscard]] std::optional<std::uintptr_t> find(const pattern_t& pattern) const {
+        auto ret = find_all(pattern, 1);
+        if (ret.empty()) {
+            return std::nullopt;
+        }
+        return ret.front();
+    }
+    /**
+     * @brief Find @b pattern and apply @b steps, reading operands from the indexed bytes.
+     * Same as @ref Signature::resolve, as long as the steps only read indexed regions.
+     */
+    template <typename pattern_t>
+    [[nodiscard]] std::optional<std::uintptr_t> resolve(const pattern_t& pattern,
+                                                        std::span<const SignatureStep> steps) const {
+        auto match = find(pattern);
+        if (!match) {
+            return std::nullopt;
+        }
+        return __detail::apply_signature_steps(*this, *match, steps, pattern.marker());
+    }
+
+public:
+    /**
+     * @brief The number of bytes indexed.
+     */
+    [[nodiscard]] std::size_t size() const noexcept {
+        return bytes.size();
+    }
+    [[nodiscard]] bool empty() const noexcept {
+        return bytes.empty();
+    }
+    /**
+     * @brief Read indexed bytes as if they were read from the process.
+     *
+     * @return true All bytes have been indexed.
+     * @return false Otherwise.
+     */
+    bool read_to_buf(std::uintptr_t address, void* buf, std::size_t size) const noexcept;
+};
+
+MEMORY_READER_NAMESPACE_END
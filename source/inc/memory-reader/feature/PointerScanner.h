@@ -0,0 +1,179 @@
+/**
+ * @file PointerScanner.h
+ * @author UnnamedOrange
+ * @brief Find chains of pointers from static bases to an address.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../process/IReadMemory.h"
+#include "../utils/macro.h"
+#include "ScanScheduler.h"
+
+MEMORY_READER_NAMESPACE_BEGIN
+
+/**
+ * @brief Options of @ref PointerMap and @ref PointerScanner.
+ */
+struct PointerScanOptions {
+    PtrWidth width = PtrWidth::IS_CURRENT;
+    /**
+     * @brief Regions searched for pointers. Only values pointing into these regions are kept.
+     */
+    RegionFilter filter{.required = RegionProtection::READ | RegionProtection::WRITE};
+    /**
+     * @brief Pointers are only looked for at multiples of this. If 0, use the pointer width.
+     */
+    std::size_t alignment = 0;
+    /**
+     * @brief The number of threads building the map. If 0, use the number of hardware threads.
+     */
+    std::size_t threads = 0;
+    /**
+     * @brief See @ref RegionReaderOptions::read_ahead. Each thread reads ahead its own chunks.
+     */
+    std::size_t read_ahead = 1;
+    /**
+     * @brief If not null, building the map is paced by it, and its workers run at its priority.
+     * It MUST have a longer life span than the build.
+     */
+    ScanScheduler* scheduler = nullptr;
+    /**
+     * @brief The maximum number of pointers followed by a path.
+     */
+    std::size_t max_depth = 4;
+    /**
+     * @brief The maximum offset added to a pointer.
+     */
+    std::size_t max_offset = 0x1000;
+    /**
+     * @brief Stop after finding this many paths.
+     */
+    std::size_t max_results = 1000;
+};
+
+/**
+ * @brief A pointer at @b address holding @b value.
+ */
+struct PointerEntry {
+    std::uintptr_t value;
+    std::uintptr_t address;
+};
+
+/**
+ * @brief All pointers in the process, sorted by their values.
+ *
+ * Building the map is the expensive part of a pointer scan,
+ * so one map can be shared by scans for many addresses.
+ */
+class PointerMap {
+    using Self = PointerMap;
+
+private:
+    std::vector<PointerEntry> entries;
+
+public:
+    PointerMap() noexcept = default;
+
+public:
+    /**
+     * @brief Read all regions satisfying the filter on multiple threads and collect the pointers.
+     * Each thread sorts its own pointers, and the sorted runs are merged at last.
+     */
+    [[nodiscard]] static Self build(const IReadMemory& reader, const PointerScanOptions& options = {});
+
+public:
+    [[nodiscard]] std::size_t size() const noexcept {
+        return entries.size();
+    }
+    /**
+     * @brief Get the pointers whose values are in [@b min_value, @b max_value].
+     */
+    [[nodiscard]] std::span<const PointerEntry> find(std::uintptr_t min_value, std::uintptr_t max_value) const noexcept;
+};
+
+/**
+ * @brief A chain of pointers from a static base, in the form of @ref ValueOffsets.
+ *
+ * The first offset is relative to the base of the module,
+ * and each following offset is added to the pointer read before it.
+ */
+struct PointerPath {
+    /**
+     * @brief Path of the module whose image holds the first pointer.
+     */
+    std::string module;
+    std::uintptr_t module_base;
+    std::vector<std::intptr_t> offsets;
+
+    /**
+     * @brief Follow the chain and get the address it ends at.
+     */
+    [[nodiscard]] std::optional<std::uintptr_t> resolve(const IReadMemory& reader, PtrWidth width) const noexcept;
+    /**
+     * @brief Get the declaration of the path, e.g. "ValueOffsets<PtrWidth::IS_64, int, 0x68, 0x38, 0x94>".
+     */
+    [[nodiscard]] std::string declaration(PtrWidth width, std::string_view type_name) const;
+};
+
+/**
+ * @brief Find chains of pointers from static bases to an address.
+ *
+ * A static base is a pointer stored in the image of a module,
+ * including the anonymous region right after it where uninitialized data lives.
+ * A module is a file with at least one executable mapping, so data files mapped by the process are not modules.
+ * Chains are searched backwards from the address: each pointer whose value is at most
+ * @ref PointerScanOptions::max_offset below the current address is found in the @ref PointerMap,
+ * and the address of that pointer becomes the next address to search for.
+ * The search is breadth-first, so shorter paths are found first,
+ * and each address is searched for at most once to keep cycles and fan-out bounded.
+ */
+class PointerScanner {
+    using Self = PointerScanner;
+
+private:
+    struct Module {
+        std::uintptr_t begin;
+        std::uintptr_t end;
+        std::uintptr_t base;
+        std::string path;
+    };
+
+    PointerScanOptions options;
+    PointerMap map;
+    /**
+     * @brief Sorted by address.
+     */
+    std::vector<Module> modules;
+
+public:
+    /**
+     * @brief Build the pointer map and locate the modules.
+     */
+    PointerScanner(const IReadMemory& reader, const PointerScanOptions& options = {});
+
+private:
+    const Module* find_module(std::uintptr_t address) const noexcept;
+
+public:
+    /**
+     * @brief Find paths ending at @b target, shorter ones first.
+     */
+    [[nodiscard]] std::vector<PointerPath> scan(std::uintptr_t target) const;
+    [[nodiscard]] const PointerMap& pointer_map() const noexcept {
+        return map;
+    }
+};
+
+MEMORY_READER_NAMESPACE_END
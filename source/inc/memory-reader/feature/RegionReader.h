@@ -0,0 +1,218 @@
+/**
+ * @file RegionReader.h
+ * @author UnnamedOrange
+ * @brief Stream regions chunk by chunk with bounded memory.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "../process/IReadMemory.h"
+#include "../utils/macro.h"
+#include "ScanScheduler.h"
+
+MEMORY_READER_NAMESPACE_BEGIN
+
+/**
+ * @brief A chunk of a region, produced by @ref split_regions.
+ */
+struct RegionChunk {
+    std::uintptr_t address;
+    /**
+     * @brief The number of bytes owned by this chunk.
+     */
+    std::size_t size;
+    /**
+     * @brief The number of bytes read after the owned bytes, shared with the next chunk of the same region.
+     * Something starting in this chunk and ending in the next one can then be found in this chunk.
+     */
+    std::size_t overlap;
+};
+
+/**
+ * @brief Options of @ref split_regions and @ref RegionReader.
+ */
+struct RegionReaderOptions {
+    /**
+     * @brief The maximum number of bytes owned by a chunk.
+     */
+    std::size_t chunk_size = std::size_t{1} << 20;
+    /**
+     * @brief See @ref RegionChunk::overlap.
+     */
+    std::size_t overlap = 0;
+    /**
+     * @brief The number of chunks @ref RegionReader reads ahead on a helper thread. 0 to read on demand.
+     * If there is only one chunk, or the helper thread cannot be created, chunks are read on demand.
+     */
+    std::size_t read_ahead = 0;
+    /**
+     * @brief If not null, @ref RegionReader paces the reads by it. It MUST have a longer life span than the reader.
+     */
+    ScanScheduler* scheduler = nullptr;
+};
+
+/**
+ * @brief Split regions into chunks.
+ */
+[[nodiscard]] std::vector<RegionChunk> split_regions(std::span<const Region> regions,
+                                                     const RegionReaderOptions& options = {});
+
+/**
+ * @brief A chunk and its bytes, produced by @ref RegionReader::next.
+ */
+struct ChunkView {
+    RegionChunk chunk;
+    /**
+     * @brief The owned bytes followed by the overlapping bytes.
+     * Valid until the next call of @ref RegionReader::next.
+     */
+    std::span<const std::byte> data;
+};
+
+/**
+ * @brief Stream chunks one by one, reusing one buffer.
+ *
+ * With read-ahead, a helper thread reads the following chunks into spare buffers
+ * while the current one is being processed, so page faults of the process overlap with the computation.
+ * Chunks are still produced in order.
+ *
+ * If the helper thread fails, e.g. to allocate, the remaining chunks are read on demand.
+ *
+ * If a chunk cannot be read at once, it is read page by page, and each run of readable pages is produced
+ * as a chunk of its own. Pages which cannot be read are skipped and counted.
+ *
+ * With a @ref ScanScheduler, each call of @ref next is paced by its budget, accounting for the chunks visited
+ * since the last call and the time spent since then, and the helper thread runs at its priority.
+ */
+class RegionReader {
+    using Self = RegionReader;
+
+public:
+    /**
+     * @brief The granularity of the reads when a chunk cannot be read at once.
+     */
+    static constexpr std::size_t page_size = 0x1000;
+
+private:
+    /**
+     * @brief A readable part of a chunk, and where its bytes start in the buffer.
+     */
+    struct Run {
+        std::size_t offset;
+        RegionChunk chunk;
+    };
+    /**
+     * @brief A chunk read ahead.
+     */
+    struct Slot {
+        std::size_t index{};
+        std::size_t failed{};
+        std::vector<Run> runs{};
+        std::vector<std::byte> buf{};
+    };
+
+    const IReadMemory& reader;
+    std::vector<RegionChunk> chunks;
+    std::size_t next_index = 0;
+    std::size_t failed = 0;
+    std::vector<std::byte> buf;
+    /**
+     * @brief The readable parts of the chunk in @ref buf, and the next one to produce.
+     */
+    std::vector<Run> runs;
+    std::size_t run_index = 0;
+
+    ScanScheduler* scheduler;
+    /**
+     * @brief Where the chunks visited since the last pacing start, and when the pacing ended.
+     */
+    std::size_t paced_index = 0;
+    ScanScheduler::clock::time_point resumed{};
+
+    std::mutex m_slots;
+    std::condition_variable cv_slots;
+    /**
+     * @brief Chunks read by the helper thread, in order.
+     */
+    std::deque<Slot> ready;
+    /**
+     * @brief Buffers waiting to be filled by the helper thread.
+     */
+    std::vector<std::vector<std::byte>> spare;
+    bool should_exit = false;
+    /**
+     * @brief Whether the helper thread has exited, possibly before reading all the chunks.
+     */
+    bool read_ahead_stopped = false;
+    std::thread read_ahead_thread;
+
+public:
+    /**
+     * @note @b reader MUST have a longer life span than this object.
+     *
+     * @param options Only @ref RegionReaderOptions::read_ahead and @ref RegionReaderOptions::scheduler are used,
+     * as the chunks are already split.
+     */
+    RegionReader(const IReadMemory& reader, std::vector<RegionChunk> chunks,
+                 const RegionReaderOptions& options = {}) noexcept;
+    RegionReader(const Self&) = delete;
+    Self& operator=(const Self&) = delete;
+
+    ~RegionReader();
+
+private:
+    /**
+     * @brief Read @b chunk into @b buf, page by page if it cannot be read at once.
+     *
+     * @param runs The readable parts of the chunk.
+     * @return std::size_t The number of owned pages which cannot be read.
+     */
+    [[nodiscard]] std::size_t read_chunk(const RegionChunk& chunk, std::vector<std::byte>& buf,
+                                         std::vector<Run>& runs) const noexcept;
+    [[nodiscard]] std::optional<ChunkView> next_run() noexcept;
+    void read_ahead_routine();
+    /**
+     * @brief Give a buffer back to the helper thread. @ref m_slots MUST be locked.
+     */
+    void give_back(std::vector<std::byte>&& buf) noexcept;
+    /**
+     * @return std::optional<ChunkView> std::nullopt if all chunks have been visited,
+     * or if the helper thread has stopped and the following chunks are to be read on demand.
+     */
+    [[nodiscard]] std::optional<ChunkView> next_read_ahead() noexcept;
+    /**
+     * @brief Pace by the scheduler for the chunks visited since the last call.
+     */
+    void pace() noexcept;
+
+public:
+    /**
+     * @brief Read the next readable chunk, or the next readable part of a chunk.
+     *
+     * The previous view is invalidated.
+     *
+     * @return std::optional<ChunkView> The chunk, or std::nullopt if all chunks have been visited.
+     */
+    [[nodiscard]] std::optional<ChunkView> next() noexcept;
+    /**
+     * @brief The number of pages skipped since they could not be read. Pages are counted by the chunks owning them.
+     */
+    [[nodiscard]] std::size_t failed_pages() const noexcept {
+        return failed;
+    }
+};
+
+MEMORY_READER_NAMESPACE_END
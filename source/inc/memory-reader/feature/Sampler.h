@@ -0,0 +1,266 @@
+/**
+ * @file Sampler.h
+ * @author UnnamedOrange
+ * @brief Sample fixed fields at a high frequency into a lock-free ring buffer.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../process/IReadMemory.h"
+#include "../utils/RingBuffer.h"
+#include "../utils/macro.h"
+
+MEMORY_READER_NAMESPACE_BEGIN
+
+/**
+ * @brief A field to be sampled, copied into @ref Sample::value at @b offset.
+ */
+struct SampleField {
+    /**
+     * @brief Address in the to-be-read process.
+     */
+    std::uintptr_t address;
+    /**
+     * @brief Offset in the value type of the sampler.
+     */
+    std::size_t offset;
+    std::size_t size;
+};
+
+/**
+ * @brief A timestamped record produced by @ref Sampler.
+ */
+template <typename T>
+struct Sample {
+    /**
+     * @brief When the read was issued.
+     */
+    std::chrono::steady_clock::time_point time;
+    /**
+     * @brief Index of the tick. Gaps mean samples have been dropped or ticks have been missed.
+     */
+    std::uint64_t sequence;
+    /**
+     * @brief Whether all fields have been read. If not, @b value should be discarded.
+     */
+    bool ok;
+    T value;
+};
+
+/**
+ * @brief Statistics of @ref Sampler.
+ */
+struct SamplerStats {
+    /**
+     * @brief The number of samples pushed into the ring buffer.
+     */
+    std::uint64_t samples;
+    /**
+     * @brief The number of samples dropped because the ring buffer was full.
+     */
+    std::uint64_t overruns;
+    /**
+     * @brief The number of ticks skipped because the sampler fell behind by more than one period.
+     */
+    std::uint64_t missed_ticks;
+    /**
+     * @brief The maximum and the mean lateness of a sample compared with its scheduled time.
+     */
+    std::chrono::nanoseconds max_jitter;
+    std::chrono::nanoseconds mean_jitter;
+};
+
+/**
+ * @brief Options of @ref Sampler.
+ */
+struct SamplerOptions {
+    /**
+     * @brief The number of samples the ring buffer can hold. Rounded up to a power of 2.
+     */
+    std::size_t capacity = 8192;
+    /**
+     * @brief The sampler sleeps until this long before the scheduled time and then busy-waits.
+     * Set it to zero to never busy-wait, or to the period to never sleep.
+     */
+    std::chrono::nanoseconds spin_threshold = std::chrono::microseconds(200);
+};
+
+/**
+ * @brief Sample fixed fields at a high frequency into a lock-free ring buffer.
+ *
+ * A dedicated thread reads all fields with one batched read per tick,
+ * directly into a slot of the ring buffer, so sampling does not allocate.
+ * One consumer drains the samples at its own pace.
+ *
+ * @tparam T The type holding all fields of one sample.
+ */
+template <typename T>
+    requires std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>
+class Sampler final {
+    using Self = Sampler;
+
+public:
+    using clock = std::chrono::steady_clock;
+
+private:
+    const IReadMemory& reader;
+    std::vector<SampleField> fields;
+    std::vector<ReadRequest> requests;
+    clock::duration period;
+    SamplerOptions options;
+    SpscRingBuffer<Sample<T>> buffer;
+
+    std::atomic<std::uint64_t> samples{};
+    std::atomic<std::uint64_t> overruns{};
+    std::atomic<std::uint64_t> missed_ticks{};
+    std::atomic<std::int64_t> max_jitter_ns{};
+    std::atomic<std::int64_t> total_jitter_ns{};
+
+    std::atomic<bool> should_exit = false;
+    mutable std::mutex m_exit;
+    std::condition_variable cv_exit;
+
+    std::thread sampling_thread;
+
+public:
+    /**
+     * @note @b reader MUST have a longer life span than this object.
+     *
+     * @param fields Fields to be read. Each MUST lie inside @b T.
+     * @param period Interval between two samples. MUST be positive.
+     *
+     * @throw std::invalid_argument If a field lies outside @b T, or @b period is not positive.
+     */
+    Sampler(const IReadMemory& reader, std::vector<SampleField> fields, clock::duration period,
+            const SamplerOptions& options = {})
+        : reader(reader), fields(std::move(fields)), period(period), options(options), buffer(options.capacity) {
+        if (period <= clock::duration::zero()) {
+            throw std::invalid_argument("The period must be positive.");
+        }
+        for (const auto& field : this->fields) {
+            if (field.offset + field.size > sizeof(T)) {
+                throw std::invalid_argument("A field lies outside the sample type.");
+            }
+            requests.push_back(ReadRequest{.address = field.address, .buf = nullptr, .size = field.size});
+        }
+        sampling_thread = std::thread(&Self::sampling_thread_routine, this);
+    }
+    Sampler(const Self&) = delete;
+    Self& operator=(const Self&) = delete;
+    Sampler(Self&&) = delete;
+    Self& operator=(Self&&) = delete;
+
+    ~Sampler() {
+        if (std::lock_guard _(m_exit); true) {
+            should_exit = true;
+        }
+        cv_exit.notify_all();
+        sampling_thread.join();
+    }
+
+private:
+    void sampling_thread_routine() noexcept {
+        auto scheduled = clock::now();
+        std::uint64_t sequence = 0;
+        while (true) {
+            // Sleep for the most part, then busy-wait for precision.
+            if (std::unique_lock lock(m_exit); true) {
+                if (cv_exit.wait_until(lock, scheduled - options.spin_threshold, [&] { return should_exit.load(); }))
+                    return;
+            }
+            while (clock::now() < scheduled) {
+                if (should_exit.load(std::memory_order_relaxed))
+                    return;
+            }
+
+            sample_once(scheduled, sequence);
+
+            // Skip ticks already missed instead of sampling in a burst.
+            scheduled += period;
+            sequence++;
+            auto now = clock::now();
+            if (now - scheduled >= period) {
+                auto missed = static_cast<std::uint64_t>((now - scheduled) / period);
+                scheduled += missed * period;
+                sequence += missed;
+                missed_ticks.fetch_add(missed, std::memory_order_relaxed);
+            }
+        }
+    }
+    void sample_once(clock::time_point scheduled, std::uint64_t sequence) noexcept {
+        auto slot = buffer.try_reserve();
+        if (!slot) {
+            overruns.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        auto value_base = reinterpret_cast<std::byte*>(&slot->value);
+        for (std::size_t i = 0; i < fields.size(); i++) {
+            requests[i].buf = value_base + fields[i].offset;
+        }
+
+        auto time = clock::now();
+        slot->time = time;
+        slot->sequence = sequence;
+        slot->ok = reader.read_to_bufs(requests) == requests.size();
+        buffer.commit();
+
+        auto jitter = std::chrono::duration_cast<std::chrono::nanoseconds>(time - scheduled).count();
+        auto crt_max = max_jitter_ns.load(std::memory_order_relaxed);
+        while (jitter > crt_max && !max_jitter_ns.compare_exchange_weak(crt_max, jitter, std::memory_order_relaxed)) {
+        }
+        total_jitter_ns.fetch_add(jitter, std::memory_order_relaxed);
+        samples.fetch_add(1, std::memory_order_relaxed);
+    }
+
+public:
+    /**
+     * @brief Pop a sample. Return false if there is none.
+     *
+     * @note Only one thread may consume the samples.
+     */
+    bool try_pop(Sample<T>& out) noexcept {
+        return buffer.try_pop(out);
+    }
+    /**
+     * @brief Call @b func with each sample available now.
+     *
+     * @note Only one thread may consume the samples.
+     *
+     * @return std::size_t The number of samples consumed.
+     */
+    template <typename Func>
+    std::size_t drain(Func&& func) {
+        return buffer.drain(std::forward<Func>(func));
+    }
+    /**
+     * @note This method is reentrant.
+     */
+    SamplerStats stats() const noexcept {
+        auto crt_samples = samples.load(std::memory_order_relaxed);
+        auto total = total_jitter_ns.load(std::memory_order_relaxed);
+        return SamplerStats{
+            .samples = crt_samples,
+            .overruns = overruns.load(std::memory_order_relaxed),
+            .missed_ticks = missed_ticks.load(std::memory_order_relaxed),
+            .max_jitter = std::chrono::nanoseconds(max_jitter_ns.load(std::memory_order_relaxed)),
+            .mean_jitter = std::chrono::nanoseconds(crt_samples ? total / static_cast<std::int64_t>(crt_samples) : 0),
+        };
+    }
+};
+
+MEMORY_READER_NAMESPACE_END
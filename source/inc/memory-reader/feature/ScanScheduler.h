@@ -0,0 +1,150 @@
+/**
+ * @file ScanScheduler.h
+ * @author UnnamedOrange
+ * @brief Pace background scans by a budget of bandwidth and CPU time, and report their progress.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+
+#include "../utils/macro.h"
+
+MEMORY_READER_NAMESPACE_BEGIN
+
+/**
+ * @brief Scheduling priority of threads working for a scan. See @ref ScanScheduler::lower_current_thread.
+ */
+enum class WorkerPriority {
+    /**
+     * @brief Leave the priority as it is.
+     */
+    NORMAL,
+    /**
+     * @brief Raise the nice value to @ref ScanBudget::nice on Linux, or use a below-normal priority on Windows.
+     */
+    LOW,
+    /**
+     * @brief Run only when the CPU is otherwise idle, i.e. SCHED_IDLE on Linux,
+     * or the idle priority on Windows.
+     */
+    IDLE,
+};
+
+/**
+ * @brief Options of @ref ScanScheduler.
+ */
+struct ScanBudget {
+    /**
+     * @brief The maximum number of bytes read per second, summed over all threads. 0 for no limit.
+     */
+    std::size_t bytes_per_second = 0;
+    /**
+     * @brief The fraction of time each thread may spend between two chunks, in (0, 1].
+     * After a chunk taking t, the thread sleeps for t * (1 - duty_cycle) / duty_cycle.
+     * @ref ScanScheduler clamps it to [@ref ScanScheduler::min_duty_cycle, 1].
+     */
+    double duty_cycle = 1.0;
+    WorkerPriority priority = WorkerPriority::NORMAL;
+    /**
+     * @brief The nice value of @ref WorkerPriority::LOW.
+     */
+    int nice = 10;
+};
+
+/**
+ * @brief Pace scans by a budget of bandwidth and CPU time, and report their progress.
+ *
+ * Pass it to @ref RegionReader, directly or by options like @ref ValueScannerOptions::scheduler,
+ * @ref PointerScanOptions::scheduler, @ref PatternIndexOptions::scheduler or @ref RegionReaderOptions::scheduler
+ * for snapshots and signature scans.
+ * Between chunks, the reader calls @ref pace, which sleeps as the budget requires and yields otherwise,
+ * so that a process sharing the machine, e.g. a game, keeps its frames.
+ * Helper threads of the reader, and worker threads of parallel scans, run at @ref ScanBudget::priority as well.
+ *
+ * One scheduler may be shared by several readers on several threads, e.g. shares of a parallel scan.
+ * The bandwidth budget is then shared by them, and the progress is summed.
+ */
+class ScanScheduler {
+    using Self = ScanScheduler;
+
+public:
+    using clock = std::chrono::steady_clock;
+    /**
+     * @brief The smallest @ref ScanBudget::duty_cycle, so that a scan always makes progress.
+     */
+    static constexpr double min_duty_cycle = 0.01;
+
+private:
+    const ScanBudget budget;
+
+    mutable std::mutex m_state;
+    std::optional<clock::time_point> started;
+    /**
+     * @brief When the bytes consumed so far are paid off by the bandwidth budget.
+     */
+    clock::time_point paid_until{};
+    std::size_t total = 0;
+    std::size_t done = 0;
+
+public:
+    explicit ScanScheduler(const ScanBudget& budget = {}) noexcept;
+    ScanScheduler(const Self&) = delete;
+    Self& operator=(const Self&) = delete;
+    ScanScheduler(Self&&) = delete;
+    Self& operator=(Self&&) = delete;
+
+public:
+    /**
+     * @brief Add @b bytes to the work of the scan. The scan is regarded as started on the first call.
+     *
+     * @note This method is reentrant.
+     */
+    void add_work(std::size_t bytes) noexcept;
+    /**
+     * @brief Account for @b bytes of work done in @b busy, then sleep as the budget requires,
+     * or yield if it does not.
+     *
+     * @note This method is reentrant.
+     */
+    void pace(std::size_t bytes, clock::duration busy) noexcept;
+    /**
+     * @brief Apply @ref ScanBudget::priority to the calling thread. The priority is not restored,
+     * so only call it on threads dedicated to scans.
+     *
+     * @return true The priority is applied, or it is @ref WorkerPriority::NORMAL.
+     * @return false The platform refused.
+     */
+    bool lower_current_thread() const noexcept;
+
+public:
+    [[nodiscard]] const ScanBudget& get_budget() const noexcept {
+        return budget;
+    }
+    /**
+     * @brief The number of bytes added by @ref add_work.
+     */
+    [[nodiscard]] std::size_t total_bytes() const noexcept;
+    /**
+     * @brief The number of bytes accounted by @ref pace.
+     */
+    [[nodiscard]] std::size_t done_bytes() const noexcept;
+    /**
+     * @brief The fraction of the work done, in [0, 1]. 1 if there is no work.
+     */
+    [[nodiscard]] double progress() const noexcept;
+    /**
+     * @brief When the work is expected to be done, extrapolated from the rate so far.
+     *
+     * @return std::optional<clock::time_point> std::nullopt if nothing has been done yet.
+     */
+    [[nodiscard]] std::optional<clock::time_point> estimated_completion() const noexcept;
+};
+
+MEMORY_READER_NAMESPACE_END
@@ -0,0 +1,309 @@
+/**
+ * @file SharedExport.h
+ * @author UnnamedOrange
+ * @brief Publish watched values to shared memory, so that other processes read them without attaching.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../process/IReadMemoryWithCacheHint.h"
+#include "../utils/macro.h"
+#include "Watcher.h"
+
+MEMORY_READER_NAMESPACE_BEGIN
+
+namespace __detail {
+    inline constexpr std::uint64_t export_magic = 0x3158'5052'4D45'4D4F; // "OMEMRPX1"
+    inline constexpr std::uint32_t export_version = 1;
+    inline constexpr std::size_t export_name_size = 40;
+
+    /**
+     * @brief The first bytes of a segment. @ref magic is written last, so a segment with the magic is complete.
+     * Fields changing after creation are accessed by std::atomic_ref.
+     */
+    struct alignas(64) ExportSegmentHeader {
+        std::uint64_t magic;
+        std::uint32_t version;
+        std::uint32_t record_count;
+        std::uint64_t segment_size;
+        /**
+         * @brief The cache hint of the reader of the server.
+         */
+        std::uint64_t cache_hint;
+        /**
+         * @brief Non-zero once the server has stopped.
+         */
+        std::uint32_t closed;
+        /**
+         * @brief The number of polls of the server, increased after each poll.
+         */
+        std::uint64_t heartbeat_count;
+        /**
+         * @brief Time of the last poll, in nanoseconds since the epoch of std::chrono::system_clock.
+         */
+        std::int64_t heartbeat_time;
+    };
+    /**
+     * @brief A record, followed by its value in 8-byte words, padded to 64 bytes.
+     * The value and @ref valid are guarded by the sequence lock @ref sequence, which is odd while being written.
+     */
+    struct alignas(64) ExportRecordHeader {
+        /**
+         * @brief Null-terminated name of the field.
+         */
+        char name[export_name_size];
+        std::uint32_t size;
+        std::uint32_t sequence;
+        /**
+         * @brief Non-zero if the value has been read.
+         */
+        std::uint32_t valid;
+    };
+    static_assert(sizeof(ExportSegmentHeader) == 64 && sizeof(ExportRecordHeader) == 64);
+
+    [[nodiscard]] constexpr std::size_t export_record_stride(std::size_t size) noexcept {
+        return sizeof(ExportRecordHeader) + (size + 63) / 64 * 64;
+    }
+
+    /**
+     * @brief A named shared memory segment mapped into the current process.
+     * The creator removes the name on destruction. Mappings of others stay valid.
+     */
+    class SharedSegment {
+        using Self = SharedSegment;
+
+    private:
+        std::byte* segment_data = nullptr;
+        std::size_t segment_size = 0;
+        std::string name;
+        bool owner = false;
+
+    public:
+        SharedSegment() noexcept = default;
+        SharedSegment(const Self&) = delete;
+        Self& operator=(const Self&) = delete;
+        SharedSegment(Self&& other) noexcept;
+        Self& operator=(Self&& other) noexcept;
+        ~SharedSegment();
+
+        /**
+         * @brief Create a zeroed segment of @b size bytes, replacing any segment of the same name.
+         * Return an empty object on failure.
+         */
+        [[nodiscard]] static Self create(const std::string& name, std::size_t size) noexcept;
+        /**
+         * @brief Map an existing segment read-only. Return an empty object on failure.
+         */
+        [[nodiscard]] static Self open(const std::string& name) noexcept;
+
+    private:
+        void close() noexcept;
+
+    public:
+        [[nodiscard]] bool empty() const noexcept {
+            return !segment_data;
+        }
+        [[nodiscard]] std::byte* data() const noexcept {
+            return segment_data;
+        }
+        [[nodiscard]] std::size_t size() const noexcept {
+            return segment_size;
+        }
+    };
+} // namespace __detail
+
+/**
+ * @brief A value to be published by @ref ExportServer.
+ */
+struct ExportField {
+    /**
+     * @brief Name looked up by @ref ExportClient. At most 39 bytes.
+     */
+    std::string name{};
+    WatchTarget target{};
+    Watcher::clock::duration period = std::chrono::milliseconds(16);
+};
+
+/**
+ * @brief Watch values of a process and publish them to a named shared memory segment,
+ * so that any number of processes read them by @ref ExportClient, without attaching to the process.
+ *
+ * Each field is a record guarded by its own sequence lock, written whenever the @ref Watcher
+ * notices a change. Readers never block the server. After each poll, the cache hint of the reader
+ * is published, and a heartbeat tells clients that the server is still polling, see @ref ExportClient::alive.
+ *
+ * The reader is typically a @ref SingleProcessDaemon, so the segment outlives restarts of the process.
+ * Currently only Linux is supported, where the segment is POSIX shared memory in /dev/shm.
+ */
+class ExportServer final {
+    using Self = ExportServer;
+
+private:
+    const IReadMemoryWithCacheHint& reader;
+    __detail::SharedSegment segment;
+    std::vector<__detail::ExportRecordHeader*> records;
+    /**
+     * @brief Declared last, so that notifications stop before the segment is unmapped.
+     */
+    std::optional<Watcher> watcher;
+
+public:
+    /**
+     * @brief Create the segment @b name and start watching @b fields.
+     * Check @ref good for failures, e.g. a name too long.
+     *
+     * @note @b reader MUST have a longer life span than this object.
+     *
+     * @param name Name of the segment, e.g. "/my-overlay". A leading '/' is added if missing.
+     */
+    ExportServer(const IReadMemoryWithCacheHint& reader, std::string_view name, std::span<const ExportField> fields);
+    ExportServer(const Self&) = delete;
+    Self& operator=(const Self&) = delete;
+    ExportServer(Self&&) = delete;
+    Self& operator=(Self&&) = delete;
+
+    /**
+     * @brief Stop watching, mark the segment closed and remove its name.
+     */
+    ~ExportServer();
+
+private:
+    void publish(std::size_t index, std::span<const std::byte> value) noexcept;
+    void heartbeat() noexcept;
+
+public:
+    /**
+     * @brief Whether the segment has been created and the fields are being watched.
+     */
+    [[nodiscard]] bool good() const noexcept {
+        return watcher.has_value();
+    }
+};
+
+/**
+ * @brief Read values published by @ref ExportServer, with plain loads and no system calls.
+ *
+ * Reads retry while the server is writing the record, and never block the server.
+ */
+class ExportClient {
+    using Self = ExportClient;
+
+public:
+    using FieldId = std::size_t;
+
+private:
+    struct Field {
+        std::string_view name;
+        __detail::ExportRecordHeader* header;
+        std::uint64_t* words;
+    };
+
+    __detail::SharedSegment segment;
+    std::vector<Field> field_list;
+
+    /**
+     * @brief Give up a read after this many attempts, e.g. if the server died while writing.
+     */
+    static constexpr std::size_t max_attempts = 1024;
+
+public:
+    ExportClient() noexcept = default;
+
+    /**
+     * @brief Open the segment @b name created by @ref ExportServer.
+     *
+     * @return ExportClient If the segment does not exist or is not valid, return an empty object.
+     */
+    [[nodiscard]] static Self try_open(std::string_view name) noexcept;
+
+private:
+    [[nodiscard]] __detail::ExportSegmentHeader& header() const noexcept {
+        return *reinterpret_cast<__detail::ExportSegmentHeader*>(segment.data());
+    }
+
+public:
+    [[nodiscard]] bool empty() const noexcept {
+        return segment.empty();
+    }
+    /**
+     * @brief Whether the server has stopped. Values are no longer updated; open the segment again.
+     */
+    [[nodiscard]] bool closed() const noexcept;
+    /**
+     * @brief The cache hint of the reader of the server, which changes e.g. when the process restarts.
+     */
+    [[nodiscard]] std::uint64_t get_cache_hint() const noexcept;
+    /**
+     * @brief The number of polls of the server so far. It stops increasing if the server hangs or dies.
+     */
+    [[nodiscard]] std::uint64_t heartbeat_count() const noexcept;
+    /**
+     * @brief When the server polled last, or when it started if it has not polled yet.
+     */
+    [[nodiscard]] std::chrono::system_clock::time_point last_heartbeat() const noexcept;
+    /**
+     * @brief Whether the server has not stopped and has polled within @b max_age.
+     * Choose @b max_age well above the shortest period of the fields.
+     */
+    [[nodiscard]] bool alive(std::chrono::system_clock::duration max_age) const noexcept;
+
+    /**
+     * @brief Find a field by name. If several fields have the name, the first one is returned.
+     */
+    [[nodiscard]] std::optional<FieldId> find(std::string_view name) const noexcept;
+    /**
+     * @brief The number of fields. Ids are in [0, size()).
+     */
+    [[nodiscard]] std::size_t size() const noexcept {
+        return field_list.size();
+    }
+    [[nodiscard]] std::string_view name(FieldId id) const noexcept {
+        return field_list[id].name;
+    }
+    /**
+     * @brief The size of the value of a field in bytes.
+     */
+    [[nodiscard]] std::size_t value_size(FieldId id) const noexcept {
+        return field_list[id].header->size;
+    }
+
+    /**
+     * @brief Read the value of a field to a buffer.
+     *
+     * @return true The value has been read by the server, and @b size is the size of the value.
+     * @return false Otherwise.
+     */
+    [[nodiscard]] bool read_to_buf(FieldId id, void* buf, std::size_t size) const noexcept;
+    template <typename T>
+    [[nodiscard]] std::optional<T> read(FieldId id) const noexcept {
+        T ret;
+        if (!read_to_buf(id, &ret, sizeof(T))) {
+            return std::nullopt;
+        }
+        return ret;
+    }
+    template <typename T>
+    [[nodiscard]] std::optional<T> read(std::string_view name) const noexcept {
+        auto id = find(name);
+        if (!id) {
+            return std::nullopt;
+        }
+        return read<T>(*id);
+    }
+};
+
+MEMORY_READER_NAMESPACE_END
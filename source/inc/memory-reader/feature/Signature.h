@@ -9,87 +9,696 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <mutex>
 #include <optional>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
+#include "../process/FileImageReader.h"
 #include "../process/IReadMemoryWithCacheHint.h"
 #include "../utils/macro.h"
 #include "Pattern.h"
+#include "RegionReader.h"
+#include "SignatureStep.h"
 
 MEMORY_READER_NAMESPACE_BEGIN
 
-namespace __detail {
+/**
+ * @brief Lazy range of the addresses where a pattern matches, in ascending order within each region.
+ *
+ * Regions are streamed chunk by chunk by @ref RegionReader, and each increment
+ * only scans until the next match, so no more is read than needed.
+ * The range can only be iterated once.
+ *
+ * The pattern is compiled into a @ref CompiledPattern on construction.
+ * By default, the next chunk is read ahead while the current one is being matched.
+ */
+class SignatureMatches {
+    using Self = SignatureMatches;
+
+private:
+    CompiledPattern pattern;
+    RegionReader region_reader;
+    std::optional<ChunkView> view;
+    std::size_t position = 0;
+    std::size_t found = 0;
+    std::size_t max_count;
+    std::optional<std::uintptr_t> current;
+    bool started = false;
+
+    static std::vector<RegionChunk> make_chunks(std::span<const Region> regions, std::size_t pattern_size,
+                                                RegionReaderOptions options) {
+        if (!pattern_size) {
+            return {};
+        }
+        // A match across two chunks is found in the former one.
+        options.overlap = pattern_size - 1;
+        return split_regions(regions, options);
+    }
+    void advance() noexcept {
+        current = std::nullopt;
+        while (found < max_count) {
+            if (!view) {
+                view = region_reader.next();
+                position = 0;
+                if (!view) {
+                    return;
+                }
+            }
+            // Only matches starting in the owned bytes belong to this chunk.
+            if (auto match = pattern.find(view->data, position, view->chunk.size)) {
+                current = view->chunk.address + *match;
+                position = *match + 1;
+                found++;
+                return;
+            }
+            view.reset();
+        }
+    }
+
+public:
+    class iterator {
+    private:
+        Self* matches = nullptr;
+
+    public:
+        using value_type = std::uintptr_t;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() noexcept = default;
+        explicit iterator(Self* matches) noexcept : matches(matches) {}
+
+        std::uintptr_t operator*() const noexcept {
+            return *matches->current;
+        }
+        iterator& operator++() noexcept {
+            matches->advance();
+            return *this;
+        }
+        void operator++(int) noexcept {
+            ++*this;
+        }
+        bool operator==(std::default_sentinel_t) const noexcept {
+            return !matches->current;
+        }
+    };
+
+public:
     /**
-     * @note This method is reentrant, if @b pattern does not change during the procedure.
+     * @note @b reader MUST have a longer life span than this object.
+     *
+     * @param max_count Stop after this many matches.
+     * @param options How regions are read. @ref RegionReaderOptions::overlap is replaced by the pattern size - 1.
      */
     template <typename pattern_t>
-    std::optional<std::uintptr_t> scan_impl(const IReadMemoryWithCacheHint& reader, const pattern_t& pattern) noexcept {
-        auto regions = reader.regions();
+    SignatureMatches(const IReadMemory& reader, const pattern_t& pattern, std::size_t max_count = SIZE_MAX,
+                     const RegionReaderOptions& options = {.read_ahead = 1})
+        : pattern(pattern), region_reader(reader, make_chunks(reader.regions(), pattern.size(), options), options),
+          max_count(max_count) {}
+    /**
+     * @brief Only scan @b regions, in the given order.
+     */
+    template <typename pattern_t>
+    SignatureMatches(const IReadMemory& reader, const pattern_t& pattern, std::span<const Region> regions,
+                     std::size_t max_count = SIZE_MAX, const RegionReaderOptions& options = {.read_ahead = 1})
+        : pattern(pattern), region_reader(reader, make_chunks(regions, pattern.size(), options), options),
+          max_count(max_count) {}
+    SignatureMatches(const Self&) = delete;
+    Self& operator=(const Self&) = delete;
+
+public:
+    /**
+     * @brief Scan until the first match. Calling it again does not restart the scan.
+     */
+    iterator begin() noexcept {
+        if (!started) {
+            started = true;
+            advance();
+        }
+        return iterator(this);
+    }
+    std::default_sentinel_t end() const noexcept {
+        return {};
+    }
+};
+
+/**
+ * @brief Where a signature was found last time. A cold scan looks there first,
+ * so a signature is usually found without a full scan, e.g. after the process restarts.
+ */
+struct SignatureHistory {
+    /**
+     * @brief Path of the region where the pattern was found. Empty if the region is anonymous.
+     */
+    std::string module{};
+    /**
+     * @brief Offset of the match relative to the lowest scanned region of the module,
+     * or the absolute address if @ref module is empty.
+     */
+    std::uintptr_t offset{};
+
+    bool operator==(const SignatureHistory&) const = default;
+};
+
+namespace __detail {
+    /**
+     * @brief Half of the size of the neighborhood of the last hit, scanned before the whole module.
+     */
+    inline constexpr std::size_t signature_history_radius = 0x10000;
+
+    /**
+     * @brief Find the first match among @b regions, reading them from the process.
+     */
+    inline std::optional<std::uintptr_t> first_remote_match(const IReadMemory& reader,
+                                                            const CompiledPattern& pattern,
+                                                            std::span<const Region> regions,
+                                                            const RegionReaderOptions& options) {
+        SignatureMatches matches(reader, pattern, regions, 1, options);
+        if (auto it = matches.begin(); it != matches.end()) {
+            return *it;
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Find a match among @b regions, scanning the mapped files where there are any.
+     *
+     * Hits in the files are verified by reading them from the process. Bytes not covered by the files
+     * are read from the process. If nothing is found, the covered bytes are only read from the process
+     * if @ref FileImageReaderOptions::scan_process_on_miss is set.
+     */
+    inline std::optional<std::uintptr_t> first_image_match(const FileImageReader& reader,
+                                                           const CompiledPattern& pattern,
+                                                           std::span<const Region> regions,
+                                                           const RegionReaderOptions& options) {
+        std::vector<std::byte> bytes(pattern.size());
+        auto verify = [&](std::uintptr_t address) {
+            return reader.read_to_buf(address, bytes.data(), bytes.size()) && pattern.match(bytes.data());
+        };
+
+        std::vector<Region> uncovered;
+        std::vector<Region> covered;
         for (const auto& region : regions) {
-            auto region_data = reader.read_bytes(region.base, region.size);
-            if (region_data.empty())
+            const auto image = reader.find_image(region.base, region.size);
+            if (image.size() < pattern.size()) {
+                uncovered.push_back(region);
                 continue;
+            }
+            // Matches starting where the image ends are left to the process.
+            const auto limit = image.size() - pattern.size() + 1;
+            auto match = pattern.find(image, 0, limit);
+            while (match) {
+                if (verify(region.base + *match)) {
+                    return region.base + *match;
+                }
+                match = pattern.find(image, *match + 1, limit);
+            }
+            covered.push_back(Region{.base = region.base, .size = image.size(), .protection = region.protection});
+            if (limit < region.size) {
+                uncovered.push_back(
+                    Region{.base = region.base + limit, .size = region.size - limit, .protection = region.protection});
+            }
+        }
+        if (auto match = first_remote_match(reader, pattern, uncovered, options)) {
+            return match;
+        }
+        if (!reader.get_options().scan_process_on_miss) {
+            return std::nullopt;
+        }
+        return first_remote_match(reader, pattern, covered, options);
+    }
+
+    /**
+     * @brief Find the first match among @b regions.
+     * If @b Reader is a @ref FileImageReader, the match found may not be the first one,
+     * when an earlier one only exists in the process.
+     *
+     * @param options How regions are read from the process.
+     */
+    template <typename Reader>
+    std::optional<std::uintptr_t> first_match(const Reader& reader, const CompiledPattern& pattern,
+                                              std::span<const Region> regions, const RegionReaderOptions& options) {
+        if constexpr (std::is_base_of_v<FileImageReader, Reader>) {
+            return first_image_match(reader, pattern, regions, options);
+        } else {
+            return first_remote_match(reader, pattern, regions, options);
+        }
+    }
+
+    /**
+     * @brief Find the pattern in the module of @b history, from the exact address of the last hit,
+     * to its neighborhood, and to the whole module.
+     */
+    template <typename Reader>
+    std::optional<std::uintptr_t> scan_near_history(const Reader& reader, const CompiledPattern& pattern,
+                                                    std::span<const Region> module_regions,
+                                                    const SignatureHistory& history,
+                                                    const RegionReaderOptions& options) {
+        if (module_regions.empty()) {
+            return std::nullopt;
+        }
+        std::uintptr_t expected = history.offset;
+        if (!history.module.empty()) {
+            expected += module_regions.front().base;
+        }
+
+        // The last hit itself.
+        for (const auto& region : module_regions) {
+            if (expected >= region.base && expected - region.base <= region.size &&
+                region.size - (expected - region.base) >= pattern.size()) {
+                std::vector<std::byte> bytes(pattern.size());
+                if (reader.read_to_buf(expected, bytes.data(), bytes.size()) && pattern.match(bytes.data())) {
+                    return expected;
+                }
+                break;
+            }
+        }
 
-            for (std::size_t i = 0; i + pattern.size() - 1 < region_data.size(); i++) {
-                bool ok = true;
-                for (std::size_t j = 0; j < pattern.size(); j++)
-                    if (!(pattern[j].is_mask || region_data[i + j] == pattern[j].byte)) {
-                        ok = false;
-                        break;
-                    }
-                if (ok)
-                    return region.base + i;
+        // The neighborhood of the last hit.
+        const auto low = expected - (std::min)(expected, signature_history_radius);
+        const auto high = expected + (std::min)(SIZE_MAX - expected, signature_history_radius + pattern.size());
+        std::vector<Region> neighborhood;
+        for (const auto& region : module_regions) {
+            const auto begin = (std::max)(low, region.base);
+            const auto end = (std::min)(high, region.base + region.size);
+            if (begin < end) {
+                neighborhood.push_back(Region{.base = begin, .size = end - begin, .protection = region.protection});
             }
         }
+        if (auto match = first_match(reader, pattern, neighborhood, options)) {
+            return match;
+        }
+
+        // The whole module.
+        return first_match(reader, pattern, module_regions, options);
+    }
+
+    /**
+     * @brief Scan the pattern, looking at the module of @b history first, then update @b history on success.
+     *
+     * @note This method is reentrant, if @b pattern does not change during the procedure.
+     */
+    template <typename Reader, typename pattern_t>
+    std::optional<std::uintptr_t> scan_impl(const Reader& reader, const pattern_t& pattern,
+                                            std::optional<SignatureHistory>& history,
+                                            const RegionReaderOptions& options) noexcept {
+        try {
+            const CompiledPattern compiled(pattern);
+            auto regions = reader.regions();
+            std::ranges::sort(regions, {}, &Region::base);
+
+            std::optional<std::uintptr_t> match;
+            if (history) {
+                // Regions of the module go first, and the rest are scanned only if the module misses.
+                auto others = std::ranges::stable_partition(
+                    regions, [&](const Region& region) { return region.path == history->module; });
+                const auto module_size = static_cast<std::size_t>(others.begin() - regions.begin());
+                const auto all = std::span<const Region>(regions);
+                match = scan_near_history(reader, compiled, all.first(module_size), *history, options);
+                if (!match) {
+                    match = first_match(reader, compiled, all.subspan(module_size), options);
+                }
+            } else {
+                match = first_match(reader, compiled, regions, options);
+            }
+            if (!match) {
+                return std::nullopt;
+            }
+
+            // Record the module of the match.
+            auto it = std::ranges::find_if(regions, [&](const Region& region) {
+                return *match >= region.base && *match - region.base < region.size;
+            });
+            SignatureHistory new_history{.module = {}, .offset = *match};
+            if (it != regions.end() && !it->path.empty()) {
+                const auto& module = it->path;
+                auto lowest = std::ranges::min_element(regions, {}, [&](const Region& region) {
+                    return region.path == module ? region.base : UINTPTR_MAX;
+                });
+                new_history = {.module = module, .offset = *match - lowest->base};
+            }
+            history = std::move(new_history);
+            return match;
+        } catch (...) {
+        }
         return std::nullopt;
     }
 } // namespace __detail
 
+namespace __detail {
+    /**
+     * @brief The cached result of a signature, shared by @ref Signature and @ref DynamicSignature.
+     *
+     * Cache hits read the published result by a sequence lock, without taking any mutex.
+     * Concurrent misses are coalesced: one caller scans, and the others wait for its result.
+     *
+     * A cache hint of 0 means there is nothing to cache, so every call scans, and nothing is published.
+     *
+     * The match is cached apart from the resolved address. If the steps fail, e.g. a pointer is not set yet,
+     * the next call applies the steps to the cached match again instead of scanning again.
+     */
+    class SignatureCache {
+    public:
+        struct Result {
+            /**
+             * @brief The address of the first byte of the pattern.
+             */
+            std::optional<std::uintptr_t> match;
+            /**
+             * @brief The address after applying the steps.
+             */
+            std::optional<std::uintptr_t> resolved;
+        };
+
+    private:
+        // The published result. The sequence is odd while being written.
+        std::atomic<std::uint32_t> sequence{};
+        std::atomic<bool> match_valid{};
+        std::atomic<bool> resolved_valid{};
+        std::atomic<std::uint64_t> cache_hint{};
+        std::atomic<std::uintptr_t> match{};
+        std::atomic<std::uintptr_t> resolved{};
+
+        mutable std::mutex m_state;
+        std::condition_variable cv_scan;
+        bool scanning = false;
+        /**
+         * @brief The number of finished scans, so that waiters know one has finished.
+         */
+        std::uint64_t generation = 0;
+        std::uint64_t last_cache_hint = 0;
+        Result last_result;
+        std::optional<SignatureHistory> history;
+        RegionReaderOptions scan_options{.read_ahead = 1};
+
+        /**
+         * @brief Read the published result if it is for @b incoming_cache_hint and has a match.
+         * The resolved address may still be std::nullopt.
+         */
+        [[nodiscard]] std::optional<Result> load(std::uint64_t incoming_cache_hint) const noexcept {
+            const auto before = sequence.load(std::memory_order_acquire);
+            // A writer is publishing. Take the slow path.
+            if (before & 1) {
+                return std::nullopt;
+            }
+            const bool loaded_match_valid = match_valid.load(std::memory_order_relaxed);
+            const bool loaded_resolved_valid = resolved_valid.load(std::memory_order_relaxed);
+            const auto loaded_cache_hint = cache_hint.load(std::memory_order_relaxed);
+            const auto loaded_match = match.load(std::memory_order_relaxed);
+            const auto loaded_resolved = resolved.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) != before) {
+                return std::nullopt;
+            }
+            if (!loaded_match_valid || loaded_cache_hint != incoming_cache_hint) {
+                return std::nullopt;
+            }
+            return Result{.match = loaded_match,
+                          .resolved = loaded_resolved_valid ? std::optional(loaded_resolved) : std::nullopt};
+        }
+        /**
+         * @brief Publish @b result. A result without a match withdraws the published one.
+         *
+         * @note @ref m_state MUST be held.
+         */
+        void publish(std::uint64_t incoming_cache_hint, const Result& result) noexcept {
+            const auto before = sequence.load(std::memory_order_relaxed);
+            sequence.store(before + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            match_valid.store(result.match.has_value(), std::memory_order_relaxed);
+            resolved_valid.store(result.resolved.has_value(), std::memory_order_relaxed);
+            cache_hint.store(incoming_cache_hint, std::memory_order_relaxed);
+            match.store(result.match.value_or(0), std::memory_order_relaxed);
+            resolved.store(result.resolved.value_or(0), std::memory_order_relaxed);
+            sequence.store(before + 2, std::memory_order_release);
+        }
+
+        /**
+         * @brief Scan and resolve without touching the published result. Only the history is updated.
+         */
+        template <typename Reader, typename pattern_t>
+        Result scan_uncached(const Reader& reader, const pattern_t& pattern,
+                             std::span<const SignatureStep> steps) noexcept {
+            auto scan_history = get_history();
+            const auto options = get_scan_options();
+            Result result;
+            result.match = scan_impl(reader, pattern, scan_history, options);
+            if (result.match) {
+                result.resolved = apply_signature_steps(reader, *result.match, steps, pattern.marker());
+                std::lock_guard _lock(m_state);
+                history = std::move(scan_history);
+            }
+            return result;
+        }
+
+    public:
+        /**
+         * @brief Get the cached result without scanning or waiting.
+         * On misses, both addresses are std::nullopt. If only the steps failed, the match is kept.
+         *
+         * @note This method is reentrant and lock-free.
+         */
+        template <typename Reader>
+            requires std::derived_from<Reader, IReadMemoryWithCacheHint>
+        [[nodiscard]] Result try_get(const Reader& reader) const noexcept {
+            return load(reader.get_cache_hint()).value_or(Result{});
+        }
+        /**
+         * @brief Get the cached result, or scan and resolve again if the cache hint has changed.
+         * If only the steps failed last time, apply them to the cached match again without scanning.
+         * If another thread is scanning, wait for its result instead of scanning again.
+         *
+         * @note This method is reentrant.
+         *
+         * @param timeout How long to wait for a scan of another thread. If it times out, both addresses are
+         * std::nullopt. A scan of this thread is never interrupted. If std::nullopt, wait until it finishes.
+         */
+        template <typename Reader, typename pattern_t>
+            requires std::derived_from<Reader, IReadMemoryWithCacheHint>
+        Result get(const Reader& reader, const pattern_t& pattern, std::span<const SignatureStep> steps,
+                   std::optional<std::chrono::nanoseconds> timeout = std::nullopt) noexcept {
+            // reader.get_cache_hint() is reentrant.
+            // Assume reader.get_cache_hint() does not change during this method.
+            // Only drop the cache when the cache hint is changed.
+            // For other unexpected situations, just let failure happen in subsequent operations.
+            const auto incoming_cache_hint = reader.get_cache_hint();
+            if (!incoming_cache_hint) {
+                return scan_uncached(reader, pattern, steps);
+            }
+            if (auto result = load(incoming_cache_hint); result && result->resolved) {
+                return *result;
+            }
+
+            const auto deadline = std::chrono::steady_clock::now() + timeout.value_or(std::chrono::nanoseconds{});
+            std::unique_lock lock(m_state);
+            while (scanning) {
+                const auto waited_generation = generation;
+                auto finished = [&] { return generation != waited_generation; };
+                if (!timeout) {
+                    cv_scan.wait(lock, finished);
+                } else if (!cv_scan.wait_until(lock, deadline, finished)) {
+                    return {};
+                }
+                // A failed scan is shared as well, so that waiters do not scan one by one.
+                if (last_cache_hint == incoming_cache_hint) {
+                    return last_result;
+                }
+            }
+            const auto cached = load(incoming_cache_hint);
+            if (cached && cached->resolved) {
+                return *cached;
+            }
+
+            // Scan without holding the lock, so that cache hits and waiters are not blocked.
+            scanning = true;
+            auto scan_history = history;
+            const auto options = scan_options;
+            lock.unlock();
+            Result result;
+            // The pattern has not moved, so only the steps are applied again.
+            result.match = cached ? cached->match : scan_impl(reader, pattern, scan_history, options);
+            if (result.match) {
+                result.resolved = apply_signature_steps(reader, *result.match, steps, pattern.marker());
+            }
+            lock.lock();
+
+            if (scan_history) {
+                history = std::move(scan_history);
+            }
+            publish(incoming_cache_hint, result);
+            last_cache_hint = incoming_cache_hint;
+            last_result = result;
+            scanning = false;
+            generation++;
+            lock.unlock();
+            cv_scan.notify_all();
+            return result;
+        }
+
+        [[nodiscard]] std::optional<SignatureHistory> get_history() const {
+            std::lock_guard _lock(m_state);
+            return history;
+        }
+        void set_history(std::optional<SignatureHistory> new_history) {
+            std::lock_guard _lock(m_state);
+            history = std::move(new_history);
+        }
+        [[nodiscard]] RegionReaderOptions get_scan_options() const {
+            std::lock_guard _lock(m_state);
+            return scan_options;
+        }
+        void set_scan_options(const RegionReaderOptions& options) {
+            std::lock_guard _lock(m_state);
+            scan_options = options;
+        }
+    };
+} // namespace __detail
+
 /**
  * @brief Signature scanning and caching.
+ *
+ * Steps can be declared after the pattern to turn the address of the pattern into the address of data,
+ * e.g. @b Signature<"8B 0D @?? ?? ?? ??", rel32()> for a RIP-relative operand.
+ * The resolved address is cached apart from the address of the pattern,
+ * so if the steps fail, e.g. a pointer is not set yet, only they are applied again on the next call.
+ *
+ * On a cold scan, the module and the offset of the last hit (see @ref history) are tried first,
+ * then its neighborhood and its module, before all other regions.
+ *
+ * Readers are taken by their concrete types, so with a final reader like @ref SingleProcessDaemon,
+ * checking the cache hint on cache hits involves no virtual call.
+ *
+ * With a @ref FileImageReader, regions backed by a mapped file are scanned in the file locally,
+ * and each hit is verified by a single read of the process.
  */
-template <Pattern pattern>
+template <Pattern pattern, SignatureStep... steps>
 class Signature {
     using Self = Signature;
 
+    static constexpr std::array<SignatureStep, sizeof...(steps)> step_array{steps...};
+    static_assert(((steps.offset != SignatureStep::at_marker) && ...) || pattern.marker().has_value(),
+                  "Steps reading at the marker require a marker in the pattern.");
+
 private:
-    std::optional<int> cache_hint;
-    std::optional<std::uintptr_t> cache;
-    mutable std::mutex m_cache;
+    __detail::SignatureCache cache;
 
 public:
     /**
      * @brief Scan the pattern using provided reader.
      * According to the cache hint, the cache may be returned directly.
      *
-     * If there are multiple conforming patterns, any one of them will be returned.
+     * If there are multiple conforming patterns, the first one found will be returned.
+     * Use @ref scan_all to get all of them.
      *
      * @note This method is reentrant.
      *
      * @return std::optional<std::uintptr_t> The address of the first byte of the pattern.
      * If any error occurs, return std::nullopt.
      */
-    std::optional<std::uintptr_t> scan(const IReadMemoryWithCacheHint& reader) noexcept {
-        if (std::lock_guard _lock(m_cache); true) {
-            // reader.get_cache_hint() is reentrant.
-            // Assume reader.get_cache_hint() does not change during this method.
-            auto incoming_cache_hint = reader.get_cache_hint();
-            // Only drop the cache when the cache hint is changed.
-            // For other unexpected situations, just let failure happen in subsequent operations.
-            if (cache_hint && incoming_cache_hint == *cache_hint) {
-                return cache;
-            } else {
-                cache = __detail::scan_impl(reader, pattern);
-                // Clear the cache hint on failure.
-                if (cache) {
-                    cache_hint = incoming_cache_hint;
-                } else {
-                    cache_hint = std::nullopt;
-                }
-            }
-            return cache;
-        }
+    template <typename Reader>
+        requires std::derived_from<Reader, IReadMemoryWithCacheHint>
+    std::optional<std::uintptr_t> scan(const Reader& reader) noexcept {
+        return cache.get(reader, pattern, step_array).match;
+    }
+    /**
+     * @brief Scan the pattern and apply the steps. Same as @ref scan if there is no step.
+     * On cache hits, nothing is read.
+     *
+     * @note This method is reentrant.
+     *
+     * @return std::optional<std::uintptr_t> The resolved address. If any error occurs, return std::nullopt.
+     */
+    template <typename Reader>
+        requires std::derived_from<Reader, IReadMemoryWithCacheHint>
+    std::optional<std::uintptr_t> resolve(const Reader& reader) noexcept {
+        return cache.get(reader, pattern, step_array).resolved;
+    }
+    /**
+     * @brief Same as @ref scan, but wait for a scan of another thread for at most @b timeout.
+     * If it times out, return std::nullopt. A scan started by this call is never interrupted.
+     *
+     * @note This method is reentrant.
+     */
+    template <typename Reader>
+        requires std::derived_from<Reader, IReadMemoryWithCacheHint>
+    std::optional<std::uintptr_t> scan(const Reader& reader, std::chrono::nanoseconds timeout) noexcept {
+        return cache.get(reader, pattern, step_array, timeout).match;
+    }
+    /**
+     * @brief Same as @ref resolve, but wait for a scan of another thread for at most @b timeout.
+     * If it times out, return std::nullopt. A scan started by this call is never interrupted.
+     *
+     * @note This method is reentrant.
+     */
+    template <typename Reader>
+        requires std::derived_from<Reader, IReadMemoryWithCacheHint>
+    std::optional<std::uintptr_t> resolve(const Reader& reader, std::chrono::nanoseconds timeout) noexcept {
+        return cache.get(reader, pattern, step_array, timeout).resolved;
+    }
+    /**
+     * @brief Return the cached address of the pattern without scanning or waiting.
+     * On cache misses, return std::nullopt.
+     *
+     * @note This method is reentrant and lock-free.
+     */
+    template <typename Reader>
+        requires std::derived_from<Reader, IReadMemoryWithCacheHint>
+    [[nodiscard]] std::optional<std::uintptr_t> try_scan(const Reader& reader) const noexcept {
+        return cache.try_get(reader).match;
+    }
+    /**
+     * @brief Return the cached resolved address without scanning or waiting.
+     * On cache misses, return std::nullopt.
+     *
+     * @note This method is reentrant and lock-free.
+     */
+    template <typename Reader>
+        requires std::derived_from<Reader, IReadMemoryWithCacheHint>
+    [[nodiscard]] std::optional<std::uintptr_t> try_resolve(const Reader& reader) const noexcept {
+        return cache.try_get(reader).resolved;
+    }
+    /**
+     * @brief Where the pattern was found last time, e.g. to be saved and restored by @ref set_history
+     * across runs. Cold scans look there first.
+     */
+    [[nodiscard]] std::optional<SignatureHistory> history() const {
+        return cache.get_history();
+    }
+    /**
+     * @brief Restore the history returned by @ref history. It takes effect on the next cold scan.
+     */
+    void set_history(std::optional<SignatureHistory> history) {
+        cache.set_history(std::move(history));
+    }
+    /**
+     * @brief How cold scans read regions from the process, e.g. to pace them by a @ref ScanScheduler.
+     * @ref RegionReaderOptions::overlap is replaced by the pattern size - 1. It takes effect on the next cold scan.
+     */
+    void set_scan_options(const RegionReaderOptions& options) {
+        cache.set_scan_options(options);
+    }
+    /**
+     * @brief Get all addresses where the pattern matches, lazily. The cache is neither used nor updated.
+     * Use it to detect whether the pattern is ambiguous, e.g. by requesting at most 2 matches.
+     *
+     * @param max_count Stop after this many matches.
+     * @param options See @ref SignatureMatches::SignatureMatches.
+     */
+    [[nodiscard]] SignatureMatches scan_all(const IReadMemory& reader, std::size_t max_count = SIZE_MAX,
+                                            const RegionReaderOptions& options = {.read_ahead = 1}) const {
+        return SignatureMatches(reader, pattern, max_count, options);
     }
 };
 
@@ -98,9 +707,8 @@ class DynamicSignature {
 
 private:
     DynamicPattern pattern;
-    std::optional<int> cache_hint;
-    std::optional<std::uintptr_t> cache;
-    mutable std::mutex m_cache;
+    std::vector<SignatureStep> steps;
+    __detail::SignatureCache cache;
 
 public:
     DynamicSignature() noexcept = default;
@@ -110,13 +718,19 @@ public:
     Self& operator=(Self&&) = delete;
 
     DynamicSignature(const DynamicPattern& pattern) noexcept : pattern(pattern) {}
+    /**
+     * @param steps Steps applied by @ref resolve. See @ref Signature.
+     */
+    DynamicSignature(const DynamicPattern& pattern, std::vector<SignatureStep> steps) noexcept
+        : pattern(pattern), steps(std::move(steps)) {}
 
 public:
     /**
      * @brief Scan the pattern using provided reader.
      * According to the cache hint, the cache may be returned directly.
      *
-     * If there are multiple conforming patterns, any one of them will be returned.
+     * If there are multiple conforming patterns, the first one found will be returned.
+     * Use @ref scan_all to get all of them.
      *
      * If the pattern is empty, return std::nullopt.
      *
@@ -125,29 +739,114 @@ public:
      * @return std::optional<std::uintptr_t> The address of the first byte of the pattern.
      * If any error occurs, return std::nullopt.
      */
-    std::optional<std::uintptr_t> scan(const IReadMemoryWithCacheHint& reader) noexcept {
+    template <typename Reader>
+        requires std::derived_from<Reader, IReadMemoryWithCacheHint>
+    std::optional<std::uintptr_t> scan(const Reader& reader) noexcept {
         if (pattern.empty()) {
             return std::nullopt;
         }
-        if (std::lock_guard _lock(m_cache); true) {
-            // reader.get_cache_hint() is reentrant.
-            // Assume reader.get_cache_hint() does not change during this method.
-            auto incoming_cache_hint = reader.get_cache_hint();
-            // Only drop the cache when the cache hint is changed.
-            // For other unexpected situations, just let failure happen in subsequent operations.
-            if (cache_hint && incoming_cache_hint == *cache_hint) {
-                return cache;
-            } else {
-                cache = __detail::scan_impl(reader, pattern);
-                // Clear the cache hint on failure.
-                if (cache) {
-                    cache_hint = incoming_cache_hint;
-                } else {
-                    cache_hint = std::nullopt;
-                }
-            }
-            return cache;
+        return cache.get(reader, pattern, steps).match;
+    }
+    /**
+     * @brief Scan the pattern and apply the steps. Same as @ref scan if there is no step.
+     * On cache hits, nothing is read.
+     *
+     * If the pattern is empty, or a step needs a marker which the pattern does not have, return std::nullopt.
+     *
+     * @note This method is reentrant.
+     *
+     * @return std::optional<std::uintptr_t> The resolved address. If any error occurs, return std::nullopt.
+     */
+    template <typename Reader>
+        requires std::derived_from<Reader, IReadMemoryWithCacheHint>
+    std::optional<std::uintptr_t> resolve(const Reader& reader) noexcept {
+        if (pattern.empty()) {
+            return std::nullopt;
         }
+        return cache.get(reader, pattern, steps).resolved;
+    }
+    /**
+     * @brief Same as @ref scan, but wait for a scan of another thread for at most @b timeout.
+     * If it times out, return std::nullopt. A scan started by this call is never interrupted.
+     *
+     * @note This method is reentrant.
+     */
+    template <typename Reader>
+        requires std::derived_from<Reader, IReadMemoryWithCacheHint>
+    std::optional<std::uintptr_t> scan(const Reader& reader, std::chrono::nanoseconds timeout) noexcept {
+        if (pattern.empty()) {
+            return std::nullopt;
+        }
+        return cache.get(reader, pattern, steps, timeout).match;
+    }
+    /**
+     * @brief Same as @ref resolve, but wait for a scan of another thread for at most @b timeout.
+     * If it times out, return std::nullopt. A scan started by this call is never interrupted.
+     *
+     * @note This method is reentrant.
+     */
+    template <typename Reader>
+        requires std::derived_from<Reader, IReadMemoryWithCacheHint>
+    std::optional<std::uintptr_t> resolve(const Reader& reader, std::chrono::nanoseconds timeout) noexcept {
+        if (pattern.empty()) {
+            return std::nullopt;
+        }
+        return cache.get(reader, pattern, steps, timeout).resolved;
+    }
+    /**
+     * @brief Return the cached address of the pattern without scanning or waiting.
+     * On cache misses, return std::nullopt.
+     *
+     * @note This method is reentrant and lock-free.
+     */
+    template <typename Reader>
+        requires std::derived_from<Reader, IReadMemoryWithCacheHint>
+    [[nodiscard]] std::optional<std::uintptr_t> try_scan(const Reader& reader) const noexcept {
+        return cache.try_get(reader).match;
+    }
+    /**
+     * @brief Return the cached resolved address without scanning or waiting.
+     * On cache misses, return std::nullopt.
+     *
+     * @note This method is reentrant and lock-free.
+     */
+    template <typename Reader>
+        requires std::derived_from<Reader, IReadMemoryWithCacheHint>
+    [[nodiscard]] std::optional<std::uintptr_t> try_resolve(const Reader& reader) const noexcept {
+        return cache.try_get(reader).resolved;
+    }
+    /**
+     * @brief Where the pattern was found last time, e.g. to be saved and restored by @ref set_history
+     * across runs. Cold scans look there first.
+     */
+    [[nodiscard]] std::optional<SignatureHistory> history() const {
+        return cache.get_history();
+    }
+    /**
+     * @brief Restore the history returned by @ref history. It takes effect on the next cold scan.
+     */
+    void set_history(std::optional<SignatureHistory> history) {
+        cache.set_history(std::move(history));
+    }
+    /**
+     * @brief How cold scans read regions from the process, e.g. to pace them by a @ref ScanScheduler.
+     * @ref RegionReaderOptions::overlap is replaced by the pattern size - 1. It takes effect on the next cold scan.
+     */
+    void set_scan_options(const RegionReaderOptions& options) {
+        cache.set_scan_options(options);
+    }
+    /**
+     * @brief Get all addresses where the pattern matches, lazily. The cache is neither used nor updated.
+     * Use it to detect whether the pattern is ambiguous, e.g. by requesting at most 2 matches.
+     *
+     * If the pattern is empty, the range is empty.
+     *
+     * @param max_count Stop after this many matches.
+     * @param options See @ref SignatureMatches::SignatureMatches.
+     */
+    [[nodiscard]] SignatureMatches scan_all(const IReadMemory& reader, std::size_t max_count = SIZE_MAX,
+                                            const RegionReaderOptions& options = {.read_ahead = 1}) const {
+        return SignatureMatches(reader, pattern, max_count, options);
     }
 };
 
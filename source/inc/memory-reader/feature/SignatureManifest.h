@@ -0,0 +1,112 @@
+/**
+ * @file SignatureManifest.h
+ * @author UnnamedOrange
+ * @brief Load named signatures from a manifest file.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../utils/macro.h"
+#include "Signature.h"
+
+MEMORY_READER_NAMESPACE_BEGIN
+
+/**
+ * @brief Why a manifest is invalid.
+ */
+struct ManifestError {
+    /**
+     * @brief 1-based line number.
+     */
+    std::size_t line{};
+    /**
+     * @brief 1-based column number.
+     */
+    std::size_t column{};
+    const char* message{};
+};
+
+/**
+ * @brief Named @ref DynamicSignature objects loaded from a manifest.
+ *
+ * Each line of a manifest declares a signature, with optional steps after "=>":
+ * @code
+ * # Comments start with '#'.
+ * audio_time = 7D 15 A1 @?? ?? ?? ?? 85 C0 => abs32
+ * ruleset    = 8B 0D @?? ?? ?? ??          => rel32 add(0x10)
+ * @endcode
+ *
+ * Steps are separated by whitespaces, and arguments are integers in decimal or hexadecimal:
+ * - "rel32", "rel32(offset)", "rel32(offset, trailing)": See @ref rel32.
+ * - "abs32", "abs32(offset)": See @ref abs32.
+ * - "abs64", "abs64(offset)": See @ref abs64.
+ * - "add(displacement)": See @ref add.
+ * - "to_marker": See @ref to_marker.
+ *
+ * Without an offset, a step reads at the marker, which the pattern must have.
+ */
+class SignatureManifest {
+    using Self = SignatureManifest;
+
+private:
+    std::map<std::string, DynamicSignature, std::less<>> signatures;
+
+public:
+    SignatureManifest() noexcept = default;
+
+public:
+    /**
+     * @brief Parse a manifest in one pass.
+     *
+     * @param error If not null, set to the reason on failure.
+     * @return std::optional<SignatureManifest> The manifest, or std::nullopt if @b text is invalid.
+     */
+    [[nodiscard]] static std::optional<Self> try_parse(std::string_view text, ManifestError* error = nullptr) noexcept;
+    /**
+     * @brief Load and parse a manifest file.
+     *
+     * @param error If not null, set to the reason on failure. Its line is 0 if the file cannot be read.
+     * @return std::optional<SignatureManifest> The manifest, or std::nullopt on failure.
+     */
+    [[nodiscard]] static std::optional<Self> try_load(const std::filesystem::path& path,
+                                                      ManifestError* error = nullptr) noexcept;
+
+public:
+    /**
+     * @brief Find a signature by its name.
+     *
+     * @return DynamicSignature* The signature, or nullptr if there is no such name.
+     */
+    [[nodiscard]] DynamicSignature* find(std::string_view name) noexcept {
+        auto it = signatures.find(name);
+        return it == signatures.end() ? nullptr : &it->second;
+    }
+    [[nodiscard]] std::size_t size() const noexcept {
+        return signatures.size();
+    }
+    /**
+     * @brief Names of all signatures, in lexicographical order.
+     */
+    [[nodiscard]] std::vector<std::string_view> names() const {
+        std::vector<std::string_view> ret;
+        ret.reserve(signatures.size());
+        for (const auto& [name, signature] : signatures) {
+            ret.push_back(name);
+        }
+        return ret;
+    }
+};
+
+MEMORY_READER_NAMESPACE_END
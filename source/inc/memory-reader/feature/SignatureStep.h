@@ -0,0 +1,146 @@
+/**
+ * @file SignatureStep.h
+ * @author UnnamedOrange
+ * @brief Steps turning the address of a signature into the address of data.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+
+#include "../process/IReadMemory.h"
+#include "../process/MemoryReader.h"
+#include "../utils/macro.h"
+
+MEMORY_READER_NAMESPACE_BEGIN
+
+/**
+ * @brief Kind of @ref SignatureStep.
+ */
+enum class SignatureStepKind : std::uint8_t {
+    /**
+     * @brief Read a signed 32-bit displacement at the offset,
+     * and add it to the address of the end of the instruction.
+     */
+    REL32,
+    /**
+     * @brief Read an unsigned 32-bit address at the offset.
+     */
+    ABS32,
+    /**
+     * @brief Read a 64-bit address at the offset.
+     */
+    ABS64,
+    /**
+     * @brief Add the offset to the address.
+     */
+    ADD,
+};
+
+/**
+ * @brief A step applied to an address after a signature is found.
+ *
+ * Use @ref rel32, @ref abs32, @ref abs64, @ref add and @ref to_marker to make one.
+ * It can be used as a template parameter of @ref Signature.
+ */
+struct SignatureStep {
+    SignatureStepKind kind;
+    /**
+     * @brief Offset of the operand relative to the current address, or the displacement of @ref
+     * SignatureStepKind::ADD. If it is @ref at_marker, use the offset marked by "@" in the pattern.
+     */
+    std::intptr_t offset;
+    /**
+     * @brief For @ref SignatureStepKind::REL32, the number of bytes between the operand and the end of the
+     * instruction, e.g. the size of an immediate following the operand.
+     */
+    std::intptr_t trailing = 0;
+
+    /**
+     * @brief See @ref offset.
+     */
+    static constexpr std::intptr_t at_marker = (std::numeric_limits<std::intptr_t>::min)();
+};
+
+[[nodiscard]] constexpr SignatureStep rel32(std::intptr_t offset = SignatureStep::at_marker,
+                                            std::intptr_t trailing = 0) noexcept {
+    return {.kind = SignatureStepKind::REL32, .offset = offset, .trailing = trailing};
+}
+[[nodiscard]] constexpr SignatureStep abs32(std::intptr_t offset = SignatureStep::at_marker) noexcept {
+    return {.kind = SignatureStepKind::ABS32, .offset = offset, .trailing = 0};
+}
+[[nodiscard]] constexpr SignatureStep abs64(std::intptr_t offset = SignatureStep::at_marker) noexcept {
+    return {.kind = SignatureStepKind::ABS64, .offset = offset, .trailing = 0};
+}
+[[nodiscard]] constexpr SignatureStep add(std::intptr_t displacement) noexcept {
+    return {.kind = SignatureStepKind::ADD, .offset = displacement, .trailing = 0};
+}
+/**
+ * @brief Move the address to the offset marked by "@" in the pattern, e.g. to an operand followed by other steps.
+ */
+[[nodiscard]] constexpr SignatureStep to_marker() noexcept {
+    return add(SignatureStep::at_marker);
+}
+
+namespace __detail {
+    /**
+     * @brief Apply @b steps to @b address one by one.
+     *
+     * @param marker The offset marked in the pattern, used by steps with @ref SignatureStep::at_marker.
+     * @return std::optional<std::uintptr_t> If any read fails, or a step needs a marker which does not exist,
+     * return std::nullopt.
+     */
+    template <MemoryReader Reader>
+    inline std::optional<std::uintptr_t> apply_signature_steps(const Reader& reader, std::uintptr_t address,
+                                                               std::span<const SignatureStep> steps,
+                                                               std::optional<std::size_t> marker) noexcept {
+        for (const auto& step : steps) {
+            auto offset = step.offset;
+            if (offset == SignatureStep::at_marker) {
+                if (!marker) {
+                    return std::nullopt;
+                }
+                offset = static_cast<std::intptr_t>(*marker);
+            }
+            const auto operand = address + static_cast<std::uintptr_t>(offset);
+            switch (step.kind) {
+            case SignatureStepKind::REL32: {
+                auto displacement = read_value<std::int32_t>(reader, operand);
+                if (!displacement) {
+                    return std::nullopt;
+                }
+                address = operand + sizeof(std::int32_t) + static_cast<std::uintptr_t>(step.trailing) +
+                          static_cast<std::uintptr_t>(static_cast<std::intptr_t>(*displacement));
+                break;
+            }
+            case SignatureStepKind::ABS32: {
+                auto value = read_value<std::uint32_t>(reader, operand);
+                if (!value) {
+                    return std::nullopt;
+                }
+                address = *value;
+                break;
+            }
+            case SignatureStepKind::ABS64: {
+                auto value = read_value<std::uint64_t>(reader, operand);
+                if (!value) {
+                    return std::nullopt;
+                }
+                address = static_cast<std::uintptr_t>(*value);
+                break;
+            }
+            case SignatureStepKind::ADD: address = operand; break;
+            }
+        }
+        return address;
+    }
+} // namespace __detail
+
+MEMORY_READER_NAMESPACE_END
@@ -0,0 +1,150 @@
+/**
+ * @file Snapshot.h
+ * @author UnnamedOrange
+ * @brief Capture memory regions with page deduplication, and diff two captures.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "../process/IReadMemory.h"
+#include "../utils/macro.h"
+#include "ChangedRange.h"
+#include "RegionReader.h"
+
+MEMORY_READER_NAMESPACE_BEGIN
+
+/**
+ * @brief A region captured in a @ref Snapshot.
+ */
+struct SnapshotRegion {
+    Region region;
+    /**
+     * @brief Index of each page in the page pool, or @ref Snapshot::no_page if it could not be read.
+     */
+    std::vector<std::uint32_t> pages;
+};
+
+/**
+ * @brief Memory regions captured at some moment.
+ *
+ * Identical pages are stored once, so mostly zeroed heaps and duplicated images take little space.
+ * A snapshot can be saved to and loaded from a file.
+ */
+class Snapshot {
+    using Self = Snapshot;
+
+public:
+    static constexpr std::size_t page_size = 0x1000;
+    static constexpr std::uint32_t no_page = (std::numeric_limits<std::uint32_t>::max)();
+
+private:
+    std::vector<SnapshotRegion> region_entries;
+    std::vector<std::byte> page_pool;
+    std::vector<std::uint64_t> page_hashes;
+
+    /**
+     * @brief Pages in the pool with each hash, used to deduplicate pages while capturing.
+     */
+    using PageIndex = std::unordered_map<std::uint64_t, std::vector<std::uint32_t>>;
+
+public:
+    Snapshot() noexcept = default;
+
+private:
+    /**
+     * @brief Add a page to the pool unless an identical page is there.
+     *
+     * @return std::uint32_t Index of the page in the pool.
+     */
+    std::uint32_t intern_page(std::span<const std::byte, page_size> data, std::uint64_t hash, PageIndex& index);
+
+public:
+    /**
+     * @brief Capture all regions satisfying @b filter.
+     * Pages which cannot be read are recorded as @ref no_page.
+     *
+     * @param options How regions are read. @ref RegionReaderOptions::chunk_size is rounded down to whole pages,
+     * and @ref RegionReaderOptions::overlap is ignored.
+     *
+     * @note Regions are assumed page-aligned, which is the case on all supported platforms.
+     */
+    [[nodiscard]] static Self capture(const IReadMemory& reader, const RegionFilter& filter = {},
+                                      const RegionReaderOptions& options = {.read_ahead = 1});
+    /**
+     * @brief Capture the regions of @b previous again, reading only pages overlapping @b dirty.
+     * Other pages are taken from @b previous.
+     *
+     * Use it with @ref DirtyPageTracker, whose ranges tell which pages have been written.
+     * Regions mapped or unmapped since @b previous are not noticed, so capture fully from time to time.
+     *
+     * @param dirty Sorted ranges which may have changed since @b previous.
+     */
+    [[nodiscard]] static Self capture_incremental(const IReadMemory& reader, const Snapshot& previous,
+                                                  std::span<const ChangedRange> dirty);
+    /**
+     * @brief Load a snapshot saved by @ref save.
+     *
+     * @return std::optional<Snapshot> If the file is not a valid snapshot, return std::nullopt.
+     */
+    [[nodiscard]] static std::optional<Self> load(const std::filesystem::path& path) noexcept;
+    /**
+     * @brief Save the snapshot to a file.
+     *
+     * @return true Succeeded.
+     * @return false Failed. The file may be incomplete.
+     */
+    bool save(const std::filesystem::path& path) const noexcept;
+
+public:
+    [[nodiscard]] const std::vector<SnapshotRegion>& regions() const noexcept {
+        return region_entries;
+    }
+    /**
+     * @brief The number of distinct pages stored.
+     */
+    [[nodiscard]] std::size_t unique_pages() const noexcept {
+        return page_hashes.size();
+    }
+    /**
+     * @brief Get a page by its index in the page pool.
+     */
+    [[nodiscard]] std::span<const std::byte, page_size> page(std::uint32_t index) const noexcept {
+        return std::span<const std::byte, page_size>(page_pool.data() + std::size_t{index} * page_size, page_size);
+    }
+    [[nodiscard]] std::uint64_t page_hash(std::uint32_t index) const noexcept {
+        return page_hashes[index];
+    }
+    /**
+     * @brief Read captured memory as if it was read from the process.
+     *
+     * @return true All bytes have been captured.
+     * @return false Otherwise.
+     */
+    bool read_to_buf(std::uintptr_t address, void* buf, std::size_t size) const noexcept;
+};
+
+/**
+ * @brief Find bytes which differ between two snapshots.
+ *
+ * Only addresses captured in both snapshots are compared. A page readable in one snapshot
+ * but not in the other is reported as changed as a whole.
+ * Pages with different hashes are compared word by word to locate the changes,
+ * while pages with equal hashes only need one memcmp to be confirmed identical.
+ *
+ * @return std::vector<ChangedRange> Sorted and merged ranges.
+ */
+[[nodiscard]] std::vector<ChangedRange> diff(const Snapshot& before, const Snapshot& after);
+
+MEMORY_READER_NAMESPACE_END
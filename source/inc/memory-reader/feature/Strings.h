@@ -0,0 +1,338 @@
+/**
+ * @file Strings.h
+ * @author UnnamedOrange
+ * @brief Structures reading strings laid out in the to-be-read process.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "../process/IReadMemory.h"
+#include "../process/MemoryReader.h"
+#include "../utils/codecvt.h"
+#include "../utils/macro.h"
+
+MEMORY_READER_NAMESPACE_BEGIN
+
+namespace __detail {
+    /**
+     * @brief Reads never cross this boundary unless they have to,
+     * so that a string lying at the end of a mapping can still be read.
+     */
+    inline constexpr std::size_t string_read_page_size = 0x1000;
+
+    template <typename CharT>
+    inline std::optional<std::string> narrow(std::basic_string_view<CharT> str) noexcept {
+        if constexpr (std::is_same_v<CharT, char>) {
+            return std::string(str);
+        } else {
+            try {
+                return codecvt::to_string(str);
+            } catch (...) {
+                return std::nullopt;
+            }
+        }
+    }
+} // namespace __detail
+
+/**
+ * @brief Length-prefixed UTF-16 string of .NET (System.String).
+ *
+ * The object is laid out as a method table pointer, a 32-bit length,
+ * and then the UTF-16 code units without the terminating zero.
+ *
+ * A header and the first @b inline_length code units are read at once,
+ * so short strings cost only one read.
+ *
+ * @tparam width The width of the pointer in the to-be-read process.
+ * @tparam max_length Strings longer than this are regarded as corrupted.
+ * @tparam inline_length The number of code units read speculatively together with the header.
+ */
+template <PtrWidth width, std::size_t max_length = 0x100000, std::size_t inline_length = 32>
+class ClrString {
+private:
+    static constexpr std::size_t length_offset = static_cast<std::size_t>(width);
+    static constexpr std::size_t data_offset = length_offset + sizeof(std::int32_t);
+
+public:
+    /**
+     * @brief Read the string as UTF-16.
+     *
+     * @param reader The reader.
+     * @param address Address of the string object, i.e. the value of a reference to it.
+     * @return std::optional<std::u16string> If succeeded, return the string. Otherwise, return std::nullopt.
+     */
+    template <MemoryReader Reader>
+    std::optional<std::u16string> read_u16(const Reader& reader, std::uintptr_t address) const noexcept {
+        if (!address) {
+            return std::nullopt;
+        }
+
+        struct {
+            std::int32_t length;
+            char16_t data[inline_length];
+        } head;
+        const auto head_address = address + length_offset;
+        // Fall back to reading the length only if the speculative read crosses into an unreadable page.
+        bool has_inline = reader.read_to_buf(head_address, &head, sizeof(head));
+        if (!has_inline && !reader.read_to_buf(head_address, &head.length, sizeof(head.length))) {
+            return std::nullopt;
+        }
+        if (head.length < 0 || static_cast<std::size_t>(head.length) > max_length) {
+            return std::nullopt;
+        }
+
+        const auto length = static_cast<std::size_t>(head.length);
+        std::u16string ret;
+        try {
+            ret.resize(length);
+        } catch (...) {
+            return std::nullopt;
+        }
+        std::size_t done = 0;
+        if (has_inline) {
+            done = (std::min)(length, inline_length);
+            std::memcpy(ret.data(), head.data, done * sizeof(char16_t));
+        }
+        if (done < length && !reader.read_to_buf(address + data_offset + done * sizeof(char16_t), ret.data() + done,
+                                                 (length - done) * sizeof(char16_t))) {
+            return std::nullopt;
+        }
+        return ret;
+    }
+    /**
+     * @brief Read the string and convert it to std::string by @ref codecvt.
+     *
+     * @return std::optional<std::string> If succeeded, return the string.
+     * If reading or converting fails, return std::nullopt.
+     */
+    template <MemoryReader Reader>
+    std::optional<std::string> read(const Reader& reader, std::uintptr_t address) const noexcept {
+        auto u16 = read_u16(reader, address);
+        if (!u16) {
+            return std::nullopt;
+        }
+        return __detail::narrow(std::u16string_view(*u16));
+    }
+};
+
+/**
+ * @brief Zero-terminated string.
+ *
+ * The string is read chunk by chunk until the terminating zero is found.
+ * A chunk never crosses a page boundary,
+ * so a string right before an unreadable page can still be read.
+ *
+ * @tparam CharT Character type in the to-be-read process.
+ * @tparam max_length Strings longer than this are regarded as corrupted.
+ * @tparam chunk_size The maximum number of bytes per read.
+ */
+template <typename CharT = char, std::size_t max_length = 0x10000, std::size_t chunk_size = 0x100>
+    requires(chunk_size % sizeof(CharT) == 0 && __detail::string_read_page_size % sizeof(CharT) == 0)
+class CString {
+public:
+    /**
+     * @brief Read the string in its original character type.
+     *
+     * @return std::optional<std::basic_string<CharT>> If succeeded, return the string without the terminating zero.
+     * If no zero is found within @b max_length characters, return std::nullopt.
+     */
+    template <MemoryReader Reader>
+    std::optional<std::basic_string<CharT>> read_raw(const Reader& reader, std::uintptr_t address) const noexcept {
+        if (!address) {
+            return std::nullopt;
+        }
+
+        std::basic_string<CharT> ret;
+        std::uintptr_t crt = address;
+        while (ret.size() <= max_length) {
+            constexpr auto page = __detail::string_read_page_size;
+            std::size_t bytes = (std::min)(chunk_size, page - crt % page);
+            bytes -= bytes % sizeof(CharT);
+            // A character straddling two pages is read alone.
+            if (!bytes) {
+                bytes = sizeof(CharT);
+            }
+            const auto count = bytes / sizeof(CharT);
+
+            // Read into the tail of the result directly, then trim.
+            const auto old_size = ret.size();
+            try {
+                ret.resize(old_size + count);
+            } catch (...) {
+                return std::nullopt;
+            }
+            if (!reader.read_to_buf(crt, ret.data() + old_size, bytes)) {
+                return std::nullopt;
+            }
+            auto it = std::find(ret.begin() + old_size, ret.end(), CharT{});
+            if (it != ret.end()) {
+                ret.erase(it, ret.end());
+                if (ret.size() > max_length) {
+                    return std::nullopt;
+                }
+                return ret;
+            }
+            crt += bytes;
+        }
+        return std::nullopt;
+    }
+    /**
+     * @brief Read the string and convert it to std::string by @ref codecvt.
+     */
+    template <MemoryReader Reader>
+    std::optional<std::string> read(const Reader& reader, std::uintptr_t address) const noexcept {
+        auto raw = read_raw(reader, address);
+        if (!raw) {
+            return std::nullopt;
+        }
+        if constexpr (std::is_same_v<CharT, char>) {
+            return raw;
+        } else {
+            return __detail::narrow(std::basic_string_view<CharT>(*raw));
+        }
+    }
+};
+
+namespace __detail {
+    /**
+     * @brief Read a std::basic_string whose layout is described by @b Layout.
+     *
+     * The whole object is read at once. If the characters are stored inline,
+     * no further read is needed, and a size not fitting in the inline buffer is rejected.
+     */
+    template <typename Layout, typename CharT, std::size_t max_length, MemoryReader Reader>
+    inline std::optional<std::basic_string<CharT>> read_std_string(const Reader& reader,
+                                                                   std::uintptr_t address) noexcept {
+        auto object = read_value<typename Layout::Object>(reader, address);
+        if (!object) {
+            return std::nullopt;
+        }
+        const auto length = static_cast<std::size_t>(object->size);
+        if (length > max_length) {
+            return std::nullopt;
+        }
+
+        const auto inline_data = Layout::inline_data(*object, address);
+        // The terminator is stored inline too, so a longer size can only be corrupted.
+        if (inline_data && length >= Layout::buf_size) {
+            return std::nullopt;
+        }
+
+        std::basic_string<CharT> ret;
+        try {
+            ret.resize(length);
+        } catch (...) {
+            return std::nullopt;
+        }
+        if (inline_data) {
+            std::memcpy(ret.data(), inline_data, length * sizeof(CharT));
+        } else if (!reader.read_to_buf(Layout::data_address(*object), ret.data(), length * sizeof(CharT))) {
+            return std::nullopt;
+        }
+        return ret;
+    }
+
+    template <PtrWidth width, typename CharT>
+    struct MsvcStringLayout {
+        using Ptr = PtrType<width>;
+        static constexpr std::size_t buf_size = 16 / sizeof(CharT);
+        struct Object {
+            union {
+                CharT buf[buf_size];
+                Ptr ptr;
+            } bx;
+            Ptr size;
+            Ptr capacity;
+        };
+        static const CharT* inline_data(const Object& object, std::uintptr_t) noexcept {
+            return object.capacity < buf_size ? object.bx.buf : nullptr;
+        }
+        static std::uintptr_t data_address(const Object& object) noexcept {
+            return static_cast<std::uintptr_t>(object.bx.ptr);
+        }
+    };
+
+    template <PtrWidth width, typename CharT>
+    struct LibstdcxxStringLayout {
+        using Ptr = PtrType<width>;
+        static constexpr std::size_t buf_size = 16 / sizeof(CharT);
+        struct Object {
+            Ptr ptr;
+            Ptr size;
+            union {
+                CharT buf[buf_size];
+                Ptr capacity;
+            } local;
+        };
+        static const CharT* inline_data(const Object& object, std::uintptr_t address) noexcept {
+            // The data pointer points to the local buffer of the object itself.
+            return object.ptr == address + offsetof(Object, local) ? object.local.buf : nullptr;
+        }
+        static std::uintptr_t data_address(const Object& object) noexcept {
+            return static_cast<std::uintptr_t>(object.ptr);
+        }
+    };
+} // namespace __detail
+
+/**
+ * @brief std::basic_string of MSVC STL.
+ *
+ * @tparam width The width of the pointer in the to-be-read process.
+ * @tparam CharT Character type in the to-be-read process.
+ * @tparam max_length Strings longer than this are regarded as corrupted.
+ */
+template <PtrWidth width, typename CharT = char, std::size_t max_length = 0x100000>
+class MsvcString {
+public:
+    template <MemoryReader Reader>
+    std::optional<std::basic_string<CharT>> read_raw(const Reader& reader, std::uintptr_t address) const noexcept {
+        return __detail::read_std_string<__detail::MsvcStringLayout<width, CharT>, CharT, max_length>(reader,
+                                                                                                      address);
+    }
+    template <MemoryReader Reader>
+    std::optional<std::string> read(const Reader& reader, std::uintptr_t address) const noexcept {
+        auto raw = read_raw(reader, address);
+        if (!raw) {
+            return std::nullopt;
+        }
+        return __detail::narrow(std::basic_string_view<CharT>(*raw));
+    }
+};
+
+/**
+ * @brief std::basic_string of libstdc++ (the C++11 ABI).
+ *
+ * @tparam width The width of the pointer in the to-be-read process.
+ * @tparam CharT Character type in the to-be-read process.
+ * @tparam max_length Strings longer than this are regarded as corrupted.
+ */
+template <PtrWidth width, typename CharT = char, std::size_t max_length = 0x100000>
+class LibstdcxxString {
+public:
+    template <MemoryReader Reader>
+    std::optional<std::basic_string<CharT>> read_raw(const Reader& reader, std::uintptr_t address) const noexcept {
+        return __detail::read_std_string<__detail::LibstdcxxStringLayout<width, CharT>, CharT, max_length>(reader,
+                                                                                                           address);
+    }
+    template <MemoryReader Reader>
+    std::optional<std::string> read(const Reader& reader, std::uintptr_t address) const noexcept {
+        auto raw = read_raw(reader, address);
+        if (!raw) {
+            return std::nullopt;
+        }
+        return __detail::narrow(std::basic_string_view<CharT>(*raw));
+    }
+};
+
+MEMORY_READER_NAMESPACE_END
@@ -0,0 +1,563 @@
+/**
+ * @file ValueScanner.h
+ * @author UnnamedOrange
+ * @brief Find addresses holding a value, then narrow them down by scanning again.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../process/IReadMemory.h"
+#include "../utils/Parallel.h"
+#include "../utils/macro.h"
+#include "ChangedRange.h"
+#include "RegionReader.h"
+#include "ScanScheduler.h"
+
+MEMORY_READER_NAMESPACE_BEGIN
+
+/**
+ * @brief How the new value of a candidate is compared in @ref ValueScanner::next_scan.
+ */
+enum class ScanCompare {
+    /**
+     * @brief The new value equals the given value.
+     */
+    EXACT,
+    /**
+     * @brief The new value differs from the previous one bitwise.
+     */
+    CHANGED,
+    /**
+     * @brief The new value equals the previous one bitwise.
+     */
+    UNCHANGED,
+    /**
+     * @brief The new value is greater than the previous one.
+     */
+    INCREASED,
+    /**
+     * @brief The new value is less than the previous one.
+     */
+    DECREASED,
+};
+
+/**
+ * @brief Options of @ref ValueScanner.
+ */
+struct ValueScannerOptions {
+    /**
+     * @brief Regions to be scanned by the first scan. Writable regions by default.
+     */
+    RegionFilter filter{.required = RegionProtection::READ | RegionProtection::WRITE};
+    /**
+     * @brief Values are only looked for at multiples of this. If 0, use the size of the value.
+     */
+    std::size_t alignment = 0;
+    /**
+     * @brief The number of worker threads. If 0, use the number of hardware threads.
+     */
+    std::size_t threads = 0;
+    /**
+     * @brief Regions are read and candidates are stored in blocks of this size.
+     * It should be a multiple of the alignment.
+     */
+    std::size_t chunk_size = std::size_t{1} << 20;
+    /**
+     * @brief See @ref RegionReaderOptions::read_ahead. Each thread reads ahead its own blocks.
+     */
+    std::size_t read_ahead = 1;
+    /**
+     * @brief If not null, reads are paced by it, and the progress of scans is reported by it.
+     * Worker threads of parallel scans run at its priority. It MUST have a longer life span than the scanner.
+     */
+    ScanScheduler* scheduler = nullptr;
+};
+
+namespace __detail {
+    template <typename T>
+    inline T load_unaligned(const std::byte* data) noexcept {
+        T ret;
+        std::memcpy(&ret, data, sizeof(T));
+        return ret;
+    }
+
+    /**
+     * @brief Compare @b slots values against @b value, 64 at a time,
+     * writing one bit per slot into @b bitmap.
+     * The inner loop is branch-free so that the compiler can vectorize it.
+     *
+     * @return std::size_t The number of set bits.
+     */
+    template <typename T>
+    std::size_t compare_exact_kernel(const std::byte* data, std::size_t slots, std::size_t stride, T value,
+                                     std::uint64_t* bitmap) noexcept {
+        std::size_t count = 0;
+        for (std::size_t word = 0; word * 64 < slots; word++) {
+            const auto n = (std::min)(std::size_t{64}, slots - word * 64);
+            const auto base = data + word * 64 * stride;
+            std::uint64_t mask = 0;
+            for (std::size_t j = 0; j < n; j++) {
+                mask |= std::uint64_t{load_unaligned<T>(base + j * stride) == value} << j;
+            }
+            bitmap[word] = mask;
+            count += static_cast<std::size_t>(std::popcount(mask));
+        }
+        return count;
+    }
+
+    template <typename T>
+    inline bool compare_values(ScanCompare compare, T new_value, T old_value, T value) noexcept {
+        switch (compare) {
+        case ScanCompare::EXACT: return new_value == value;
+        case ScanCompare::CHANGED: return std::memcmp(&new_value, &old_value, sizeof(T)) != 0;
+        case ScanCompare::UNCHANGED: return std::memcmp(&new_value, &old_value, sizeof(T)) == 0;
+        case ScanCompare::INCREASED: return new_value > old_value;
+        case ScanCompare::DECREASED: return new_value < old_value;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Whether any of the sorted, disjoint @b ranges overlaps [address, address + size).
+     */
+    inline bool overlaps_any(std::span<const ChangedRange> ranges, std::uintptr_t address, std::size_t size) noexcept {
+        auto it = std::partition_point(ranges.begin(), ranges.end(), [&](const ChangedRange& range) {
+            return range.address + range.size <= address;
+        });
+        return it != ranges.end() && it->address < address + size;
+    }
+} // namespace __detail
+
+/**
+ * @brief Find addresses holding a value, then narrow them down by scanning again.
+ *
+ * Candidates are kept per block of @ref ValueScannerOptions::chunk_size bytes,
+ * as a bitmap if they are dense and as sorted slot indices otherwise,
+ * together with their last values.
+ * Blocks are processed by multiple threads.
+ *
+ * @tparam T Type of the value.
+ */
+template <typename T>
+    requires std::is_arithmetic_v<T>
+class ValueScanner {
+    using Self = ValueScanner;
+
+private:
+    struct Block {
+        std::uintptr_t address{};
+        std::size_t size{};
+        /**
+         * @brief The number of bytes after the owned ones which slots near the end may cover.
+         */
+        std::size_t overlap{};
+        std::size_t count{};
+        /**
+         * @brief Bit i is set if the slot at address + i * alignment is a candidate. Used if dense.
+         */
+        std::vector<std::uint64_t> bitmap{};
+        /**
+         * @brief Sorted indices of the slots being candidates. Used if sparse.
+         */
+        std::vector<std::uint32_t> indices{};
+        /**
+         * @brief Last values of the candidates, in the order of addresses.
+         * Empty if they have not been compared since the first scan, i.e. they all hold @ref first_value.
+         */
+        std::vector<T> values{};
+    };
+
+    const IReadMemory& reader;
+    ValueScannerOptions options;
+    std::size_t alignment;
+    std::vector<Block> blocks;
+    /**
+     * @brief The value of the first scan, stored once instead of per candidate.
+     */
+    T first_value{};
+    bool scanned = false;
+
+public:
+    /**
+     * @note @b reader MUST have a longer life span than this object.
+     */
+    ValueScanner(const IReadMemory& reader, const ValueScannerOptions& options = {})
+        : reader(reader), options(options), alignment(options.alignment ? options.alignment : sizeof(T)) {
+        this->options.threads = resolve_thread_count(this->options.threads);
+        // Keep slots from crossing chunks.
+        this->options.chunk_size = (std::max)(alignment, this->options.chunk_size / alignment * alignment);
+    }
+
+private:
+    /**
+     * @brief The number of slots starting in the owned bytes of a block. They may end in the overlapping ones.
+     */
+    std::size_t slot_count(const Block& block) const noexcept {
+        const auto owned = (block.size + alignment - 1) / alignment;
+        const auto size = block.size + block.overlap;
+        return (std::min)(owned, size < sizeof(T) ? 0 : (size - sizeof(T)) / alignment + 1);
+    }
+    T last_value(const Block& block, std::size_t k) const noexcept {
+        return block.values.empty() ? first_value : block.values[k];
+    }
+    /**
+     * @brief Store the @b count candidates marked in @b bitmap, choosing the smaller representation.
+     */
+    void assign_bitmap(Block& block, std::vector<std::uint64_t>&& bitmap, std::size_t count,
+                       std::vector<T>&& values) const {
+        const auto slots = slot_count(block);
+        block.count = count;
+        block.values = std::move(values);
+        block.indices.clear();
+        if (count * 32 >= slots) {
+            block.bitmap = std::move(bitmap);
+            return;
+        }
+        block.bitmap.clear();
+        block.indices.reserve(count);
+        for (std::size_t word = 0; word < bitmap.size(); word++) {
+            for (auto mask = bitmap[word]; mask; mask &= mask - 1) {
+                block.indices.push_back(static_cast<std::uint32_t>(word * 64 + std::countr_zero(mask)));
+            }
+        }
+    }
+    /**
+     * @brief Switch a dense block to sorted slot indices.
+     */
+    void make_sparse(Block& block) const {
+        if (block.bitmap.empty()) {
+            return;
+        }
+        block.indices.clear();
+        block.indices.reserve(block.count);
+        for (std::size_t word = 0; word < block.bitmap.size(); word++) {
+            for (auto mask = block.bitmap[word]; mask; mask &= mask - 1) {
+                block.indices.push_back(static_cast<std::uint32_t>(word * 64 + std::countr_zero(mask)));
+            }
+        }
+        block.bitmap.clear();
+    }
+
+    void first_scan_share(const std::vector<RegionChunk>& chunks, T value, std::vector<Block>& out) const {
+        RegionReader region_reader(
+            reader, chunks, RegionReaderOptions{.read_ahead = options.read_ahead, .scheduler = options.scheduler});
+        std::vector<std::uint64_t> bitmap;
+        while (auto view = region_reader.next()) {
+            Block block{.address = view->chunk.address, .size = view->chunk.size, .overlap = view->chunk.overlap};
+            const auto slots = slot_count(block);
+            bitmap.assign((slots + 63) / 64, 0);
+            auto count = __detail::compare_exact_kernel(view->data.data(), slots, alignment, value, bitmap.data());
+            if (!count) {
+                continue;
+            }
+            // Every candidate holds the value now, which is kept by the scanner.
+            assign_bitmap(block, std::move(bitmap), count, {});
+            out.push_back(std::move(block));
+        }
+    }
+    /**
+     * @brief Narrow a dense block down, with all of its bytes read.
+     */
+    void next_scan_dense(Block& block, const std::byte* data, ScanCompare compare, T value) const {
+        std::vector<std::uint64_t> bitmap(block.bitmap.size());
+        std::vector<T> values;
+        std::size_t k = 0;
+        for (std::size_t word = 0; word < block.bitmap.size(); word++) {
+            for (auto mask = block.bitmap[word]; mask; mask &= mask - 1, k++) {
+                auto bit = static_cast<std::size_t>(std::countr_zero(mask));
+                auto new_value = __detail::load_unaligned<T>(data + (word * 64 + bit) * alignment);
+                if (__detail::compare_values(compare, new_value, last_value(block, k), value)) {
+                    bitmap[word] |= std::uint64_t{1} << bit;
+                    values.push_back(new_value);
+                }
+            }
+        }
+        const auto count = values.size();
+        assign_bitmap(block, std::move(bitmap), count, std::move(values));
+    }
+    /**
+     * @brief Narrow a sparse block down, reading nearby candidates together in one batch.
+     */
+    void next_scan_sparse(Block& block, ScanCompare compare, T value) const {
+        // Candidates closer than this are read in one span.
+        constexpr std::size_t max_gap = 0x100;
+        constexpr auto page_size = RegionReader::page_size;
+        struct Span {
+            std::size_t first;
+            std::size_t last;
+        };
+        // Spans do not cross pages, so that an unreadable page only drops its own candidates.
+        auto page_of = [&](std::size_t k, std::size_t offset) {
+            return (block.address + block.indices[k] * alignment + offset) / page_size;
+        };
+        std::vector<Span> spans;
+        for (std::size_t k = 0; k < block.indices.size(); k++) {
+            if (!spans.empty() &&
+                (block.indices[k] - block.indices[spans.back().last]) * alignment <= max_gap &&
+                page_of(k, sizeof(T) - 1) == page_of(spans.back().first, 0)) {
+                spans.back().last = k;
+            } else {
+                spans.push_back(Span{.first = k, .last = k});
+            }
+        }
+
+        std::vector<ReadRequest> requests;
+        std::vector<std::size_t> offsets;
+        std::size_t total = 0;
+        for (const auto& span : spans) {
+            const auto size = (block.indices[span.last] - block.indices[span.first]) * alignment + sizeof(T);
+            requests.push_back(ReadRequest{
+                .address = block.address + block.indices[span.first] * alignment,
+                .buf = nullptr,
+                .size = size,
+            });
+            offsets.push_back(total);
+            total += size;
+        }
+        std::vector<std::byte> buf(total);
+        for (std::size_t i = 0; i < requests.size(); i++) {
+            requests[i].buf = buf.data() + offsets[i];
+        }
+        reader.read_to_bufs(requests);
+
+        std::vector<std::uint32_t> indices;
+        std::vector<T> values;
+        for (std::size_t i = 0; i < spans.size(); i++) {
+            if (!requests[i].ok) {
+                continue;
+            }
+            const auto first_index = block.indices[spans[i].first];
+            for (auto k = spans[i].first; k <= spans[i].last; k++) {
+                auto data = buf.data() + offsets[i] + (block.indices[k] - first_index) * alignment;
+                auto new_value = __detail::load_unaligned<T>(data);
+                if (__detail::compare_values(compare, new_value, last_value(block, k), value)) {
+                    indices.push_back(block.indices[k]);
+                    values.push_back(new_value);
+                }
+            }
+        }
+        // Sparse blocks only get sparser.
+        block.count = indices.size();
+        block.indices = std::move(indices);
+        block.values = std::move(values);
+    }
+    /**
+     * @brief Narrow a block down without reading, since none of its bytes has been written.
+     */
+    void next_scan_clean(Block& block, ScanCompare compare, T value) const {
+        std::vector<T> values;
+        if (block.bitmap.empty()) {
+            std::vector<std::uint32_t> indices;
+            for (std::size_t k = 0; k < block.indices.size(); k++) {
+                const auto old_value = last_value(block, k);
+                if (__detail::compare_values(compare, old_value, old_value, value)) {
+                    indices.push_back(block.indices[k]);
+                    values.push_back(old_value);
+                }
+            }
+            block.count = indices.size();
+            block.indices = std::move(indices);
+            block.values = std::move(values);
+            return;
+        }
+        std::vector<std::uint64_t> bitmap(block.bitmap.size());
+        std::size_t k = 0;
+        for (std::size_t word = 0; word < block.bitmap.size(); word++) {
+            for (auto mask = block.bitmap[word]; mask; mask &= mask - 1, k++) {
+                const auto old_value = last_value(block, k);
+                if (__detail::compare_values(compare, old_value, old_value, value)) {
+                    bitmap[word] |= std::uint64_t{1} << std::countr_zero(mask);
+                    values.push_back(old_value);
+                }
+            }
+        }
+        const auto count = values.size();
+        assign_bitmap(block, std::move(bitmap), count, std::move(values));
+    }
+    /**
+     * @param dirty If not std::nullopt, only blocks overlapping these ranges are read.
+     */
+    void next_scan_share(std::size_t begin, std::size_t end, ScanCompare compare, T value,
+                         std::optional<std::span<const ChangedRange>> dirty) {
+        // Candidates near the end of a block may end in the overlap, i.e. in the next page.
+        auto is_dirty = [&](const Block& block) {
+            return !dirty || __detail::overlaps_any(*dirty, block.address, block.size + block.overlap);
+        };
+        std::vector<RegionChunk> dense_chunks;
+        for (auto i = begin; i < end; i++) {
+            if (!blocks[i].bitmap.empty() && is_dirty(blocks[i])) {
+                dense_chunks.push_back(
+                    RegionChunk{.address = blocks[i].address, .size = blocks[i].size, .overlap = blocks[i].overlap});
+            }
+        }
+        RegionReader region_reader(
+            reader, std::move(dense_chunks),
+            RegionReaderOptions{.read_ahead = options.read_ahead, .scheduler = options.scheduler});
+        std::optional<ChunkView> view;
+        for (auto i = begin; i < end; i++) {
+            auto& block = blocks[i];
+            if (!is_dirty(block)) {
+                next_scan_clean(block, compare, value);
+                continue;
+            }
+            if (block.bitmap.empty()) {
+                next_scan_sparse(block, compare, value);
+                continue;
+            }
+            // Skip the rest of the previous block, which may have been read in parts.
+            while (!view || view->chunk.address < block.address) {
+                if (!(view = region_reader.next())) {
+                    break;
+                }
+            }
+            // Some pages of this block cannot be read, so read its candidates span by span.
+            if (!view || view->chunk.address != block.address || view->data.size() != block.size + block.overlap) {
+                make_sparse(block);
+                next_scan_sparse(block, compare, value);
+                continue;
+            }
+            next_scan_dense(block, view->data.data(), compare, value);
+        }
+    }
+    /**
+     * @brief Called first on each worker thread of a parallel scan.
+     */
+    void init_worker() const noexcept {
+        if (options.scheduler) {
+            options.scheduler->lower_current_thread();
+        }
+    }
+    std::size_t next_scan_impl(ScanCompare compare, T value, std::optional<std::span<const ChangedRange>> dirty) {
+        if (!scanned) {
+            return 0;
+        }
+        auto share = [&](std::size_t begin, std::size_t end, std::size_t) {
+            next_scan_share(begin, end, compare, value, dirty);
+        };
+        parallel_shares(blocks.size(), options.threads, share, [this] { init_worker(); });
+        std::erase_if(blocks, [](const Block& block) { return !block.count; });
+        return count();
+    }
+
+public:
+    /**
+     * @brief Find all addresses holding @b value in regions satisfying the filter.
+     * Previous candidates are dropped.
+     *
+     * @return std::size_t The number of candidates.
+     */
+    std::size_t first_scan(T value) {
+        auto regions = reader.query_regions(options.filter);
+        // Unaligned values may cross the end of a chunk.
+        const auto overlap = alignment < sizeof(T) ? sizeof(T) - 1 : 0;
+        auto chunks =
+            split_regions(regions, RegionReaderOptions{.chunk_size = options.chunk_size, .overlap = overlap});
+
+        std::vector<std::vector<Block>> results(options.threads);
+        auto share = [&](std::size_t begin, std::size_t end, std::size_t t) {
+            first_scan_share({chunks.begin() + begin, chunks.begin() + end}, value, results[t]);
+        };
+        parallel_shares(chunks.size(), options.threads, share, [this] { init_worker(); });
+
+        // Shares are contiguous, so the blocks stay sorted by address.
+        blocks.clear();
+        first_value = value;
+        for (auto& result : results) {
+            std::move(result.begin(), result.end(), std::back_inserter(blocks));
+        }
+        scanned = true;
+        return count();
+    }
+    /**
+     * @brief Keep the candidates whose new values satisfy @b compare.
+     * If @ref first_scan has not been called, do nothing.
+     *
+     * @param value Only used by @ref ScanCompare::EXACT.
+     * @return std::size_t The number of candidates left.
+     */
+    std::size_t next_scan(ScanCompare compare, T value = {}) {
+        return next_scan_impl(compare, value, std::nullopt);
+    }
+    /**
+     * @brief Same as @ref next_scan, but only read blocks overlapping @b dirty.
+     * Candidates in other blocks are compared as if they still held their last values.
+     *
+     * Use it with @ref DirtyPageTracker, checkpointed before the previous scan.
+     *
+     * @param dirty Sorted and disjoint ranges which may have been written since the previous scan.
+     */
+    std::size_t next_scan(ScanCompare compare, T value, std::span<const ChangedRange> dirty) {
+        return next_scan_impl(compare, value, dirty);
+    }
+    /**
+     * @brief Drop all candidates.
+     */
+    void reset() noexcept {
+        blocks.clear();
+        first_value = {};
+        scanned = false;
+    }
+
+public:
+    /**
+     * @brief The number of candidates.
+     */
+    [[nodiscard]] std::size_t count() const noexcept {
+        std::size_t ret = 0;
+        for (const auto& block : blocks) {
+            ret += block.count;
+        }
+        return ret;
+    }
+    /**
+     * @brief Call @b func(address, last_value) for each candidate in the order of addresses.
+     */
+    template <typename Func>
+    void for_each(Func&& func) const {
+        for (const auto& block : blocks) {
+            std::size_t k = 0;
+            if (block.bitmap.empty()) {
+                for (auto index : block.indices) {
+                    func(block.address + index * alignment, last_value(block, k++));
+                }
+                continue;
+            }
+            for (std::size_t word = 0; word < block.bitmap.size(); word++) {
+                for (auto mask = block.bitmap[word]; mask; mask &= mask - 1) {
+                    auto index = word * 64 + static_cast<std::size_t>(std::countr_zero(mask));
+                    func(block.address + index * alignment, last_value(block, k++));
+                }
+            }
+        }
+    }
+    /**
+     * @brief Get at most @b max_count candidates in the order of addresses.
+     */
+    [[nodiscard]] std::vector<std::uintptr_t> addresses(std::size_t max_count = SIZE_MAX) const {
+        std::vector<std::uintptr_t> ret;
+        for_each([&](std::uintptr_t address, T) {
+            if (ret.size() < max_count) {
+                ret.push_back(address);
+            }
+        });
+        return ret;
+    }
+};
+
+MEMORY_READER_NAMESPACE_END
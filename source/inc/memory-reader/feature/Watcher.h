@@ -0,0 +1,197 @@
+/**
+ * @file Watcher.h
+ * @author UnnamedOrange
+ * @brief Poll values on a single thread and notify subscribers of changes.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "../process/IReadMemory.h"
+#include "../utils/macro.h"
+#include "Offsets.h"
+
+MEMORY_READER_NAMESPACE_BEGIN
+
+/**
+ * @brief A value to be watched, described the same way as @ref ValueOffsets.
+ *
+ * All offsets but the last are followed as pointers of @b width,
+ * and @b size bytes are read at the last offset.
+ */
+struct WatchTarget {
+    PtrWidth width = PtrWidth::IS_CURRENT;
+    std::uintptr_t base{};
+    /**
+     * @brief If empty, the value is read at @b base directly.
+     */
+    std::vector<std::intptr_t> offsets;
+    std::size_t size{};
+
+    bool operator==(const WatchTarget&) const = default;
+};
+
+/**
+ * @brief Poll values on a single thread and notify subscribers of changes.
+ *
+ * Subscriptions of the same @ref WatchTarget share one entry,
+ * which is polled at the shortest period among them.
+ * All entries due at the same time are read in batches, one batch per level of pointers,
+ * with identical addresses read once.
+ */
+class Watcher final {
+    using Self = Watcher;
+
+public:
+    using clock = std::chrono::steady_clock;
+    /**
+     * @brief Called with the new value. An empty span means the value cannot be read.
+     */
+    using Callback = std::function<void(std::span<const std::byte> value)>;
+    using SubscriptionId = std::uint64_t;
+
+private:
+    struct Subscriber {
+        SubscriptionId id;
+        clock::duration period;
+        Callback callback;
+        /**
+         * @brief Whether the subscriber has not been notified yet.
+         */
+        bool fresh = true;
+    };
+    struct Entry {
+        WatchTarget target;
+        clock::duration period;
+        clock::time_point next_due;
+        std::vector<Subscriber> subscribers;
+
+        // Only accessed by the polling thread.
+        std::optional<std::vector<std::byte>> value;
+        std::vector<std::byte> incoming;
+        bool incoming_ok = false;
+    };
+
+    const IReadMemory& reader;
+
+    mutable std::mutex m_state;
+    std::condition_variable cv_state;
+    std::vector<std::shared_ptr<Entry>> entries;
+    std::function<void()> poll_callback;
+    SubscriptionId next_id = 1;
+    bool should_exit = false;
+
+    std::thread polling_thread{&Self::polling_thread_routine, this};
+
+public:
+    /**
+     * @note @b reader MUST have a longer life span than this object.
+     */
+    Watcher(const IReadMemory& reader) noexcept;
+    Watcher(const Self&) = delete;
+    Self& operator=(const Self&) = delete;
+    Watcher(Self&&) = delete;
+    Self& operator=(Self&&) = delete;
+
+    ~Watcher();
+
+private:
+    void polling_thread_routine();
+    /**
+     * @brief Read all @b due entries into their incoming buffers.
+     */
+    void poll(const std::vector<std::shared_ptr<Entry>>& due) const noexcept;
+    /**
+     * @brief Subscribe @b target, converting the bytes to @b T for @b callback.
+     */
+    template <typename T>
+    SubscriptionId subscribe_value(const WatchTarget& target, clock::duration period,
+                                   std::function<void(std::optional<T>)> callback) {
+        return subscribe(target, period, [callback = std::move(callback)](std::span<const std::byte> value) {
+            if (value.size() != sizeof(T)) {
+                callback(std::nullopt);
+                return;
+            }
+            T buf;
+            std::memcpy(&buf, value.data(), sizeof(T));
+            callback(buf);
+        });
+    }
+
+public:
+    /**
+     * @brief Watch @b target every @b period and call @b callback when it changes.
+     * The callback is called on the polling thread for the first read as well.
+     *
+     * @note This method is reentrant. It may be called in a callback.
+     *
+     * @return SubscriptionId Used to unsubscribe.
+     */
+    SubscriptionId subscribe(const WatchTarget& target, clock::duration period, Callback callback);
+    /**
+     * @brief Watch a value described by @ref ValueOffsets.
+     *
+     * @see subscribe
+     */
+    template <PtrWidth width, typename T, std::intptr_t... offsets>
+    SubscriptionId subscribe(const ValueOffsets<width, T, offsets...>&, std::uintptr_t base, clock::duration period,
+                             std::type_identity_t<std::function<void(std::optional<T>)>> callback) {
+        using Offsets = ValueOffsets<width, T, offsets...>;
+        WatchTarget target{
+            .width = width,
+            .base = base,
+            .offsets = {Offsets::offset_array.begin(), Offsets::offset_array.end()},
+            .size = sizeof(T),
+        };
+        return subscribe_value<T>(target, period, std::move(callback));
+    }
+    /**
+     * @brief Watch a value described by @ref DynamicOffsets.
+     *
+     * @see subscribe
+     */
+    template <PtrWidth width, typename T>
+    SubscriptionId subscribe(const DynamicOffsets<width, T>& offsets, std::uintptr_t base, clock::duration period,
+                             std::type_identity_t<std::function<void(std::optional<T>)>> callback) {
+        const auto list = offsets.offsets();
+        WatchTarget target{
+            .width = width,
+            .base = base,
+            .offsets = {list.begin(), list.end()},
+            .size = sizeof(T),
+        };
+        return subscribe_value<T>(target, period, std::move(callback));
+    }
+    /**
+     * @brief Cancel a subscription.
+     *
+     * @note This method is reentrant. It may be called in a callback.
+     * A notification in progress may still arrive after this method returns.
+     */
+    void unsubscribe(SubscriptionId id);
+    /**
+     * @brief Call @b callback on the polling thread after each poll, once subscribers have been notified,
+     * whether any value has changed or not. Nothing is polled while there is no subscription.
+     *
+     * @note This method is reentrant. It may be called in a callback.
+     */
+    void set_poll_callback(std::function<void()> callback);
+};
+
+MEMORY_READER_NAMESPACE_END
@@ -10,7 +10,9 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <mutex>
 
 #include "../utils/macro.h"
@@ -31,8 +33,22 @@ private:
     mutable std::mutex m_exit;
     mutable std::condition_variable cv_exit;
 
-    inline static std::atomic<int> global_cache_hint;
-    int cache_hint = 0;
+    inline static std::atomic<std::uint64_t> global_generation;
+    /**
+     * @brief Drawn from @ref global_generation each time a process is held. See @ref identity.
+     */
+    mutable std::atomic<std::uint64_t> generation{};
+    mutable std::atomic<std::uint64_t> cache_hint{};
+    /**
+     * @brief When @ref cache_hint was last computed, in ticks of std::chrono::steady_clock.
+     */
+    mutable std::atomic<std::chrono::steady_clock::rep> validated_at{};
+
+public:
+    /**
+     * @brief @ref get_cache_hint recomputes the identity of the process at most once in this interval.
+     */
+    static constexpr std::chrono::milliseconds identity_revalidation_interval{100};
 
 public:
     AbstractProcess() noexcept = default;
@@ -50,11 +66,15 @@ public:
 
     // Implements IReadMemoryWithCacheHint.
 public:
-    [[nodiscard]] int get_cache_hint() const noexcept override;
+    /**
+     * @brief The cache hint is the identity of the process, see @ref identity.
+     * It is revalidated at most once in @ref identity_revalidation_interval, so it is cheap to call.
+     */
+    [[nodiscard]] std::uint64_t get_cache_hint() const noexcept override;
 
 public:
     /**
-     * @brief Reset the process to empty state.
+     * @brief Reset the process to empty state. The cache hint becomes 0 immediately.
      */
     virtual void reset() noexcept = 0;
     /**
@@ -65,7 +85,41 @@ public:
     [[nodiscard]] virtual bool empty() const noexcept = 0;
 
 protected:
-    void update_cache_hint() noexcept;
+    /**
+     * @brief A 64-bit token identifying the held process and its image,
+     * e.g. made of the PID, the start time and the generation of exec.
+     * It changes once the PID is reused or the process replaces its image, so caches are dropped.
+     *
+     * By default, it is a number drawn each time @ref update_cache_hint is called,
+     * so it only changes when another process is held. Override it to notice a process which has gone.
+     *
+     * @note This method is reentrant.
+     *
+     * @return std::uint64_t The token. 0 if the process is empty or has gone.
+     */
+    [[nodiscard]] virtual std::uint64_t identity() const noexcept;
+    /**
+     * @brief Recompute the cache hint now. Call it once a process is held or reset.
+     */
+    void update_cache_hint() const noexcept;
+
+private:
+    /**
+     * @brief Recompute the cache hint from @ref identity.
+     */
+    void revalidate_cache_hint() const noexcept;
+
+protected:
+    /**
+     * @brief Mix @b value into @b seed. Used to make an identity from several fields.
+     */
+    [[nodiscard]] static constexpr std::uint64_t combine_identity(std::uint64_t seed, std::uint64_t value) noexcept {
+        // splitmix64 finalizer.
+        value += seed + 0x9E3779B97F4A7C15;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EB;
+        return value ^ (value >> 31);
+    }
 };
 
 MEMORY_READER_NAMESPACE_END
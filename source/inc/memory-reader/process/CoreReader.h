@@ -0,0 +1,123 @@
+/**
+ * @file CoreReader.h
+ * @author UnnamedOrange
+ * @brief Read memory captured in an ELF core file.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+#include "../utils/macro.h"
+#include "IReadMemoryWithCacheHint.h"
+
+MEMORY_READER_NAMESPACE_BEGIN
+
+/**
+ * @brief Read memory captured in an ELF core file, e.g. one dumped by the kernel or by gcore.
+ *
+ * The file is mapped into the current process, so reads are plain copies without system calls.
+ * Regions come from the PT_LOAD program headers, and their paths from the NT_FILE note if present.
+ * Only the bytes stored in the file are readable, so pages left out of the dump, e.g. unmodified
+ * file-backed pages filtered out by coredump_filter, are not part of any region.
+ *
+ * Both 32-bit and 64-bit little-endian core files are supported on all platforms.
+ * It lets features such as @ref Signature and @ref ValueScanner run against a captured state offline.
+ */
+class CoreReader final : public IReadMemoryWithCacheHint {
+    using Self = CoreReader;
+
+public:
+    /**
+     * @brief A region stored in the file.
+     */
+    struct Segment {
+        Region region{};
+        /**
+         * @brief The bytes of the region, in the mapping of the file.
+         */
+        const std::byte* data{};
+    };
+
+private:
+    /**
+     * @brief The mapping of the whole file.
+     */
+    const std::byte* view = nullptr;
+    std::size_t view_size = 0;
+    /**
+     * @brief Segments in ascending order of their addresses.
+     */
+    std::vector<Segment> segments;
+    std::uint64_t cache_hint = 0;
+
+public:
+    /**
+     * @brief Construct an empty object, from which nothing can be read.
+     */
+    CoreReader() noexcept = default;
+    CoreReader(const Self&) = delete;
+    Self& operator=(const Self&) = delete;
+    CoreReader(Self&& other) noexcept;
+    Self& operator=(Self&& other) noexcept;
+
+    ~CoreReader();
+
+    /**
+     * @brief Open an ELF core file.
+     *
+     * @return Self If the file cannot be mapped or is not a valid core file, return an empty object.
+     */
+    [[nodiscard]] static Self try_open(const std::filesystem::path& path) noexcept;
+
+private:
+    /**
+     * @brief Map the whole file read-only into @ref view.
+     */
+    bool map_file(const std::filesystem::path& path) noexcept;
+    void unmap() noexcept;
+    /**
+     * @brief Fill @ref segments from the headers of the mapped file.
+     */
+    bool parse();
+    /**
+     * @brief Find the segment containing @b address.
+     */
+    [[nodiscard]] const Segment* find(std::uintptr_t address) const noexcept;
+
+public:
+    [[nodiscard]] bool empty() const noexcept {
+        return !view;
+    }
+    /**
+     * @brief Segments in ascending order of their addresses.
+     */
+    [[nodiscard]] std::span<const Segment> get_segments() const noexcept {
+        return segments;
+    }
+
+    // Implements IReadMemory.
+public:
+    [[nodiscard]] bool read_to_buf(std::uintptr_t address, void* buf, std::size_t size) const noexcept override;
+    [[nodiscard]] std::vector<Region> regions() const noexcept override;
+    [[nodiscard]] std::vector<Region> query_regions(const RegionFilter& filter) const noexcept override;
+
+    // Implements IReadMemoryWithCacheHint.
+public:
+    /**
+     * @brief A value unique to each opened file, since the captured memory never changes.
+     * 0 if the object is empty.
+     */
+    [[nodiscard]] std::uint64_t get_cache_hint() const noexcept override {
+        return cache_hint;
+    }
+};
+
+MEMORY_READER_NAMESPACE_END
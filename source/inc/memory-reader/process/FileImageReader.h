@@ -0,0 +1,135 @@
+/**
+ * @file FileImageReader.h
+ * @author UnnamedOrange
+ * @brief Read a process, with the files of its executable regions mapped into the current process for scanning.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "../utils/macro.h"
+#include "IReadMemoryWithCacheHint.h"
+#include "Process.h"
+
+MEMORY_READER_NAMESPACE_BEGIN
+
+/**
+ * @brief Options of @ref FileImageReader.
+ */
+struct FileImageReaderOptions {
+    /**
+     * @brief If a signature scan finds nothing in the mapped files, scan the bytes they cover in the process too,
+     * in case the pattern only occurs where the process differs from the file, e.g. in patched code.
+     * Off by default, since every miss then reads all the covered bytes from the process.
+     */
+    bool scan_process_on_miss = false;
+};
+
+/**
+ * @brief Read a process, with the files backing its executable regions mapped into the current process.
+ *
+ * On construction and on @ref refresh, private executable regions backed by a file are mapped
+ * read-only from the very file the process mapped, through /proc/<pid>/map_files, or through the path
+ * under /proc/<pid>/root if its device and inode are still those of the region.
+ * So a file replaced on disk is never used.
+ *
+ * Reads always go to the process, because private pages may differ from the file,
+ * e.g. by relocations or patches. The mapped files are only used by signature scans
+ * (see @ref Signature), which scan them locally and verify each hit with a single read of the process.
+ * Signature scans only use the files if the reader is passed as a @ref FileImageReader, not through its base.
+ *
+ * Images are dropped from use once the cache hint of the process changes.
+ * If the process loads or unloads modules, call @ref refresh.
+ * Currently only Linux is supported. On other platforms, nothing is mapped, since the layout of
+ * a loaded image differs from that of its file.
+ */
+class FileImageReader final : public IReadMemoryWithCacheHint {
+    using Self = FileImageReader;
+
+public:
+    /**
+     * @brief The bytes of the file backing a region, mapped into the current process.
+     */
+    struct Image {
+        /**
+         * @brief Address of the region in the process.
+         */
+        std::uintptr_t base{};
+        /**
+         * @brief The number of bytes of the file in the region. Less than the size of the region
+         * if the file ends earlier.
+         */
+        std::size_t size{};
+        /**
+         * @brief Address in the current process.
+         */
+        const std::byte* data{};
+    };
+
+private:
+    const Process& process;
+    FileImageReaderOptions options;
+    std::vector<Image> images;
+    /**
+     * @brief The cache hint of the process when @ref images are made.
+     */
+    std::uint64_t mapped_cache_hint = 0;
+
+public:
+    /**
+     * @note @b process MUST have a longer life span than this object.
+     */
+    explicit FileImageReader(const Process& process, const FileImageReaderOptions& options = {});
+    FileImageReader(const Self&) = delete;
+    Self& operator=(const Self&) = delete;
+    FileImageReader(Self&&) = delete;
+    Self& operator=(Self&&) = delete;
+
+    ~FileImageReader();
+
+private:
+    void unmap_all() noexcept;
+
+public:
+    /**
+     * @brief Map the files of the executable regions of the process again.
+     *
+     * @note This method MUST NOT be called concurrently with scans.
+     */
+    void refresh();
+    [[nodiscard]] const FileImageReaderOptions& get_options() const noexcept {
+        return options;
+    }
+    /**
+     * @brief Mapped images, in ascending order of their addresses.
+     */
+    [[nodiscard]] std::span<const Image> get_images() const noexcept {
+        return images;
+    }
+    /**
+     * @brief Get the bytes of the file at [address, address + size), from @b address to the end of
+     * the image containing it, or to @b address + @b size if earlier.
+     * Empty if @b address is not in an image, or the images are no longer valid.
+     */
+    [[nodiscard]] std::span<const std::byte> find_image(std::uintptr_t address, std::size_t size) const noexcept;
+
+    // Implements IReadMemory.
+public:
+    [[nodiscard]] bool read_to_buf(std::uintptr_t address, void* buf, std::size_t size) const noexcept override;
+    std::size_t read_to_bufs(std::span<ReadRequest> requests) const noexcept override;
+    [[nodiscard]] std::vector<Region> regions() const noexcept override;
+    [[nodiscard]] std::vector<Region> query_regions(const RegionFilter& filter) const noexcept override;
+
+    // Implements IReadMemoryWithCacheHint.
+public:
+    [[nodiscard]] std::uint64_t get_cache_hint() const noexcept override;
+};
+
+MEMORY_READER_NAMESPACE_END
@@ -11,8 +11,12 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <optional>
+#include <span>
+#include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "../utils/macro.h"
@@ -45,9 +49,85 @@ enum class PtrWidth : std::size_t {
 template <PtrWidth width>
 using PtrType = std::conditional_t<width == PtrWidth::IS_32, std::uint32_t, std::uint64_t>;
 
+/**
+ * @brief Access permissions of a @ref Region. Can be combined with bitwise operators.
+ */
+enum class RegionProtection : std::uint8_t {
+    NONE = 0,
+    READ = 1 << 0,
+    WRITE = 1 << 1,
+    EXECUTE = 1 << 2,
+};
+constexpr RegionProtection operator|(RegionProtection lhs, RegionProtection rhs) noexcept {
+    return static_cast<RegionProtection>(static_cast<std::uint8_t>(lhs) | static_cast<std::uint8_t>(rhs));
+}
+constexpr RegionProtection operator&(RegionProtection lhs, RegionProtection rhs) noexcept {
+    return static_cast<RegionProtection>(static_cast<std::uint8_t>(lhs) & static_cast<std::uint8_t>(rhs));
+}
+
 struct Region {
     std::uintptr_t base;
     std::size_t size;
+    RegionProtection protection{};
+    /**
+     * @brief Path of the file backing the region, or a pseudo path like "[heap]".
+     * Empty if the region is anonymous or the platform does not tell.
+     */
+    std::string path{};
+};
+
+/**
+ * @brief Conditions of regions. Used in @ref IReadMemory::query_regions.
+ */
+struct RegionFilter {
+    /**
+     * @brief All of these permissions are required.
+     */
+    RegionProtection required = RegionProtection::READ;
+    /**
+     * @brief None of these permissions is allowed.
+     */
+    RegionProtection excluded = RegionProtection::NONE;
+    std::uintptr_t min_address = 0;
+    std::uintptr_t max_address = (std::numeric_limits<std::uintptr_t>::max)();
+    /**
+     * @brief Regions larger than this are skipped.
+     */
+    std::size_t max_size = (std::numeric_limits<std::size_t>::max)();
+    /**
+     * @brief If not empty, the path of the region must contain it.
+     */
+    std::string path_contains{};
+
+    [[nodiscard]] bool matches(const Region& region) const noexcept {
+        return (region.protection & required) == required &&               //
+               (region.protection & excluded) == RegionProtection::NONE && //
+               region.base >= min_address && region.base <= max_address && //
+               region.size <= max_size &&                                  //
+               (path_contains.empty() || region.path.find(path_contains) != std::string::npos);
+    }
+};
+
+/**
+ * @brief One read in a batch. Used in @ref IReadMemory::read_to_bufs.
+ */
+struct ReadRequest {
+    /**
+     * @brief Starting address in the to-be-read process.
+     */
+    std::uintptr_t address;
+    /**
+     * @brief The buffer to hold the reading result.
+     */
+    void* buf;
+    /**
+     * @brief The number of bytes to be read.
+     */
+    std::size_t size;
+    /**
+     * @brief Set by @ref IReadMemory::read_to_bufs to tell whether all bytes have been read.
+     */
+    bool ok = false;
 };
 
 /**
@@ -67,12 +147,45 @@ struct IReadMemory {
      * In this case @b buf may be polluted and the content inside should be discarded.
      */
     [[nodiscard]] virtual bool read_to_buf(std::uintptr_t address, void* buf, std::size_t size) const noexcept = 0;
+    /**
+     * @brief Read memory to multiple buffers at once.
+     * The default implementation calls @ref read_to_buf for each request.
+     * Implementations may override it to save system calls.
+     *
+     * @note This method should be reentrant.
+     *
+     * @param requests The requests. @ref ReadRequest::ok of each request is set accordingly.
+     * @return std::size_t The number of succeeded requests.
+     */
+    virtual std::size_t read_to_bufs(std::span<ReadRequest> requests) const noexcept {
+        std::size_t ret = 0;
+        for (auto& request : requests) {
+            request.ok = read_to_buf(request.address, request.buf, request.size);
+            ret += request.ok;
+        }
+        return ret;
+    }
     /**
      * @brief Get all regions with execution permission.
      *
      * @note This method should be reentrant.
      */
     [[nodiscard]] virtual std::vector<Region> regions() const noexcept = 0;
+    /**
+     * @brief Get all regions satisfying @b filter, regardless of execution permission.
+     * The default implementation can only filter the result of @ref regions.
+     *
+     * @note This method should be reentrant.
+     */
+    [[nodiscard]] virtual std::vector<Region> query_regions(const RegionFilter& filter) const noexcept {
+        std::vector<Region> ret;
+        for (auto& region : regions()) {
+            if (filter.matches(region)) {
+                ret.push_back(std::move(region));
+            }
+        }
+        return ret;
+    }
 
     /**
      * @brief Read memory and return a plain old data type.
@@ -10,6 +10,8 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include "../utils/macro.h"
 #include "IReadMemory.h"
 
@@ -25,10 +27,11 @@ struct IReadMemoryWithCacheHint : public IReadMemory {
      *
      * Once the return value is different from the one you stored before, your cache MUST be dropped.
      * Otherwise, it is up to you to decide whether to drop the cache.
+     * 0 means there is nothing to cache, e.g. no process is held.
      *
      * @note This method should be reentrant.
      */
-    [[nodiscard]] virtual int get_cache_hint() const noexcept = 0;
+    [[nodiscard]] virtual std::uint64_t get_cache_hint() const noexcept = 0;
 };
 
 MEMORY_READER_NAMESPACE_END
@@ -0,0 +1,110 @@
+/**
+ * @file MappedReader.h
+ * @author UnnamedOrange
+ * @brief Read shared memory of a process by mapping it into the current process.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "../utils/macro.h"
+#include "IReadMemoryWithCacheHint.h"
+#include "Process.h"
+
+MEMORY_READER_NAMESPACE_BEGIN
+
+/**
+ * @brief Read a process, with its shared memory regions mapped into the current process.
+ *
+ * On construction and on @ref refresh, readable shared regions backed by a shareable file,
+ * i.e. POSIX shared memory in /dev/shm and memfd, are mapped read-only through /proc/<pid>/map_files.
+ * If map_files is denied, e.g. without CAP_SYS_ADMIN, files in /dev/shm are opened by their paths
+ * under /proc/<pid>/root instead, as long as their devices and inodes still match. memfd cannot be mapped then.
+ * Reads within them are plain copies without system calls. Other reads go to the process.
+ *
+ * Mappings are dropped from use once the cache hint of the process changes.
+ * If the process unmaps or remaps a region, call @ref refresh.
+ * Currently only Linux is supported. On other platforms, nothing is mapped.
+ *
+ * @warning If the process shrinks a mapped file, reading beyond its new end raises SIGBUS.
+ */
+class MappedReader final : public IReadMemoryWithCacheHint {
+    using Self = MappedReader;
+
+public:
+    /**
+     * @brief A region of the process mapped into the current process.
+     */
+    struct Mapping {
+        /**
+         * @brief Address in the process.
+         */
+        std::uintptr_t base{};
+        std::size_t size{};
+        /**
+         * @brief Address in the current process.
+         */
+        const std::byte* data{};
+    };
+
+private:
+    const Process& process;
+    std::vector<Mapping> mappings;
+    /**
+     * @brief The cache hint of the process when @ref mappings are made.
+     */
+    std::uint64_t mapped_cache_hint = 0;
+
+public:
+    /**
+     * @note @b process MUST have a longer life span than this object.
+     */
+    explicit MappedReader(const Process& process);
+    MappedReader(const Self&) = delete;
+    Self& operator=(const Self&) = delete;
+    MappedReader(Self&&) = delete;
+    Self& operator=(Self&&) = delete;
+
+    ~MappedReader();
+
+private:
+    /**
+     * @brief Find the mapping containing [address, address + size), if the mappings are still valid.
+     */
+    [[nodiscard]] const Mapping* find(std::uintptr_t address, std::size_t size) const noexcept;
+    void unmap_all() noexcept;
+
+public:
+    /**
+     * @brief Map the shared regions of the process again.
+     *
+     * @note This method MUST NOT be called concurrently with reads.
+     */
+    void refresh();
+    /**
+     * @brief Mapped regions, in ascending order of their addresses.
+     */
+    [[nodiscard]] std::span<const Mapping> get_mappings() const noexcept {
+        return mappings;
+    }
+
+    // Implements IReadMemory.
+public:
+    [[nodiscard]] bool read_to_buf(std::uintptr_t address, void* buf, std::size_t size) const noexcept override;
+    std::size_t read_to_bufs(std::span<ReadRequest> requests) const noexcept override;
+    [[nodiscard]] std::vector<Region> regions() const noexcept override;
+    [[nodiscard]] std::vector<Region> query_regions(const RegionFilter& filter) const noexcept override;
+
+    // Implements IReadMemoryWithCacheHint.
+public:
+    [[nodiscard]] std::uint64_t get_cache_hint() const noexcept override;
+};
+
+MEMORY_READER_NAMESPACE_END
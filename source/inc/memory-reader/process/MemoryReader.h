@@ -0,0 +1,58 @@
+/**
+ * @file MemoryReader.h
+ * @author UnnamedOrange
+ * @brief Concepts of memory readers, for static dispatch on hot paths.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+
+#include "../utils/macro.h"
+#include "IReadMemory.h"
+
+MEMORY_READER_NAMESPACE_BEGIN
+
+/**
+ * @brief A type which can read memory like @ref IReadMemory::read_to_buf.
+ *
+ * Features reading through a template parameter satisfying this concept call the reader directly,
+ * so the call chain can be inlined for a concrete reader type.
+ * @ref IReadMemory itself satisfies it, and works as a type-erased reader.
+ */
+template <typename Reader>
+concept MemoryReader = requires(const Reader& reader, std::uintptr_t address, void* buf, std::size_t size) {
+    { reader.read_to_buf(address, buf, size) } noexcept -> std::convertible_to<bool>;
+};
+
+/**
+ * @brief Read memory and return a plain old data type. Same as @ref IReadMemory::read.
+ */
+template <typename T, MemoryReader Reader>
+    requires std::is_trivial_v<T> && std::is_standard_layout_v<T>
+inline std::optional<T> read_value(const Reader& reader, std::uintptr_t address) noexcept {
+    T buf;
+    if (!reader.read_to_buf(address, &buf, sizeof(T))) {
+        return std::nullopt;
+    }
+    return buf;
+}
+/**
+ * @brief Read a pointer in the to-be-read process. Same as @ref IReadMemory::read.
+ */
+template <PtrWidth width, MemoryReader Reader>
+inline std::optional<std::uintptr_t> read_pointer(const Reader& reader, std::uintptr_t address) noexcept {
+    static_assert(sizeof(uintptr_t) >= static_cast<std::size_t>(width), //
+                  "Width is not long enough on current platform.");
+    // PtrType<width> can be broadened as std::uintptr_t without warning.
+    return read_value<PtrType<width>>(reader, address);
+}
+
+MEMORY_READER_NAMESPACE_END
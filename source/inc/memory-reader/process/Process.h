@@ -65,15 +65,28 @@ public:
      */
     [[nodiscard]] static Self try_from_process_name(const std::string& process_name) noexcept;
 
+    /**
+     * @brief Get the ID of the process.
+     *
+     * @return std::uint32_t The PID. 0 if the process is empty.
+     */
+    [[nodiscard]] std::uint32_t pid() const noexcept;
+
     // Implements AbstractProcess.
 public:
     void reset() noexcept override;
     [[nodiscard]] bool empty() const noexcept override;
 
+protected:
+    [[nodiscard]] std::uint64_t identity() const noexcept override;
+
     // Implements IReadMemory.
+    // Marked final so that calls through Process are dispatched statically.
 public:
-    [[nodiscard]] bool read_to_buf(std::uintptr_t address, void* buf, std::size_t size) const noexcept override;
-    [[nodiscard]] std::vector<Region> regions() const noexcept override;
+    [[nodiscard]] bool read_to_buf(std::uintptr_t address, void* buf, std::size_t size) const noexcept final;
+    std::size_t read_to_bufs(std::span<ReadRequest> requests) const noexcept final;
+    [[nodiscard]] std::vector<Region> regions() const noexcept final;
+    [[nodiscard]] std::vector<Region> query_regions(const RegionFilter& filter) const noexcept final;
 
     // Implements IProcessAlive.
 public:
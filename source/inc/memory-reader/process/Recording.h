@@ -0,0 +1,305 @@
+/**
+ * @file Recording.h
+ * @author UnnamedOrange
+ * @brief Record the reads of a session to a file, and replay them without the process.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "../utils/macro.h"
+#include "IReadMemoryWithCacheHint.h"
+
+MEMORY_READER_NAMESPACE_BEGIN
+
+/**
+ * @brief Record every call to a reader, with the bytes returned, to an append-only file.
+ *
+ * Each record is stamped with the time the call completed and how long it took.
+ * Batches of @ref read_to_bufs are forwarded as a whole and recorded as one record.
+ * Cache hints are recorded only when they change. If the wrapped reader does not implement
+ * @ref IReadMemoryWithCacheHint, the cache hint is always 1.
+ *
+ * Load the file with @ref Recording and serve it back with @ref ReplayReader.
+ */
+class RecordingReader final : public IReadMemoryWithCacheHint {
+    using Self = RecordingReader;
+    using clock = std::chrono::steady_clock;
+
+private:
+    const IReadMemory& reader;
+    const IReadMemoryWithCacheHint* hinted_reader;
+    const clock::time_point started;
+
+    mutable std::mutex m_file;
+    mutable std::ofstream ofs;
+    /**
+     * @brief Time of the last record since @ref started, so that records only go forward.
+     */
+    mutable std::chrono::nanoseconds last_time{};
+    mutable std::optional<std::uint64_t> last_cache_hint;
+    mutable std::vector<std::byte> record;
+
+public:
+    /**
+     * @brief Start recording to @b path, truncating it.
+     *
+     * @note @b reader MUST have a longer life span than this object.
+     */
+    RecordingReader(const IReadMemory& reader, const std::filesystem::path& path);
+    RecordingReader(const Self&) = delete;
+    Self& operator=(const Self&) = delete;
+    RecordingReader(Self&&) = delete;
+    Self& operator=(Self&&) = delete;
+
+private:
+    /**
+     * @brief Start a record in @ref record. MUST be called with @ref m_file locked.
+     */
+    void begin_record(std::uint8_t tag, clock::time_point start) const;
+    /**
+     * @brief Write @ref record to the file. MUST be called with @ref m_file locked.
+     */
+    void commit_record() const;
+    void record_regions(const RegionFilter& filter, const std::vector<Region>& regions,
+                        clock::time_point start) const noexcept;
+
+public:
+    /**
+     * @brief Whether everything so far has been written.
+     */
+    [[nodiscard]] bool good() const noexcept;
+    /**
+     * @brief Flush written records to the file.
+     */
+    void flush() noexcept;
+
+    // Implements IReadMemory.
+public:
+    [[nodiscard]] bool read_to_buf(std::uintptr_t address, void* buf, std::size_t size) const noexcept override;
+    std::size_t read_to_bufs(std::span<ReadRequest> requests) const noexcept override;
+    [[nodiscard]] std::vector<Region> regions() const noexcept override;
+    [[nodiscard]] std::vector<Region> query_regions(const RegionFilter& filter) const noexcept override;
+
+    // Implements IReadMemoryWithCacheHint.
+public:
+    [[nodiscard]] std::uint64_t get_cache_hint() const noexcept override;
+};
+
+/**
+ * @brief Reads, regions and cache hints loaded from a file written by @ref RecordingReader.
+ */
+class Recording {
+    using Self = Recording;
+
+public:
+    /**
+     * @brief A recorded read.
+     */
+    struct Read {
+        /**
+         * @brief When the read completed, since the recording started.
+         */
+        std::chrono::nanoseconds time{};
+        std::uintptr_t address{};
+        std::size_t size{};
+        /**
+         * @brief Offset of the bytes read in the data pool. Only meaningful for succeeded reads.
+         */
+        std::size_t data_offset{};
+        bool ok{};
+    };
+    struct RegionList {
+        std::chrono::nanoseconds time{};
+        /**
+         * @brief The filter queried with. For @ref IReadMemory::regions, only readable and executable regions
+         * are required, which every implementation returns.
+         */
+        RegionFilter filter{};
+        std::vector<Region> regions{};
+    };
+    struct CacheHint {
+        std::chrono::nanoseconds time{};
+        std::uint64_t value{};
+    };
+
+private:
+    /**
+     * @brief Mean latency of calls, bucketed by batch or not, and by the bit width of the total size.
+     */
+    struct LatencyBucket {
+        std::chrono::nanoseconds total{};
+        std::size_t count{};
+    };
+    static constexpr std::size_t latency_buckets = 65;
+
+    std::vector<Read> read_list;
+    std::vector<std::byte> data_pool;
+    std::vector<RegionList> region_lists;
+    std::vector<CacheHint> cache_hints;
+    std::chrono::nanoseconds total_duration{};
+    /**
+     * @brief Indices of the succeeded reads touching each 4 KiB page, in order of time.
+     */
+    std::unordered_map<std::uintptr_t, std::vector<std::uint32_t>> page_index;
+    std::array<std::array<LatencyBucket, latency_buckets>, 2> latency_table{};
+
+public:
+    Recording() noexcept = default;
+
+    /**
+     * @brief Load a file written by @ref RecordingReader.
+     * A truncated file, e.g. from a session which crashed, is loaded up to its last complete record.
+     *
+     * @return std::optional<Recording> If the file is not a recording, return std::nullopt.
+     */
+    [[nodiscard]] static std::optional<Self> load(const std::filesystem::path& path) noexcept;
+
+private:
+    void add_read(Read read, std::span<const std::byte> data);
+
+public:
+    [[nodiscard]] const std::vector<Read>& reads() const noexcept {
+        return read_list;
+    }
+    /**
+     * @brief Get the bytes of a succeeded read.
+     */
+    [[nodiscard]] std::span<const std::byte> data(const Read& read) const noexcept {
+        return {data_pool.data() + read.data_offset, read.size};
+    }
+    /**
+     * @brief Time of the last record.
+     */
+    [[nodiscard]] std::chrono::nanoseconds duration() const noexcept {
+        return total_duration;
+    }
+
+    /**
+     * @brief Read memory as seen at @b position.
+     *
+     * Each byte comes from the last read covering it at or before @b position,
+     * or from the first read covering it after @b position if there is none.
+     *
+     * @return true Every byte has been read during the session.
+     * @return false Otherwise.
+     */
+    bool read_at(std::chrono::nanoseconds position, std::uintptr_t address, void* buf,
+                 std::size_t size) const noexcept;
+    /**
+     * @brief Regions as seen at @b position.
+     * Regions of all region records at or before @b position are merged by base, the later the preferred.
+     * A region is dropped by a later record whose filter matches it but which does not contain it.
+     * If there is no such record, the first one is used.
+     */
+    [[nodiscard]] std::vector<Region> regions_at(std::chrono::nanoseconds position) const noexcept;
+    /**
+     * @brief The cache hint at @b position, or the first one if there is none yet. 1 if none is recorded.
+     */
+    [[nodiscard]] std::uint64_t cache_hint_at(std::chrono::nanoseconds position) const noexcept;
+    /**
+     * @brief Mean latency of recorded calls of similar size. 0 if no such call is recorded.
+     *
+     * @param batch Whether the call is @ref IReadMemory::read_to_bufs.
+     * @param size The total number of bytes.
+     */
+    [[nodiscard]] std::chrono::nanoseconds latency(bool batch, std::size_t size) const noexcept;
+};
+
+/**
+ * @brief Options of @ref ReplayReader.
+ */
+struct ReplayOptions {
+    /**
+     * @brief How fast the replay position moves relative to the wall clock.
+     * If 0, the position only moves by @ref ReplayReader::seek.
+     */
+    double speed = 1.0;
+    /**
+     * @brief Make each read take as long as similar reads took when recorded.
+     */
+    bool simulate_latency = true;
+};
+
+/**
+ * @brief Serve a @ref Recording as if the process was read, with the timing of the session.
+ *
+ * The memory seen at any moment is that recorded at the replay position, see @ref Recording::read_at.
+ * So reads need not be issued in the recorded order, and features reading differently from the
+ * recorded session, e.g. with another cache, can be benchmarked against the same session.
+ */
+class ReplayReader final : public IReadMemoryWithCacheHint {
+    using Self = ReplayReader;
+    using clock = std::chrono::steady_clock;
+
+private:
+    const Recording& recording;
+    ReplayOptions options;
+    /**
+     * @brief Wall clock ticks at replay position 0, if @ref ReplayOptions::speed is not 0.
+     */
+    std::atomic<std::int64_t> origin;
+    /**
+     * @brief The replay position in nanoseconds, if @ref ReplayOptions::speed is 0.
+     */
+    std::atomic<std::int64_t> manual_position{};
+
+public:
+    /**
+     * @brief Start replaying from position 0.
+     *
+     * @note @b recording MUST have a longer life span than this object.
+     */
+    explicit ReplayReader(const Recording& recording, const ReplayOptions& options = {}) noexcept;
+    ReplayReader(const Self&) = delete;
+    Self& operator=(const Self&) = delete;
+    ReplayReader(Self&&) = delete;
+    Self& operator=(Self&&) = delete;
+
+private:
+    void simulate_latency(bool batch, std::size_t size, clock::time_point start) const noexcept;
+
+public:
+    /**
+     * @brief The current replay position, since the recording started.
+     */
+    [[nodiscard]] std::chrono::nanoseconds position() const noexcept;
+    /**
+     * @brief Move the replay position. It keeps moving from there unless the speed is 0.
+     */
+    void seek(std::chrono::nanoseconds position) noexcept;
+    /**
+     * @brief Whether the replay position has passed the end of the recording.
+     */
+    [[nodiscard]] bool finished() const noexcept {
+        return position() >= recording.duration();
+    }
+
+    // Implements IReadMemory.
+public:
+    [[nodiscard]] bool read_to_buf(std::uintptr_t address, void* buf, std::size_t size) const noexcept override;
+    std::size_t read_to_bufs(std::span<ReadRequest> requests) const noexcept override;
+    [[nodiscard]] std::vector<Region> regions() const noexcept override;
+    [[nodiscard]] std::vector<Region> query_regions(const RegionFilter& filter) const noexcept override;
+
+    // Implements IReadMemoryWithCacheHint.
+public:
+    [[nodiscard]] std::uint64_t get_cache_hint() const noexcept override;
+};
+
+MEMORY_READER_NAMESPACE_END
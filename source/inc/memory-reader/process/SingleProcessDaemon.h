@@ -59,11 +59,13 @@ public:
     // Implements IReadMemory.
 public:
     [[nodiscard]] bool read_to_buf(std::uintptr_t address, void* buf, std::size_t size) const noexcept override;
+    std::size_t read_to_bufs(std::span<ReadRequest> requests) const noexcept override;
     [[nodiscard]] std::vector<Region> regions() const noexcept override;
+    [[nodiscard]] std::vector<Region> query_regions(const RegionFilter& filter) const noexcept override;
 
     // Implements IReadMemoryWithCacheHint.
 public:
-    [[nodiscard]] int get_cache_hint() const noexcept override;
+    [[nodiscard]] std::uint64_t get_cache_hint() const noexcept override;
 
 public:
     /**
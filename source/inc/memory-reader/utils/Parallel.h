@@ -0,0 +1,60 @@
+/**
+ * @file Parallel.h
+ * @author UnnamedOrange
+ * @brief Split work into contiguous shares run on multiple threads.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "macro.h"
+
+MEMORY_READER_NAMESPACE_BEGIN
+
+/**
+ * @brief Resolve a thread count in options, where 0 means the number of hardware threads.
+ */
+inline std::size_t resolve_thread_count(std::size_t threads) noexcept {
+    return threads ? threads : (std::max)(1u, std::thread::hardware_concurrency());
+}
+
+/**
+ * @brief Split [0, @b count) into at most @b threads contiguous shares,
+ * and call @b func(begin, end, share_index) for each share on its own thread.
+ * Shares are in order, so results collected per share can be concatenated in order.
+ *
+ * If there is only one share, @b func is called on the current thread.
+ * Otherwise, @b init() is called first on each new thread, e.g. to lower its priority.
+ */
+template <typename Func, typename Init>
+void parallel_shares(std::size_t count, std::size_t threads, Func&& func, Init&& init) {
+    threads = (std::max)(std::size_t{1}, (std::min)(threads, count));
+    if (threads == 1) {
+        func(std::size_t{0}, count, std::size_t{0});
+        return;
+    }
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            init();
+            func(count * t / threads, count * (t + 1) / threads, t);
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+template <typename Func>
+void parallel_shares(std::size_t count, std::size_t threads, Func&& func) {
+    parallel_shares(count, threads, std::forward<Func>(func), [] {});
+}
+
+MEMORY_READER_NAMESPACE_END
@@ -0,0 +1,132 @@
+/**
+ * @file RingBuffer.h
+ * @author UnnamedOrange
+ * @brief Lock-free ring buffer for a single producer and a single consumer.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+#include "macro.h"
+
+MEMORY_READER_NAMESPACE_BEGIN
+
+/**
+ * @brief Lock-free ring buffer for a single producer and a single consumer.
+ *
+ * All slots are allocated on construction, so neither side allocates afterwards.
+ * The producer may write into a slot in place by @ref try_reserve and @ref commit.
+ *
+ * @tparam T Type of the elements.
+ */
+template <typename T>
+    requires std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>
+class SpscRingBuffer {
+    using Self = SpscRingBuffer;
+
+private:
+    /**
+     * @brief Keep the indices on different cache lines to avoid false sharing.
+     */
+    static constexpr std::size_t cache_line_size = 64;
+
+    std::size_t mask;
+    std::unique_ptr<T[]> slots;
+    alignas(cache_line_size) std::atomic<std::size_t> head{}; // Written by the consumer.
+    alignas(cache_line_size) std::atomic<std::size_t> tail{}; // Written by the producer.
+
+public:
+    /**
+     * @param capacity The minimum number of elements. It is rounded up to a power of 2.
+     */
+    explicit SpscRingBuffer(std::size_t capacity)
+        : mask(std::bit_ceil((std::max)(capacity, std::size_t{1})) - 1), slots(std::make_unique<T[]>(mask + 1)) {}
+    SpscRingBuffer(const Self&) = delete;
+    Self& operator=(const Self&) = delete;
+    SpscRingBuffer(Self&&) = delete;
+    Self& operator=(Self&&) = delete;
+
+public:
+    std::size_t capacity() const noexcept {
+        return mask + 1;
+    }
+    /**
+     * @brief Return the number of elements. It is only a snapshot if called concurrently.
+     */
+    std::size_t size() const noexcept {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+    // Producer side.
+public:
+    /**
+     * @brief Get the slot to be written next, or nullptr if the buffer is full.
+     * The slot is not visible to the consumer until @ref commit is called.
+     */
+    T* try_reserve() noexcept {
+        auto crt_tail = tail.load(std::memory_order_relaxed);
+        if (crt_tail - head.load(std::memory_order_acquire) > mask) {
+            return nullptr;
+        }
+        return &slots[crt_tail & mask];
+    }
+    /**
+     * @brief Publish the slot returned by @ref try_reserve.
+     */
+    void commit() noexcept {
+        tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+    /**
+     * @brief Push an element. Return false if the buffer is full.
+     */
+    bool try_push(const T& value) noexcept {
+        auto slot = try_reserve();
+        if (!slot) {
+            return false;
+        }
+        *slot = value;
+        commit();
+        return true;
+    }
+
+    // Consumer side.
+public:
+    /**
+     * @brief Pop an element into @b out. Return false if the buffer is empty.
+     */
+    bool try_pop(T& out) noexcept {
+        auto crt_head = head.load(std::memory_order_relaxed);
+        if (crt_head == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        out = slots[crt_head & mask];
+        head.store(crt_head + 1, std::memory_order_release);
+        return true;
+    }
+    /**
+     * @brief Call @b func with each element available now, and pop them.
+     *
+     * @return std::size_t The number of elements popped.
+     */
+    template <typename Func>
+    std::size_t drain(Func&& func) {
+        auto crt_head = head.load(std::memory_order_relaxed);
+        auto crt_tail = tail.load(std::memory_order_acquire);
+        for (auto i = crt_head; i != crt_tail; i++) {
+            func(static_cast<const T&>(slots[i & mask]));
+        }
+        head.store(crt_tail, std::memory_order_release);
+        return crt_tail - crt_head;
+    }
+};
+
+MEMORY_READER_NAMESPACE_END
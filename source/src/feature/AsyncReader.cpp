@@ -0,0 +1,84 @@
+/**
+ * @file AsyncReader.cpp
+ * @author UnnamedOrange
+ * @brief Read memory asynchronously with coroutines, batching concurrent reads.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include "feature/AsyncReader.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "utils/macro.h"
+
+USING_MEMORY_READER_NAMESPACE;
+
+using Self = AsyncReader;
+
+Self::AsyncReader(const IReadMemory& reader, AsyncReaderOptions options) : reader(reader), options(std::move(options)) {
+    this->options.threads = (std::max)(std::size_t{1}, this->options.threads);
+    this->options.max_batch = (std::max)(std::size_t{1}, this->options.max_batch);
+    for (std::size_t i = 0; i < this->options.threads; i++) {
+        workers.emplace_back(&Self::worker_routine, this);
+    }
+}
+
+Self::~AsyncReader() {
+    if (std::lock_guard _(m_queue); true) {
+        should_exit = true;
+    }
+    cv_queue.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void Self::submit(Operation& operation) {
+    if (std::lock_guard _(m_queue); true) {
+        queue.push_back(&operation);
+    }
+    cv_queue.notify_one();
+}
+
+void Self::worker_routine() {
+    std::vector<Operation*> batch;
+    std::vector<ReadRequest> requests;
+    std::vector<std::coroutine_handle<>> handles;
+
+    while (true) {
+        batch.clear();
+        if (std::unique_lock lock(m_queue); true) {
+            cv_queue.wait(lock, [this] { return should_exit || !queue.empty(); });
+            // Queued reads are completed even on exit, so no coroutine is left suspended.
+            if (queue.empty()) {
+                return;
+            }
+            const auto count = (std::min)(options.max_batch, queue.size());
+            batch.assign(queue.begin(), queue.begin() + static_cast<std::ptrdiff_t>(count));
+            queue.erase(queue.begin(), queue.begin() + static_cast<std::ptrdiff_t>(count));
+        }
+
+        requests.clear();
+        for (const auto operation : batch) {
+            requests.push_back(operation->request);
+        }
+        reader.read_to_bufs(requests);
+
+        // A resumed coroutine may destroy its operation, so take all handles first.
+        handles.clear();
+        for (std::size_t i = 0; i < batch.size(); i++) {
+            batch[i]->request.ok = requests[i].ok;
+            handles.push_back(batch[i]->handle);
+        }
+        for (auto handle : handles) {
+            if (options.resume) {
+                options.resume(handle);
+            } else {
+                handle.resume();
+            }
+        }
+    }
+}
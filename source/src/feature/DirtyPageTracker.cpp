@@ -0,0 +1,28 @@
+/**
+ * @file DirtyPageTracker.cpp
+ * @author UnnamedOrange
+ * @brief Find pages of a process written since a checkpoint, by soft-dirty bits.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include "feature/DirtyPageTracker.h"
+
+#include "utils/macro.h"
+
+USING_MEMORY_READER_NAMESPACE;
+
+using Self = DirtyPageTracker;
+
+Self::DirtyPageTracker(const Process& process) noexcept
+    : process(process), system_page_size(query_page_size()), is_supported(probe_support()) {}
+
+std::optional<std::vector<ChangedRange>> Self::dirty_ranges(const Snapshot& snapshot) const {
+    std::vector<Region> regions;
+    regions.reserve(snapshot.regions().size());
+    for (const auto& entry : snapshot.regions()) {
+        regions.push_back(entry.region);
+    }
+    return dirty_ranges(regions);
+}
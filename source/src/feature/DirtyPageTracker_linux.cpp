@@ -0,0 +1,135 @@
+/**
+ * @file DirtyPageTracker_linux.cpp
+ * @author UnnamedOrange
+ * @brief Implement @ref DirtyPageTracker on Linux by soft-dirty bits.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#ifdef MEMORY_READER_TARGET_PLATFORM_LINUX
+
+#include "feature/DirtyPageTracker.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "utils/macro.h"
+
+USING_MEMORY_READER_NAMESPACE;
+
+using Self = DirtyPageTracker;
+
+/**
+ * @brief Bit of a pagemap entry set if the page is soft-dirty.
+ */
+static constexpr std::uint64_t pagemap_soft_dirty = std::uint64_t{1} << 55;
+/**
+ * @brief Pagemap entries are read in chunks of this many.
+ */
+static constexpr std::size_t entries_per_chunk = 4096;
+
+static int open_proc_file(std::uint32_t pid, const char* name, int flags) noexcept {
+    std::array<char, 64> path;
+    std::snprintf(path.data(), path.size(), "/proc/%u/%s", static_cast<unsigned>(pid), name);
+    return open(path.data(), flags | O_CLOEXEC);
+}
+
+bool Self::probe_support() noexcept {
+    // A page faulted in is soft-dirty until the bits are cleared, if the kernel tracks them at all.
+    const auto page_size = query_page_size();
+    void* page = mmap(nullptr, page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (page == MAP_FAILED)
+        return false;
+    *static_cast<volatile unsigned char*>(page) = 1;
+
+    bool ret = false;
+    int fd = open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC);
+    if (fd != -1) {
+        std::uint64_t entry = 0;
+        const auto offset = static_cast<off_t>(reinterpret_cast<std::uintptr_t>(page) / page_size * sizeof(entry));
+        ret = pread(fd, &entry, sizeof(entry), offset) == static_cast<ssize_t>(sizeof(entry)) &&
+              (entry & pagemap_soft_dirty);
+        close(fd);
+    }
+    munmap(page, page_size);
+    return ret;
+}
+std::size_t Self::query_page_size() noexcept {
+    const auto ret = sysconf(_SC_PAGESIZE);
+    return ret > 0 ? static_cast<std::size_t>(ret) : Snapshot::page_size;
+}
+
+bool Self::checkpoint() noexcept {
+    checkpoint_cache_hint.reset();
+    const auto pid = process.pid();
+    if (!is_supported || !pid)
+        return false;
+
+    // Take the cache hint first, so that a process replaced meanwhile is detected by dirty_ranges.
+    const auto cache_hint = process.get_cache_hint();
+    int fd = open_proc_file(pid, "clear_refs", O_WRONLY);
+    if (fd == -1)
+        return false;
+    // "4" clears the soft-dirty bits of all pages.
+    const bool ok = write(fd, "4", 1) == 1;
+    close(fd);
+    if (ok)
+        checkpoint_cache_hint = cache_hint;
+    return ok;
+}
+
+std::optional<std::vector<ChangedRange>> Self::dirty_ranges(std::span<const Region> regions) const {
+    if (!checkpoint_cache_hint || process.get_cache_hint() != *checkpoint_cache_hint)
+        return std::nullopt;
+    int fd = open_proc_file(process.pid(), "pagemap", O_RDONLY);
+    if (fd == -1)
+        return std::nullopt;
+
+    std::vector<ChangedRange> ret;
+    std::vector<std::uint64_t> entries(entries_per_chunk);
+    bool ok = true;
+    for (const auto& region : regions) {
+        const auto first_page = region.base / system_page_size;
+        const auto end_page = (region.base + region.size + system_page_size - 1) / system_page_size;
+        for (auto page = first_page; ok && page < end_page; page += entries_per_chunk) {
+            const auto count = (std::min)(entries_per_chunk, end_page - page);
+            const auto size = count * sizeof(std::uint64_t);
+            const auto offset = static_cast<off_t>(page * sizeof(std::uint64_t));
+            if (pread(fd, entries.data(), size, offset) != static_cast<ssize_t>(size)) {
+                ok = false;
+                break;
+            }
+            for (std::size_t i = 0; i < count; i++) {
+                if (!(entries[i] & pagemap_soft_dirty))
+                    continue;
+                const auto address = (page + i) * system_page_size;
+                if (!ret.empty() && ret.back().address + ret.back().size == address)
+                    ret.back().size += system_page_size;
+                else
+                    ret.push_back(ChangedRange{.address = address, .size = system_page_size});
+            }
+        }
+    }
+    close(fd);
+    if (!ok)
+        return std::nullopt;
+
+    // Regions may be given in any order.
+    std::ranges::sort(ret, {}, &ChangedRange::address);
+    std::vector<ChangedRange> merged;
+    for (const auto& range : ret) {
+        if (!merged.empty() && merged.back().address + merged.back().size >= range.address)
+            merged.back().size = (std::max)(merged.back().size, range.address + range.size - merged.back().address);
+        else
+            merged.push_back(range);
+    }
+    return merged;
+}
+
+#endif
@@ -0,0 +1,41 @@
+/**
+ * @file DirtyPageTracker_windows.cpp
+ * @author UnnamedOrange
+ * @brief Implement @ref DirtyPageTracker on Windows.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#ifdef MEMORY_READER_TARGET_PLATFORM_WIN32
+
+#include "feature/DirtyPageTracker.h"
+
+#include <Windows.h>
+
+#include "utils/macro.h"
+
+USING_MEMORY_READER_NAMESPACE;
+
+using Self = DirtyPageTracker;
+
+bool Self::probe_support() noexcept {
+    // Write watches only work for memory allocated with MEM_WRITE_WATCH by the process itself.
+    return false;
+}
+std::size_t Self::query_page_size() noexcept {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwPageSize;
+}
+
+bool Self::checkpoint() noexcept {
+    checkpoint_cache_hint.reset();
+    return false;
+}
+
+std::optional<std::vector<ChangedRange>> Self::dirty_ranges(std::span<const Region>) const {
+    return std::nullopt;
+}
+
+#endif
@@ -0,0 +1,197 @@
+/**
+ * @file PatternIndex.cpp
+ * @author UnnamedOrange
+ * @brief Answer many pattern lookups on unchanged regions from a q-gram index.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include "feature/PatternIndex.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+
+#include "feature/RegionReader.h"
+#include "utils/macro.h"
+
+USING_MEMORY_READER_NAMESPACE;
+
+namespace {
+    constexpr std::size_t max_indexed_size = (std::numeric_limits<std::uint32_t>::max)();
+    constexpr unsigned min_bucket_bits = 10;
+    constexpr unsigned max_bucket_bits = 24;
+
+    std::uint32_t load_gram(const std::byte* data) noexcept {
+        std::uint32_t ret;
+        std::memcpy(&ret, data, sizeof(ret));
+        return ret;
+    }
+} // namespace
+
+using Self = PatternIndex;
+
+Self Self::build(const IReadMemory& reader, const PatternIndexOptions& options) {
+    Self ret;
+    ret.stride = (std::max)(options.stride, std::size_t{1});
+
+    auto regions = reader.query_regions(options.filter);
+    std::ranges::sort(regions, {}, &Region::base);
+    RegionReader region_reader(reader, split_regions(regions),
+                               RegionReaderOptions{.read_ahead = 1, .scheduler = options.scheduler});
+    std::size_t region_index = 0;
+    while (auto view = region_reader.next()) {
+        const auto& chunk = view->chunk;
+        if (ret.bytes.size() + chunk.size > max_indexed_size) {
+            break;
+        }
+        while (chunk.address >= regions[region_index].base + regions[region_index].size) {
+            region_index++;
+        }
+        // Matches do not cross regions, nor chunks which could not be read.
+        auto& images = ret.images;
+        if (images.empty() || chunk.address == regions[region_index].base ||
+            images.back().address + images.back().size != chunk.address) {
+            images.push_back(Image{.address = chunk.address, .size = 0, .offset = ret.bytes.size()});
+        }
+        images.back().size += chunk.size;
+        ret.bytes.insert(ret.bytes.end(), view->data.begin(), view->data.begin() + chunk.size);
+    }
+
+    // Grams are counted first, so that the posting lists can be filled in place.
+    auto for_each_gram = [&](auto&& func) {
+        for (const auto& image : ret.images) {
+            if (image.size < gram_size) {
+                continue;
+            }
+            const auto first = (image.offset + ret.stride - 1) / ret.stride * ret.stride;
+            for (auto position = first; position + gram_size <= image.offset + image.size; position += ret.stride) {
+                func(position);
+            }
+        }
+    };
+    std::size_t gram_count = 0;
+    for_each_gram([&](std::size_t) { gram_count++; });
+    ret.bucket_bits = std::clamp(static_cast<unsigned>(std::bit_width(gram_count / 2)), min_bucket_bits,
+                                 max_bucket_bits);
+    ret.bucket_starts.assign((std::size_t{1} << ret.bucket_bits) + 1, 0);
+    for_each_gram([&](std::size_t position) {
+        ret.bucket_starts[ret.bucket_of(load_gram(ret.bytes.data() + position)) + 1]++;
+    });
+    for (std::size_t b = 1; b < ret.bucket_starts.size(); b++) {
+        ret.bucket_starts[b] += ret.bucket_starts[b - 1];
+    }
+    ret.positions.resize(gram_count);
+    std::vector<std::uint32_t> cursors(ret.bucket_starts.begin(), ret.bucket_starts.end() - 1);
+    for_each_gram([&](std::size_t position) {
+        ret.positions[cursors[ret.bucket_of(load_gram(ret.bytes.data() + position))]++] =
+            static_cast<std::uint32_t>(position);
+    });
+    return ret;
+}
+
+std::span<const std::uint32_t> Self::postings(std::uint32_t gram) const noexcept {
+    if (bucket_starts.empty()) {
+        return {};
+    }
+    const auto bucket = bucket_of(gram);
+    return std::span<const std::uint32_t>(positions).subspan(bucket_starts[bucket],
+                                                             bucket_starts[bucket + 1] - bucket_starts[bucket]);
+}
+
+std::vector<std::uintptr_t> Self::find_all_impl(const CompiledPattern& pattern,
+                                                std::span<const __detail::FixedRun> runs,
+                                                std::size_t max_count) const {
+    std::vector<std::uintptr_t> ret;
+    if (!max_count) {
+        return ret;
+    }
+
+    // A window of stride consecutive grams contains exactly one indexed gram of each match.
+    const auto window = gram_size + stride - 1;
+    const __detail::FixedRun* best_run = nullptr;
+    std::size_t best_start = 0;
+    std::size_t best_cost = SIZE_MAX;
+    for (const auto& run : runs) {
+        for (std::size_t start = 0; start + window <= run.bytes.size(); start++) {
+            std::size_t cost = 0;
+            for (std::size_t j = 0; j < stride; j++) {
+                cost += postings(load_gram(run.bytes.data() + start + j)).size();
+            }
+            if (cost < best_cost) {
+                best_run = &run;
+                best_start = start;
+                best_cost = cost;
+            }
+        }
+    }
+
+    if (!best_run) {
+        for (const auto& image : images) {
+            const std::span<const std::byte> data(bytes.data() + image.offset, image.size);
+            auto match = pattern.find(data, 0, data.size());
+            while (match) {
+                ret.push_back(image.address + *match);
+                if (ret.size() >= max_count) {
+                    return ret;
+                }
+                match = pattern.find(data, *match + 1, data.size());
+            }
+        }
+        return ret;
+    }
+
+    std::vector<std::size_t> candidates;
+    candidates.reserve(best_cost);
+    for (std::size_t j = 0; j < stride; j++) {
+        const auto gram_offset = best_run->offset + best_start + j;
+        for (auto position : postings(load_gram(best_run->bytes.data() + best_start + j))) {
+            if (position >= gram_offset) {
+                candidates.push_back(position - gram_offset);
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    for (auto candidate : candidates) {
+        auto image = std::upper_bound(images.begin(), images.end(), candidate,
+                                      [](std::size_t lhs, const Image& rhs) { return lhs < rhs.offset; });
+        if (image == images.begin()) {
+            continue;
+        }
+        --image;
+        if (candidate + pattern.size() > image->offset + image->size || !pattern.match(bytes.data() + candidate)) {
+            continue;
+        }
+        ret.push_back(image->address + (candidate - image->offset));
+        if (ret.size() >= max_count) {
+            break;
+        }
+    }
+    return ret;
+}
+
+bool Self::read_to_buf(std::uintptr_t address, void* buf, std::size_t size) const noexcept {
+    auto out = static_cast<std::byte*>(buf);
+    while (size) {
+        auto image = std::upper_bound(images.begin(), images.end(), address,
+                                      [](std::uintptr_t lhs, const Image& rhs) { return lhs < rhs.address; });
+        if (image == images.begin()) {
+            return false;
+        }
+        --image;
+        const auto offset = address - image->address;
+        if (offset >= image->size) {
+            return false;
+        }
+        const auto count = (std::min)(size, image->size - offset);
+        std::memcpy(out, bytes.data() + image->offset + offset, count);
+        out += count;
+        address += count;
+        size -= count;
+    }
+    return true;
+}
@@ -0,0 +1,240 @@
+/**
+ * @file PointerScanner.cpp
+ * @author UnnamedOrange
+ * @brief Find chains of pointers from static bases to an address.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include "feature/PointerScanner.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+
+#include "feature/RegionReader.h"
+#include "utils/Parallel.h"
+#include "utils/macro.h"
+
+USING_MEMORY_READER_NAMESPACE;
+
+namespace {
+    std::uintptr_t load_pointer(const std::byte* data, std::size_t width) noexcept {
+        if (width == sizeof(std::uint32_t)) {
+            std::uint32_t ret;
+            std::memcpy(&ret, data, sizeof(ret));
+            return ret;
+        }
+        std::uint64_t ret;
+        std::memcpy(&ret, data, sizeof(ret));
+        return static_cast<std::uintptr_t>(ret);
+    }
+
+    bool entry_less(const PointerEntry& lhs, const PointerEntry& rhs) noexcept {
+        return lhs.value != rhs.value ? lhs.value < rhs.value : lhs.address < rhs.address;
+    }
+
+    void append_hex(std::string& out, std::intptr_t value) {
+        auto magnitude = static_cast<std::uintptr_t>(value);
+        if (value < 0) {
+            out += '-';
+            magnitude = 0 - magnitude;
+        }
+        char buf[2 * sizeof(std::uintptr_t)];
+        auto [end, _] = std::to_chars(std::begin(buf), std::end(buf), magnitude, 16);
+        out += "0x";
+        out.append(buf, end);
+    }
+
+    bool is_file_backed(const Region& region) noexcept {
+        return !region.path.empty() && region.path.front() != '[';
+    }
+} // namespace
+
+PointerMap PointerMap::build(const IReadMemory& reader, const PointerScanOptions& options) {
+    const auto width = static_cast<std::size_t>(options.width);
+    const auto alignment = options.alignment ? options.alignment : width;
+    auto regions = reader.query_regions(options.filter);
+    std::sort(regions.begin(), regions.end(), [](const Region& lhs, const Region& rhs) { return lhs.base < rhs.base; });
+    if (regions.empty()) {
+        return {};
+    }
+
+    const auto min_value = regions.front().base;
+    const auto max_value = regions.back().base + regions.back().size;
+    auto is_valid = [&](std::uintptr_t value) {
+        if (value < min_value || value >= max_value) {
+            return false;
+        }
+        auto it = std::upper_bound(regions.begin(), regions.end(), value,
+                                   [](std::uintptr_t v, const Region& region) { return v < region.base; });
+        return it != regions.begin() && value - std::prev(it)->base < std::prev(it)->size;
+    };
+
+    // Keep pointers from crossing chunks.
+    const auto chunk_size = (std::max)(alignment, (std::size_t{1} << 20) / alignment * alignment);
+    auto chunks = split_regions(regions, RegionReaderOptions{.chunk_size = chunk_size, .overlap = 0});
+    const auto threads = resolve_thread_count(options.threads);
+    std::vector<std::vector<PointerEntry>> runs(threads);
+    auto share = [&](std::size_t begin, std::size_t end, std::size_t t) {
+        const RegionReaderOptions reader_options{.read_ahead = options.read_ahead, .scheduler = options.scheduler};
+        RegionReader region_reader(reader, {chunks.begin() + begin, chunks.begin() + end}, reader_options);
+        auto& run = runs[t];
+        while (auto view = region_reader.next()) {
+            const auto data = view->data;
+            for (std::size_t offset = 0; offset + width <= data.size(); offset += alignment) {
+                auto value = load_pointer(data.data() + offset, width);
+                if (is_valid(value)) {
+                    run.push_back(PointerEntry{.value = value, .address = view->chunk.address + offset});
+                }
+            }
+        }
+        std::sort(run.begin(), run.end(), entry_less);
+    };
+    parallel_shares(chunks.size(), threads, share, [&] {
+        if (options.scheduler) {
+            options.scheduler->lower_current_thread();
+        }
+    });
+
+    PointerMap ret;
+    std::size_t total = 0;
+    for (const auto& run : runs) {
+        total += run.size();
+    }
+    ret.entries.reserve(total);
+    for (auto& run : runs) {
+        auto middle = ret.entries.insert(ret.entries.end(), run.begin(), run.end());
+        std::inplace_merge(ret.entries.begin(), middle, ret.entries.end(), entry_less);
+        std::vector<PointerEntry>().swap(run);
+    }
+    return ret;
+}
+
+std::span<const PointerEntry> PointerMap::find(std::uintptr_t min_value, std::uintptr_t max_value) const noexcept {
+    auto first = std::lower_bound(entries.begin(), entries.end(), min_value,
+                                  [](const PointerEntry& entry, std::uintptr_t v) { return entry.value < v; });
+    auto last = std::upper_bound(first, entries.end(), max_value,
+                                 [](std::uintptr_t v, const PointerEntry& entry) { return v < entry.value; });
+    return {first, last};
+}
+
+std::optional<std::uintptr_t> PointerPath::resolve(const IReadMemory& reader, PtrWidth width) const noexcept {
+    if (offsets.empty()) {
+        return std::nullopt;
+    }
+    auto address = module_base;
+    for (std::size_t i = 0; i + 1 < offsets.size(); i++) {
+        address += static_cast<std::uintptr_t>(offsets[i]);
+        auto next = width == PtrWidth::IS_32 ? reader.read<PtrWidth::IS_32>(address)
+                                             : reader.read<PtrWidth::IS_64>(address);
+        if (!next) {
+            return std::nullopt;
+        }
+        address = *next;
+    }
+    return address + static_cast<std::uintptr_t>(offsets.back());
+}
+
+std::string PointerPath::declaration(PtrWidth width, std::string_view type_name) const {
+    std::string ret = "ValueOffsets<PtrWidth::";
+    ret += width == PtrWidth::IS_32 ? "IS_32" : "IS_64";
+    ret += ", ";
+    ret += type_name;
+    for (auto offset : offsets) {
+        ret += ", ";
+        append_hex(ret, offset);
+    }
+    return ret + ">";
+}
+
+using Self = PointerScanner;
+
+Self::PointerScanner(const IReadMemory& reader, const PointerScanOptions& options)
+    : options(options), map(PointerMap::build(reader, options)) {
+    auto regions = reader.query_regions(RegionFilter{.required = RegionProtection::NONE});
+    std::sort(regions.begin(), regions.end(), [](const Region& lhs, const Region& rhs) { return lhs.base < rhs.base; });
+    // Files mapped without any executable region are data, e.g. fonts, rather than images of modules.
+    std::unordered_set<std::string_view> images;
+    for (const auto& region : regions) {
+        if (is_file_backed(region) && (region.protection & RegionProtection::EXECUTE) != RegionProtection::NONE) {
+            images.insert(region.path);
+        }
+    }
+    for (const auto& region : regions) {
+        const auto end = region.base + region.size;
+        if (is_file_backed(region) && images.contains(region.path)) {
+            // The first region of a module is where it is loaded.
+            auto it = std::find_if(modules.begin(), modules.end(),
+                                   [&](const Module& module) { return module.path == region.path; });
+            auto base = it == modules.end() ? region.base : it->base;
+            modules.push_back(Module{.begin = region.base, .end = end, .base = base, .path = region.path});
+        } else if (region.path.empty() && !modules.empty() && modules.back().end == region.base) {
+            // Uninitialized data of a module lives in the anonymous region right after its image.
+            modules.push_back(Module{
+                .begin = region.base,
+                .end = end,
+                .base = modules.back().base,
+                .path = modules.back().path,
+            });
+        }
+    }
+}
+
+const Self::Module* Self::find_module(std::uintptr_t address) const noexcept {
+    auto it = std::upper_bound(modules.begin(), modules.end(), address,
+                               [](std::uintptr_t a, const Module& module) { return a < module.begin; });
+    if (it == modules.begin() || address >= std::prev(it)->end) {
+        return nullptr;
+    }
+    return &*std::prev(it);
+}
+
+std::vector<PointerPath> Self::scan(std::uintptr_t target) const {
+    struct Node {
+        std::uintptr_t address;
+        std::size_t parent;
+        std::intptr_t offset;
+    };
+    constexpr auto no_parent = SIZE_MAX;
+
+    std::vector<PointerPath> ret;
+    std::vector<Node> nodes{Node{.address = target, .parent = no_parent, .offset = 0}};
+    std::unordered_set<std::uintptr_t> visited{target};
+    std::size_t level_begin = 0;
+    for (std::size_t depth = 1; depth <= options.max_depth && ret.size() < options.max_results; depth++) {
+        const auto level_end = nodes.size();
+        for (auto i = level_begin; i < level_end && ret.size() < options.max_results; i++) {
+            const auto address = nodes[i].address;
+            const auto min_value = address - (std::min)(address, options.max_offset);
+            for (const auto& entry : map.find(min_value, address)) {
+                const auto offset = static_cast<std::intptr_t>(address - entry.value);
+                if (auto module = find_module(entry.address)) {
+                    PointerPath path{
+                        .module = module->path,
+                        .module_base = module->base,
+                        .offsets = {static_cast<std::intptr_t>(entry.address - module->base), offset},
+                    };
+                    for (auto j = i; nodes[j].parent != no_parent; j = nodes[j].parent) {
+                        path.offsets.push_back(nodes[j].offset);
+                    }
+                    ret.push_back(std::move(path));
+                    if (ret.size() >= options.max_results) {
+                        break;
+                    }
+                    continue;
+                }
+                if (depth < options.max_depth && visited.insert(entry.address).second) {
+                    nodes.push_back(Node{.address = entry.address, .parent = i, .offset = offset});
+                }
+            }
+        }
+        level_begin = level_end;
+    }
+    return ret;
+}
@@ -0,0 +1,243 @@
+/**
+ * @file RegionReader.cpp
+ * @author UnnamedOrange
+ * @brief Stream regions chunk by chunk with bounded memory.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include "feature/RegionReader.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "utils/macro.h"
+
+USING_MEMORY_READER_NAMESPACE;
+
+std::vector<RegionChunk> orange::memory_reader::split_regions(std::span<const Region> regions,
+                                                              const RegionReaderOptions& options) {
+    std::vector<RegionChunk> ret;
+    const auto chunk_size = (std::max)(options.chunk_size, std::size_t{1});
+    for (const auto& region : regions) {
+        for (std::size_t offset = 0; offset < region.size; offset += chunk_size) {
+            const auto size = (std::min)(chunk_size, region.size - offset);
+            ret.push_back(RegionChunk{
+                .address = region.base + offset,
+                .size = size,
+                .overlap = (std::min)(options.overlap, region.size - offset - size),
+            });
+        }
+    }
+    return ret;
+}
+
+using Self = RegionReader;
+
+Self::RegionReader(const IReadMemory& reader, std::vector<RegionChunk> chunks,
+                   const RegionReaderOptions& options) noexcept
+    : reader(reader), chunks(std::move(chunks)), scheduler(options.scheduler) {
+    if (scheduler) {
+        std::size_t bytes = 0;
+        for (const auto& chunk : this->chunks) {
+            bytes += chunk.size + chunk.overlap;
+        }
+        scheduler->add_work(bytes);
+        resumed = ScanScheduler::clock::now();
+    }
+    if (options.read_ahead && this->chunks.size() > 1) {
+        try {
+            // One more buffer is held by the consumer.
+            spare.resize(options.read_ahead + 1);
+            read_ahead_thread = std::thread(&Self::read_ahead_routine, this);
+        } catch (...) {
+            spare.clear();
+        }
+    }
+}
+
+Self::~RegionReader() {
+    if (std::lock_guard _(m_slots); true) {
+        should_exit = true;
+    }
+    cv_slots.notify_all();
+    if (read_ahead_thread.joinable()) {
+        read_ahead_thread.join();
+    }
+}
+
+std::size_t Self::read_chunk(const RegionChunk& chunk, std::vector<std::byte>& buf,
+                             std::vector<Run>& runs) const noexcept {
+    const auto size = chunk.size + chunk.overlap;
+    // Pages owned by the chunk, which are counted when they cannot be read.
+    const auto owned_pages = chunk.size ? (chunk.address + chunk.size - 1) / page_size - chunk.address / page_size + 1
+                                        : std::size_t{0};
+    runs.clear();
+    try {
+        if (buf.size() < size) {
+            buf.resize(size);
+        }
+        if (reader.read_to_buf(chunk.address, buf.data(), size)) {
+            runs.push_back(Run{.offset = 0, .chunk = chunk});
+            return 0;
+        }
+
+        // Salvage the readable pages, e.g. when the region has shrunk since it was queried.
+        std::size_t failed_pages = 0;
+        std::size_t run_begin = 0;
+        bool in_run = false;
+        auto close_run = [&](std::size_t begin, std::size_t end) {
+            // A run starting in the overlap belongs to the next chunk.
+            if (begin < chunk.size) {
+                const auto owned_end = (std::min)(end, chunk.size);
+                runs.push_back(Run{.offset = begin,
+                                   .chunk = RegionChunk{.address = chunk.address + begin,
+                                                        .size = owned_end - begin,
+                                                        .overlap = end - owned_end}});
+            }
+        };
+        for (std::size_t offset = 0; offset < size;) {
+            const auto address = chunk.address + offset;
+            const auto length = (std::min)(size - offset, page_size - address % page_size);
+            if (reader.read_to_buf(address, buf.data() + offset, length)) {
+                if (!in_run) {
+                    run_begin = offset;
+                    in_run = true;
+                }
+            } else {
+                if (offset < chunk.size) {
+                    failed_pages++;
+                }
+                if (in_run) {
+                    close_run(run_begin, offset);
+                    in_run = false;
+                }
+            }
+            offset += length;
+        }
+        if (in_run) {
+            close_run(run_begin, size);
+        }
+        return failed_pages;
+    } catch (...) {
+        runs.clear();
+        return owned_pages;
+    }
+}
+
+std::optional<ChunkView> Self::next_run() noexcept {
+    if (run_index >= runs.size()) {
+        return std::nullopt;
+    }
+    const auto& run = runs[run_index++];
+    return ChunkView{.chunk = run.chunk,
+                     .data = std::span<const std::byte>(buf.data() + run.offset, run.chunk.size + run.chunk.overlap)};
+}
+
+void Self::read_ahead_routine() {
+    if (scheduler) {
+        scheduler->lower_current_thread();
+    }
+    try {
+        for (std::size_t index = 0; index < chunks.size(); index++) {
+            Slot slot{.index = index, .failed = 0, .runs = {}, .buf = {}};
+            if (std::unique_lock lock(m_slots); true) {
+                cv_slots.wait(lock, [this] { return should_exit || !spare.empty(); });
+                if (should_exit) {
+                    break;
+                }
+                slot.buf = std::move(spare.back());
+                spare.pop_back();
+            }
+
+            slot.failed = read_chunk(chunks[index], slot.buf, slot.runs);
+
+            if (std::lock_guard _(m_slots); true) {
+                ready.push_back(std::move(slot));
+            }
+            cv_slots.notify_all();
+        }
+    } catch (...) {
+        // The consumer reads the chunks not in ready on demand.
+    }
+    if (std::lock_guard _(m_slots); true) {
+        read_ahead_stopped = true;
+    }
+    cv_slots.notify_all();
+}
+
+void Self::give_back(std::vector<std::byte>&& buf) noexcept {
+    try {
+        spare.push_back(std::move(buf));
+    } catch (...) {
+        // Without the buffer, the helper thread may wait forever, so stop it.
+        should_exit = true;
+    }
+    cv_slots.notify_all();
+}
+
+std::optional<ChunkView> Self::next_read_ahead() noexcept {
+    if (auto view = next_run()) {
+        return view;
+    }
+    std::unique_lock lock(m_slots);
+    // The buffer of the previous view goes back to the helper thread.
+    if (!buf.empty() && !read_ahead_stopped) {
+        give_back(std::move(buf));
+        buf = {};
+    }
+    while (next_index < chunks.size()) {
+        cv_slots.wait(lock, [this] { return !ready.empty() || read_ahead_stopped; });
+        if (ready.empty()) {
+            return std::nullopt;
+        }
+        auto slot = std::move(ready.front());
+        ready.pop_front();
+        next_index = slot.index + 1;
+        failed += slot.failed;
+        if (slot.runs.empty()) {
+            give_back(std::move(slot.buf));
+            continue;
+        }
+        buf = std::move(slot.buf);
+        runs = std::move(slot.runs);
+        run_index = 0;
+        return next_run();
+    }
+    return std::nullopt;
+}
+
+void Self::pace() noexcept {
+    if (!scheduler) {
+        return;
+    }
+    std::size_t bytes = 0;
+    for (; paced_index < next_index; paced_index++) {
+        bytes += chunks[paced_index].size + chunks[paced_index].overlap;
+    }
+    if (bytes) {
+        scheduler->pace(bytes, ScanScheduler::clock::now() - resumed);
+    }
+    resumed = ScanScheduler::clock::now();
+}
+
+std::optional<ChunkView> Self::next() noexcept {
+    pace();
+    if (read_ahead_thread.joinable()) {
+        // If the helper thread has stopped early, e.g. on an allocation failure, the rest is read on demand.
+        if (auto view = next_read_ahead()) {
+            return view;
+        }
+    } else if (auto view = next_run()) {
+        return view;
+    }
+    while (next_index < chunks.size()) {
+        failed += read_chunk(chunks[next_index++], buf, runs);
+        run_index = 0;
+        if (auto view = next_run()) {
+            return view;
+        }
+    }
+    return std::nullopt;
+}
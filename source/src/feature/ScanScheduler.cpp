@@ -0,0 +1,94 @@
+/**
+ * @file ScanScheduler.cpp
+ * @author UnnamedOrange
+ * @brief Pace background scans by a budget of bandwidth and CPU time, and report their progress.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include "feature/ScanScheduler.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "utils/macro.h"
+
+USING_MEMORY_READER_NAMESPACE;
+
+using Self = ScanScheduler;
+
+namespace {
+    ScanBudget clamp_budget(ScanBudget budget) noexcept {
+        // Also catches NaN.
+        if (!(budget.duty_cycle >= Self::min_duty_cycle)) {
+            budget.duty_cycle = Self::min_duty_cycle;
+        }
+        budget.duty_cycle = (std::min)(budget.duty_cycle, 1.0);
+        return budget;
+    }
+} // namespace
+
+Self::ScanScheduler(const ScanBudget& budget) noexcept : budget(clamp_budget(budget)) {}
+
+void Self::add_work(std::size_t bytes) noexcept {
+    std::lock_guard _(m_state);
+    if (!started) {
+        started = clock::now();
+    }
+    total += bytes;
+}
+
+void Self::pace(std::size_t bytes, clock::duration busy) noexcept {
+    auto now = clock::now();
+    auto wake = now;
+    if (std::lock_guard _(m_state); true) {
+        done += bytes;
+        if (budget.bytes_per_second) {
+            const auto seconds = static_cast<double>(bytes) / static_cast<double>(budget.bytes_per_second);
+            const auto cost = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(seconds));
+            // Idle time is not saved up, so that there is no burst after a pause.
+            paid_until = (std::max)(paid_until, now) + cost;
+            wake = paid_until;
+        }
+    }
+    if (budget.duty_cycle < 1) {
+        const auto rest = std::chrono::duration_cast<clock::duration>(
+            std::chrono::duration<double>(busy) * ((1 - budget.duty_cycle) / budget.duty_cycle));
+        wake = (std::max)(wake, now + rest);
+    }
+    if (wake > now) {
+        std::this_thread::sleep_until(wake);
+    } else {
+        std::this_thread::yield();
+    }
+}
+
+std::size_t Self::total_bytes() const noexcept {
+    std::lock_guard _(m_state);
+    return total;
+}
+std::size_t Self::done_bytes() const noexcept {
+    std::lock_guard _(m_state);
+    return done;
+}
+double Self::progress() const noexcept {
+    std::lock_guard _(m_state);
+    if (!total) {
+        return 1;
+    }
+    return (std::min)(1.0, static_cast<double>(done) / static_cast<double>(total));
+}
+std::optional<Self::clock::time_point> Self::estimated_completion() const noexcept {
+    std::lock_guard _(m_state);
+    if (!started || !done) {
+        return std::nullopt;
+    }
+    const auto now = clock::now();
+    if (done >= total) {
+        return now;
+    }
+    const auto elapsed = std::chrono::duration<double>(now - *started);
+    const auto remaining = elapsed * (static_cast<double>(total - done) / static_cast<double>(done));
+    return now + std::chrono::duration_cast<clock::duration>(remaining);
+}
@@ -0,0 +1,40 @@
+/**
+ * @file ScanScheduler_linux.cpp
+ * @author UnnamedOrange
+ * @brief Implement thread priorities of @ref ScanScheduler on Linux.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#ifdef MEMORY_READER_TARGET_PLATFORM_LINUX
+
+#include "feature/ScanScheduler.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "utils/macro.h"
+
+USING_MEMORY_READER_NAMESPACE;
+
+using Self = ScanScheduler;
+
+bool Self::lower_current_thread() const noexcept {
+    switch (budget.priority) {
+    case WorkerPriority::NORMAL: return true;
+    case WorkerPriority::LOW:
+        // Nice values are per thread on Linux.
+        return setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), budget.nice) == 0;
+    case WorkerPriority::IDLE: {
+        sched_param param{};
+        return pthread_setschedparam(pthread_self(), SCHED_IDLE, &param) == 0;
+    }
+    }
+    return false;
+}
+
+#endif
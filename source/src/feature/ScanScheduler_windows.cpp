@@ -0,0 +1,31 @@
+/**
+ * @file ScanScheduler_windows.cpp
+ * @author UnnamedOrange
+ * @brief Implement thread priorities of @ref ScanScheduler on Windows.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#ifdef MEMORY_READER_TARGET_PLATFORM_WIN32
+
+#include "feature/ScanScheduler.h"
+
+#include <Windows.h>
+
+#include "utils/macro.h"
+
+USING_MEMORY_READER_NAMESPACE;
+
+using Self = ScanScheduler;
+
+bool Self::lower_current_thread() const noexcept {
+    switch (budget.priority) {
+    case WorkerPriority::NORMAL: return true;
+    case WorkerPriority::LOW: return SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL) != 0;
+    case WorkerPriority::IDLE: return SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_IDLE) != 0;
+    }
+    return false;
+}
+
+#endif
@@ -0,0 +1,235 @@
+/**
+ * @file SharedExport.cpp
+ * @author UnnamedOrange
+ * @brief Publish watched values to shared memory, so that other processes read them without attaching.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include "feature/SharedExport.h"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+#include "utils/macro.h"
+
+USING_MEMORY_READER_NAMESPACE;
+
+static_assert(std::atomic_ref<std::uint64_t>::is_always_lock_free &&
+                  std::atomic_ref<std::uint32_t>::is_always_lock_free,
+              "Shared records need lock-free atomics.");
+
+namespace {
+    std::string segment_name(std::string_view name) {
+        std::string ret;
+        if (!name.starts_with('/')) {
+            ret += '/';
+        }
+        ret += name;
+        return ret;
+    }
+    std::uint64_t* record_words(__detail::ExportRecordHeader* record) noexcept {
+        return reinterpret_cast<std::uint64_t*>(record + 1);
+    }
+    std::int64_t now_since_epoch() noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    }
+} // namespace
+
+__detail::SharedSegment::SharedSegment(SharedSegment&& other) noexcept
+    : segment_data(std::exchange(other.segment_data, nullptr)), segment_size(std::exchange(other.segment_size, 0)),
+      name(std::move(other.name)), owner(std::exchange(other.owner, false)) {}
+__detail::SharedSegment& __detail::SharedSegment::operator=(SharedSegment&& other) noexcept {
+    if (this != &other) {
+        close();
+        segment_data = std::exchange(other.segment_data, nullptr);
+        segment_size = std::exchange(other.segment_size, 0);
+        name = std::move(other.name);
+        owner = std::exchange(other.owner, false);
+    }
+    return *this;
+}
+__detail::SharedSegment::~SharedSegment() {
+    close();
+}
+
+ExportServer::ExportServer(const IReadMemoryWithCacheHint& reader, std::string_view name,
+                           std::span<const ExportField> fields)
+    : reader(reader) {
+    std::size_t size = sizeof(__detail::ExportSegmentHeader);
+    for (const auto& field : fields) {
+        if (field.name.empty() || field.name.size() >= __detail::export_name_size) {
+            return;
+        }
+        size += __detail::export_record_stride(field.target.size);
+    }
+    segment = __detail::SharedSegment::create(segment_name(name), size);
+    if (segment.empty()) {
+        return;
+    }
+
+    auto& header = *reinterpret_cast<__detail::ExportSegmentHeader*>(segment.data());
+    header.version = __detail::export_version;
+    header.record_count = static_cast<std::uint32_t>(fields.size());
+    header.segment_size = size;
+    header.cache_hint = reader.get_cache_hint();
+    header.heartbeat_time = now_since_epoch();
+    auto position = segment.data() + sizeof(header);
+    for (const auto& field : fields) {
+        auto record = reinterpret_cast<__detail::ExportRecordHeader*>(position);
+        std::ranges::copy(field.name, record->name);
+        record->size = static_cast<std::uint32_t>(field.target.size);
+        records.push_back(record);
+        position += __detail::export_record_stride(field.target.size);
+    }
+    std::atomic_ref(header.magic).store(__detail::export_magic, std::memory_order_release);
+
+    watcher.emplace(reader);
+    for (std::size_t i = 0; i < fields.size(); i++) {
+        watcher->subscribe(fields[i].target, fields[i].period,
+                           [this, i](std::span<const std::byte> value) { publish(i, value); });
+    }
+    watcher->set_poll_callback([this] { heartbeat(); });
+}
+ExportServer::~ExportServer() {
+    watcher.reset();
+    if (!segment.empty()) {
+        auto& header = *reinterpret_cast<__detail::ExportSegmentHeader*>(segment.data());
+        std::atomic_ref(header.closed).store(1, std::memory_order_release);
+    }
+}
+
+void ExportServer::publish(std::size_t index, std::span<const std::byte> value) noexcept {
+    auto& header = *reinterpret_cast<__detail::ExportSegmentHeader*>(segment.data());
+    std::atomic_ref(header.cache_hint).store(reader.get_cache_hint(), std::memory_order_release);
+
+    // Records are only written by the polling thread of the watcher, so there is a single writer.
+    auto record = records[index];
+    std::atomic_ref sequence(record->sequence);
+    const auto before = sequence.load(std::memory_order_relaxed);
+    sequence.store(before + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    const bool valid = value.size() == record->size;
+    if (valid) {
+        auto words = record_words(record);
+        for (std::size_t offset = 0; offset < value.size(); offset += sizeof(std::uint64_t)) {
+            std::uint64_t word = 0;
+            std::memcpy(&word, value.data() + offset, (std::min)(sizeof(word), value.size() - offset));
+            std::atomic_ref(words[offset / sizeof(word)]).store(word, std::memory_order_relaxed);
+        }
+    }
+    std::atomic_ref(record->valid).store(valid, std::memory_order_relaxed);
+    sequence.store(before + 2, std::memory_order_release);
+}
+
+void ExportServer::heartbeat() noexcept {
+    // The cache hint may change without any value changing, e.g. when the process restarts.
+    auto& header = *reinterpret_cast<__detail::ExportSegmentHeader*>(segment.data());
+    std::atomic_ref(header.cache_hint).store(reader.get_cache_hint(), std::memory_order_release);
+    std::atomic_ref(header.heartbeat_time).store(now_since_epoch(), std::memory_order_relaxed);
+    std::atomic_ref(header.heartbeat_count).fetch_add(1, std::memory_order_release);
+}
+
+ExportClient ExportClient::try_open(std::string_view name) noexcept {
+    try {
+        ExportClient ret;
+        ret.segment = __detail::SharedSegment::open(segment_name(name));
+        if (ret.segment.empty() || ret.segment.size() < sizeof(__detail::ExportSegmentHeader)) {
+            return {};
+        }
+        auto& header = ret.header();
+        if (std::atomic_ref(header.magic).load(std::memory_order_acquire) != __detail::export_magic ||
+            header.version != __detail::export_version || header.segment_size > ret.segment.size()) {
+            return {};
+        }
+        std::size_t position = sizeof(header);
+        for (std::uint32_t i = 0; i < header.record_count; i++) {
+            if (header.segment_size - position < sizeof(__detail::ExportRecordHeader)) {
+                return {};
+            }
+            auto record = reinterpret_cast<__detail::ExportRecordHeader*>(ret.segment.data() + position);
+            const auto stride = __detail::export_record_stride(record->size);
+            if (header.segment_size - position < stride) {
+                return {};
+            }
+            const auto name_end = std::find(record->name, record->name + __detail::export_name_size, '\0');
+            ret.field_list.push_back(Field{
+                .name = std::string_view(record->name, name_end),
+                .header = record,
+                .words = record_words(record),
+            });
+            position += stride;
+        }
+        return ret;
+    } catch (...) {
+    }
+    return {};
+}
+
+bool ExportClient::closed() const noexcept {
+    return empty() || std::atomic_ref(header().closed).load(std::memory_order_acquire);
+}
+std::uint64_t ExportClient::get_cache_hint() const noexcept {
+    if (empty()) {
+        return 0;
+    }
+    return std::atomic_ref(header().cache_hint).load(std::memory_order_acquire);
+}
+
+std::uint64_t ExportClient::heartbeat_count() const noexcept {
+    if (empty()) {
+        return 0;
+    }
+    return std::atomic_ref(header().heartbeat_count).load(std::memory_order_acquire);
+}
+std::chrono::system_clock::time_point ExportClient::last_heartbeat() const noexcept {
+    if (empty()) {
+        return {};
+    }
+    const auto time = std::atomic_ref(header().heartbeat_time).load(std::memory_order_relaxed);
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(time)));
+}
+bool ExportClient::alive(std::chrono::system_clock::duration max_age) const noexcept {
+    return !closed() && std::chrono::system_clock::now() - last_heartbeat() <= max_age;
+}
+
+std::optional<ExportClient::FieldId> ExportClient::find(std::string_view name) const noexcept {
+    auto it = std::ranges::find(field_list, name, &Field::name);
+    if (it == field_list.end()) {
+        return std::nullopt;
+    }
+    return static_cast<FieldId>(it - field_list.begin());
+}
+
+bool ExportClient::read_to_buf(FieldId id, void* buf, std::size_t size) const noexcept {
+    if (id >= field_list.size() || size != field_list[id].header->size) {
+        return false;
+    }
+    const auto& field = field_list[id];
+    auto out = static_cast<std::byte*>(buf);
+    std::atomic_ref sequence(field.header->sequence);
+    for (std::size_t attempt = 0; attempt < max_attempts; attempt++) {
+        const auto before = sequence.load(std::memory_order_acquire);
+        // The server is writing. Let it finish.
+        if (before & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+        const auto valid = std::atomic_ref(field.header->valid).load(std::memory_order_relaxed);
+        for (std::size_t offset = 0; offset < size; offset += sizeof(std::uint64_t)) {
+            const auto word =
+                std::atomic_ref(field.words[offset / sizeof(std::uint64_t)]).load(std::memory_order_relaxed);
+            std::memcpy(out + offset, &word, (std::min)(sizeof(word), size - offset));
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) == before) {
+            return valid != 0;
+        }
+    }
+    return false;
+}
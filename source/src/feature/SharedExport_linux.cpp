@@ -0,0 +1,81 @@
+/**
+ * @file SharedExport_linux.cpp
+ * @author UnnamedOrange
+ * @brief Implement shared memory segments of @ref ExportServer and @ref ExportClient on Linux.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#ifdef MEMORY_READER_TARGET_PLATFORM_LINUX
+
+#include "feature/SharedExport.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "utils/macro.h"
+
+USING_MEMORY_READER_NAMESPACE;
+
+using Self = __detail::SharedSegment;
+
+Self Self::create(const std::string& name, std::size_t size) noexcept {
+    try {
+        // A segment left by a server which crashed is replaced. Clients having mapped it keep the old one.
+        shm_unlink(name.c_str());
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0644);
+        if (fd == -1)
+            return {};
+        void* data = MAP_FAILED;
+        if (ftruncate(fd, static_cast<off_t>(size)) == 0)
+            data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            shm_unlink(name.c_str());
+            return {};
+        }
+
+        Self ret;
+        ret.segment_data = static_cast<std::byte*>(data);
+        ret.segment_size = size;
+        ret.name = name;
+        ret.owner = true;
+        return ret;
+    } catch (...) {
+    }
+    return {};
+}
+
+Self Self::open(const std::string& name) noexcept {
+    int fd = shm_open(name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (fd == -1)
+        return {};
+    struct stat file {};
+    void* data = MAP_FAILED;
+    if (fstat(fd, &file) == 0 && file.st_size > 0)
+        data = mmap(nullptr, static_cast<std::size_t>(file.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED)
+        return {};
+
+    Self ret;
+    ret.segment_data = static_cast<std::byte*>(data);
+    ret.segment_size = static_cast<std::size_t>(file.st_size);
+    return ret;
+}
+
+void Self::close() noexcept {
+    if (!segment_data)
+        return;
+    munmap(segment_data, segment_size);
+    if (owner)
+        shm_unlink(name.c_str());
+    segment_data = nullptr;
+    segment_size = 0;
+    owner = false;
+}
+
+#endif
@@ -0,0 +1,36 @@
+/**
+ * @file SharedExport_windows.cpp
+ * @author UnnamedOrange
+ * @brief Implement shared memory segments of @ref ExportServer and @ref ExportClient on Windows.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#ifdef MEMORY_READER_TARGET_PLATFORM_WIN32
+
+#include "feature/SharedExport.h"
+
+#include "utils/macro.h"
+
+USING_MEMORY_READER_NAMESPACE;
+
+using Self = __detail::SharedSegment;
+
+Self Self::create(const std::string&, std::size_t) noexcept {
+    // Not supported yet.
+    return {};
+}
+
+Self Self::open(const std::string&) noexcept {
+    // Not supported yet.
+    return {};
+}
+
+void Self::close() noexcept {
+    segment_data = nullptr;
+    segment_size = 0;
+    owner = false;
+}
+
+#endif
@@ -0,0 +1,245 @@
+/**
+ * @file SignatureManifest.cpp
+ * @author UnnamedOrange
+ * @brief Load named signatures from a manifest file.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include "feature/SignatureManifest.h"
+
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+#include "utils/macro.h"
+
+USING_MEMORY_READER_NAMESPACE;
+
+namespace {
+    /**
+     * @brief Parse a signed integer in decimal, or in hexadecimal with the prefix "0x".
+     */
+    std::optional<std::intptr_t> parse_integer(std::string_view sv) noexcept {
+        bool negative = false;
+        if (!sv.empty() && (sv.front() == '+' || sv.front() == '-')) {
+            negative = sv.front() == '-';
+            sv.remove_prefix(1);
+        }
+        int base = 10;
+        if (sv.starts_with("0x") || sv.starts_with("0X")) {
+            base = 16;
+            sv.remove_prefix(2);
+        }
+        // from_chars reports overflow of the magnitude, and the range of the sign is checked below.
+        std::uintmax_t value{};
+        auto [ptr, ec] = std::from_chars(sv.data(), sv.data() + sv.size(), value, base);
+        if (sv.empty() || ec != std::errc{} || ptr != sv.data() + sv.size()) {
+            return std::nullopt;
+        }
+        constexpr auto max_magnitude = static_cast<std::uintmax_t>(INTPTR_MAX);
+        if (value > max_magnitude + (negative ? 1 : 0)) {
+            return std::nullopt;
+        }
+        if (!negative) {
+            return static_cast<std::intptr_t>(value);
+        }
+        // Negate in two steps, so that INTPTR_MIN does not overflow.
+        return value ? -static_cast<std::intptr_t>(value - 1) - 1 : 0;
+    }
+
+    bool is_space(char ch) noexcept {
+        return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\v' || ch == '\f';
+    }
+
+    /**
+     * @brief Parse steps separated by whitespaces, like "rel32(3, 4) add(0x10)".
+     *
+     * @param column Set to the offset of the invalid step on failure.
+     * @return const char* The error message, or nullptr on success.
+     */
+    const char* parse_steps(std::string_view text, std::vector<SignatureStep>& steps, std::size_t& column) {
+        std::size_t i = 0;
+        auto skip_spaces = [&] {
+            while (i < text.size() && is_space(text[i])) {
+                i++;
+            }
+        };
+        while (true) {
+            skip_spaces();
+            if (i == text.size()) {
+                return nullptr;
+            }
+            column = i;
+            auto name_begin = i;
+            while (i < text.size() && !is_space(text[i]) && text[i] != '(') {
+                i++;
+            }
+            auto name = text.substr(name_begin, i - name_begin);
+
+            // Arguments in parentheses, with whitespaces allowed.
+            std::array<std::intptr_t, 2> args{};
+            std::size_t arg_count = 0;
+            skip_spaces();
+            if (i < text.size() && text[i] == '(') {
+                auto close = text.find(')', i);
+                if (close == std::string_view::npos) {
+                    return "Unclosed parenthesis in steps.";
+                }
+                auto inner = text.substr(i + 1, close - i - 1);
+                i = close + 1;
+                while (true) {
+                    auto comma = inner.find(',');
+                    auto arg = inner.substr(0, comma);
+                    while (!arg.empty() && is_space(arg.front())) {
+                        arg.remove_prefix(1);
+                    }
+                    while (!arg.empty() && is_space(arg.back())) {
+                        arg.remove_suffix(1);
+                    }
+                    auto value = parse_integer(arg);
+                    // The lowest value is reserved for SignatureStep::at_marker.
+                    if (!value || *value == SignatureStep::at_marker) {
+                        return "Invalid integer in steps.";
+                    }
+                    if (arg_count == args.size()) {
+                        return "Too many arguments of a step.";
+                    }
+                    args[arg_count++] = *value;
+                    if (comma == std::string_view::npos) {
+                        break;
+                    }
+                    inner.remove_prefix(comma + 1);
+                }
+            }
+
+            if (name == "rel32") {
+                steps.push_back(rel32(arg_count > 0 ? args[0] : SignatureStep::at_marker, arg_count > 1 ? args[1] : 0));
+            } else if (name == "abs32" && arg_count <= 1) {
+                steps.push_back(abs32(arg_count > 0 ? args[0] : SignatureStep::at_marker));
+            } else if (name == "abs64" && arg_count <= 1) {
+                steps.push_back(abs64(arg_count > 0 ? args[0] : SignatureStep::at_marker));
+            } else if (name == "add" && arg_count == 1) {
+                steps.push_back(add(args[0]));
+            } else if (name == "to_marker" && arg_count == 0) {
+                steps.push_back(to_marker());
+            } else {
+                return "Invalid step.";
+            }
+        }
+    }
+} // namespace
+
+using Self = SignatureManifest;
+
+std::optional<Self> Self::try_parse(std::string_view text, ManifestError* error) noexcept {
+    auto fail = [error](std::size_t line, std::size_t column, const char* message) -> std::optional<Self> {
+        if (error) {
+            *error = ManifestError{.line = line, .column = column + 1, .message = message};
+        }
+        return std::nullopt;
+    };
+
+    try {
+        Self ret;
+        std::vector<SignatureStep> steps;
+        for (std::size_t line_number = 1; !text.empty(); line_number++) {
+            auto line_end = text.find('\n');
+            auto line = text.substr(0, line_end);
+            text.remove_prefix(line_end == std::string_view::npos ? text.size() : line_end + 1);
+
+            // Comments and blank lines.
+            auto content = line.substr(0, line.find('#'));
+            std::size_t i = 0;
+            while (i < content.size() && is_space(content[i])) {
+                i++;
+            }
+            if (i == content.size()) {
+                continue;
+            }
+
+            auto equal = content.find('=');
+            if (equal == std::string_view::npos) {
+                return fail(line_number, i, "Expect '=' after the name.");
+            }
+            auto name = content.substr(i, equal - i);
+            while (!name.empty() && is_space(name.back())) {
+                name.remove_suffix(1);
+            }
+            if (name.empty()) {
+                return fail(line_number, i, "The name should not be empty.");
+            }
+            for (auto ch : name) {
+                if (is_space(ch)) {
+                    return fail(line_number, i, "The name should not contain whitespaces.");
+                }
+            }
+
+            const auto pattern_begin = equal + 1;
+            auto arrow = content.find("=>", pattern_begin);
+            auto pattern_str =
+                content.substr(pattern_begin, arrow == std::string_view::npos ? arrow : arrow - pattern_begin);
+            PatternError pattern_error{};
+            auto pattern = DynamicPattern::try_parse(pattern_str, &pattern_error);
+            if (!pattern) {
+                return fail(line_number, pattern_begin + pattern_error.position, pattern_error.message);
+            }
+            if (pattern->empty()) {
+                return fail(line_number, pattern_begin, "The pattern should not be empty.");
+            }
+
+            steps.clear();
+            if (arrow != std::string_view::npos) {
+                const auto steps_begin = arrow + 2;
+                std::size_t column = 0;
+                if (auto message = parse_steps(content.substr(steps_begin), steps, column)) {
+                    return fail(line_number, steps_begin + column, message);
+                }
+                if (steps.empty()) {
+                    return fail(line_number, steps_begin, "Expect steps after '=>'.");
+                }
+                for (const auto& step : steps) {
+                    if (step.offset == SignatureStep::at_marker && !pattern->marker()) {
+                        return fail(line_number, steps_begin,
+                                    "Steps reading at the marker require a marker in the pattern.");
+                    }
+                }
+            }
+
+            auto [it, inserted] = ret.signatures.try_emplace(std::string(name), *pattern, steps);
+            if (!inserted) {
+                return fail(line_number, i, "Duplicate name.");
+            }
+        }
+        return ret;
+    } catch (...) {
+        if (error) {
+            *error = ManifestError{.line = 0, .column = 0, .message = "Out of memory."};
+        }
+        return std::nullopt;
+    }
+}
+
+std::optional<Self> Self::try_load(const std::filesystem::path& path, ManifestError* error) noexcept {
+    std::string text;
+    try {
+        std::ifstream ifs(path, std::ios::binary);
+        if (!ifs) {
+            if (error) {
+                *error = ManifestError{.line = 0, .column = 0, .message = "Cannot open the file."};
+            }
+            return std::nullopt;
+        }
+        text.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    } catch (...) {
+        if (error) {
+            *error = ManifestError{.line = 0, .column = 0, .message = "Cannot read the file."};
+        }
+        return std::nullopt;
+    }
+    return try_parse(text, error);
+}
@@ -0,0 +1,373 @@
+/**
+ * @file Snapshot.cpp
+ * @author UnnamedOrange
+ * @brief Capture memory regions with page deduplication, and diff two captures.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include "feature/Snapshot.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "utils/macro.h"
+
+USING_MEMORY_READER_NAMESPACE;
+
+namespace {
+    constexpr std::array<char, 8> file_magic{'M', 'R', 'S', 'N', 'A', 'P', '0', '1'};
+    /**
+     * @brief Dirty pages are read in chunks of at most this many pages.
+     */
+    constexpr std::size_t pages_per_chunk = 256;
+
+    /**
+     * @brief Hash a page with 4 independent lanes, so that the loop can be vectorized.
+     */
+    std::uint64_t hash_page(std::span<const std::byte, Snapshot::page_size> data) noexcept {
+        constexpr std::uint64_t prime = 0x9E3779B185EBCA87ull;
+        std::array<std::uint64_t, 4> lanes{1, 2, 3, 4};
+        for (std::size_t i = 0; i < data.size(); i += sizeof(lanes)) {
+            std::array<std::uint64_t, 4> words;
+            std::memcpy(words.data(), data.data() + i, sizeof(words));
+            for (std::size_t j = 0; j < lanes.size(); j++) {
+                lanes[j] = (lanes[j] ^ words[j]) * prime;
+            }
+        }
+        std::uint64_t ret = 0;
+        for (auto lane : lanes) {
+            ret = std::rotl(ret ^ lane, 27) * prime;
+        }
+        return ret ^ (ret >> 31);
+    }
+
+    /**
+     * @brief Append ranges of differing bytes in two pages at @b address to @b out.
+     * Words are compared first, then the bytes at the edges of each differing run.
+     */
+    void diff_page(std::uintptr_t address, const std::byte* a, const std::byte* b, std::vector<ChangedRange>& out) {
+        constexpr std::size_t word = sizeof(std::uint64_t);
+        std::size_t i = 0;
+        while (i < Snapshot::page_size) {
+            std::uint64_t wa, wb;
+            std::memcpy(&wa, a + i, word);
+            std::memcpy(&wb, b + i, word);
+            if (wa == wb) {
+                i += word;
+                continue;
+            }
+            std::size_t begin = i;
+            while (a[begin] == b[begin]) {
+                begin++;
+            }
+            std::size_t end = i + word;
+            while (end < Snapshot::page_size) {
+                std::memcpy(&wa, a + end, word);
+                std::memcpy(&wb, b + end, word);
+                if (wa == wb) {
+                    break;
+                }
+                end += word;
+            }
+            i = end;
+            while (a[end - 1] == b[end - 1]) {
+                end--;
+            }
+            out.push_back(ChangedRange{.address = address + begin, .size = end - begin});
+        }
+    }
+
+    void append_range(std::vector<ChangedRange>& out, ChangedRange range) {
+        if (!out.empty() && out.back().address + out.back().size == range.address) {
+            out.back().size += range.size;
+        } else {
+            out.push_back(range);
+        }
+    }
+
+    template <typename T>
+    void write_pod(std::ofstream& ofs, const T& value) {
+        ofs.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    template <typename T>
+    bool read_pod(std::ifstream& ifs, T& value) {
+        return static_cast<bool>(ifs.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+} // namespace
+
+using Self = Snapshot;
+
+std::uint32_t Self::intern_page(std::span<const std::byte, page_size> data, std::uint64_t hash, PageIndex& index) {
+    auto& candidates = index[hash];
+    auto it = std::find_if(candidates.begin(), candidates.end(), [&](std::uint32_t candidate) {
+        return std::memcmp(page(candidate).data(), data.data(), page_size) == 0;
+    });
+    if (it != candidates.end()) {
+        return *it;
+    }
+    const auto page_index = static_cast<std::uint32_t>(page_hashes.size());
+    page_pool.insert(page_pool.end(), data.begin(), data.end());
+    page_hashes.push_back(hash);
+    candidates.push_back(page_index);
+    return page_index;
+}
+
+Self Self::capture(const IReadMemory& reader, const RegionFilter& filter, const RegionReaderOptions& options) {
+    Self ret;
+    PageIndex index;
+    auto regions = reader.query_regions(filter);
+    // Chunks own whole pages, and the reader salvages readable pages of a chunk which cannot be read as a whole.
+    auto chunk_options = options;
+    chunk_options.chunk_size = (std::max)(page_size, options.chunk_size / page_size * page_size);
+    chunk_options.overlap = 0;
+    auto chunks = split_regions(regions, chunk_options);
+    for (auto& region : regions) {
+        SnapshotRegion entry{.region = std::move(region), .pages = {}};
+        entry.pages.reserve(entry.region.size / page_size);
+        ret.region_entries.push_back(std::move(entry));
+    }
+
+    // Chunks are in the order of the regions. Pages skipped by the reader could not be read.
+    std::size_t current = 0;
+    auto skip_to = [&](std::uintptr_t address) {
+        for (; current < ret.region_entries.size(); current++) {
+            auto& entry = ret.region_entries[current];
+            const auto page_count = entry.region.size / page_size;
+            if (address >= entry.region.base && address - entry.region.base < page_count * page_size) {
+                entry.pages.resize((address - entry.region.base) / page_size, no_page);
+                return;
+            }
+            entry.pages.resize(page_count, no_page);
+        }
+    };
+    RegionReader region_reader(reader, std::move(chunks), options);
+    while (auto view = region_reader.next()) {
+        for (std::size_t offset = 0; offset + page_size <= view->data.size(); offset += page_size) {
+            skip_to(view->chunk.address + offset);
+            if (current == ret.region_entries.size()) {
+                break;
+            }
+            auto data = std::span<const std::byte, page_size>(view->data.data() + offset, page_size);
+            ret.region_entries[current].pages.push_back(ret.intern_page(data, hash_page(data), index));
+        }
+    }
+    skip_to(UINTPTR_MAX);
+    return ret;
+}
+
+Self Self::capture_incremental(const IReadMemory& reader, const Snapshot& previous,
+                               std::span<const ChangedRange> dirty) {
+    Self ret;
+    std::vector<std::byte> buf(pages_per_chunk * page_size);
+    PageIndex index;
+    // Dirty ranges are sorted, and so are the pages visited, so one cursor is enough.
+    auto next_dirty = dirty.begin();
+    auto is_dirty = [&](std::uintptr_t address) {
+        while (next_dirty != dirty.end() && next_dirty->address + next_dirty->size <= address) {
+            ++next_dirty;
+        }
+        return next_dirty != dirty.end() && next_dirty->address < address + page_size;
+    };
+
+    for (const auto& previous_entry : previous.region_entries) {
+        SnapshotRegion entry{.region = previous_entry.region, .pages = {}};
+        const auto page_count = previous_entry.pages.size();
+        entry.pages.reserve(page_count);
+
+        std::size_t i = 0;
+        while (i < page_count) {
+            const auto address = entry.region.base + i * page_size;
+            if (!is_dirty(address)) {
+                const auto page_index = previous_entry.pages[i];
+                entry.pages.push_back(page_index == no_page ? no_page
+                                                            : ret.intern_page(previous.page(page_index),
+                                                                              previous.page_hash(page_index), index));
+                i++;
+                continue;
+            }
+            // Read a run of dirty pages in one chunk.
+            std::size_t count = 1;
+            while (i + count < page_count && count < pages_per_chunk && is_dirty(address + count * page_size)) {
+                count++;
+            }
+            const bool chunk_ok = reader.read_to_buf(address, buf.data(), count * page_size);
+            for (std::size_t j = 0; j < count; j++) {
+                auto data = std::span<const std::byte, page_size>(buf.data() + j * page_size, page_size);
+                if (!chunk_ok &&
+                    !reader.read_to_buf(address + j * page_size, buf.data() + j * page_size, page_size)) {
+                    entry.pages.push_back(no_page);
+                    continue;
+                }
+                entry.pages.push_back(ret.intern_page(data, hash_page(data), index));
+            }
+            i += count;
+        }
+        ret.region_entries.push_back(std::move(entry));
+    }
+    return ret;
+}
+
+bool Self::read_to_buf(std::uintptr_t address, void* buf, std::size_t size) const noexcept {
+    auto out = static_cast<std::byte*>(buf);
+    while (size) {
+        auto it = std::find_if(region_entries.begin(), region_entries.end(), [&](const SnapshotRegion& entry) {
+            return entry.region.base <= address && address - entry.region.base < entry.region.size;
+        });
+        if (it == region_entries.end()) {
+            return false;
+        }
+        const auto offset = address - it->region.base;
+        const auto page_index = it->pages[offset / page_size];
+        if (page_index == no_page) {
+            return false;
+        }
+        const auto in_page = offset % page_size;
+        const auto count = (std::min)(size, page_size - in_page);
+        std::memcpy(out, page(page_index).data() + in_page, count);
+        out += count;
+        address += count;
+        size -= count;
+    }
+    return true;
+}
+
+bool Self::save(const std::filesystem::path& path) const noexcept {
+    try {
+        std::ofstream ofs(path, std::ios::binary);
+        if (!ofs) {
+            return false;
+        }
+        ofs.write(file_magic.data(), file_magic.size());
+        write_pod(ofs, static_cast<std::uint64_t>(region_entries.size()));
+        for (const auto& entry : region_entries) {
+            write_pod(ofs, static_cast<std::uint64_t>(entry.region.base));
+            write_pod(ofs, static_cast<std::uint64_t>(entry.region.size));
+            write_pod(ofs, entry.region.protection);
+            write_pod(ofs, static_cast<std::uint64_t>(entry.region.path.size()));
+            ofs.write(entry.region.path.data(), static_cast<std::streamsize>(entry.region.path.size()));
+            ofs.write(reinterpret_cast<const char*>(entry.pages.data()),
+                      static_cast<std::streamsize>(entry.pages.size() * sizeof(std::uint32_t)));
+        }
+        write_pod(ofs, static_cast<std::uint64_t>(page_hashes.size()));
+        ofs.write(reinterpret_cast<const char*>(page_hashes.data()),
+                  static_cast<std::streamsize>(page_hashes.size() * sizeof(std::uint64_t)));
+        ofs.write(reinterpret_cast<const char*>(page_pool.data()), static_cast<std::streamsize>(page_pool.size()));
+        return static_cast<bool>(ofs);
+    } catch (...) {
+        return false;
+    }
+}
+std::optional<Self> Self::load(const std::filesystem::path& path) noexcept {
+    try {
+        std::ifstream ifs(path, std::ios::binary);
+        std::array<char, file_magic.size()> magic;
+        if (!ifs || !ifs.read(magic.data(), magic.size()) || magic != file_magic) {
+            return std::nullopt;
+        }
+
+        Self ret;
+        std::uint64_t region_count;
+        if (!read_pod(ifs, region_count)) {
+            return std::nullopt;
+        }
+        for (std::uint64_t i = 0; i < region_count; i++) {
+            std::uint64_t base, size, path_size;
+            RegionProtection protection;
+            if (!read_pod(ifs, base) || !read_pod(ifs, size) || !read_pod(ifs, protection) ||
+                !read_pod(ifs, path_size)) {
+                return std::nullopt;
+            }
+            SnapshotRegion entry{
+                .region =
+                    Region{
+                        .base = static_cast<std::uintptr_t>(base),
+                        .size = static_cast<std::size_t>(size),
+                        .protection = protection,
+                        .path = std::string(static_cast<std::size_t>(path_size), '\0'),
+                    },
+                .pages = std::vector<std::uint32_t>(static_cast<std::size_t>(size / page_size)),
+            };
+            if (!ifs.read(entry.region.path.data(), static_cast<std::streamsize>(path_size)) ||
+                !ifs.read(reinterpret_cast<char*>(entry.pages.data()),
+                          static_cast<std::streamsize>(entry.pages.size() * sizeof(std::uint32_t)))) {
+                return std::nullopt;
+            }
+            ret.region_entries.push_back(std::move(entry));
+        }
+
+        std::uint64_t page_count;
+        if (!read_pod(ifs, page_count)) {
+            return std::nullopt;
+        }
+        ret.page_hashes.resize(static_cast<std::size_t>(page_count));
+        ret.page_pool.resize(static_cast<std::size_t>(page_count) * page_size);
+        if (!ifs.read(reinterpret_cast<char*>(ret.page_hashes.data()),
+                      static_cast<std::streamsize>(ret.page_hashes.size() * sizeof(std::uint64_t))) ||
+            !ifs.read(reinterpret_cast<char*>(ret.page_pool.data()),
+                      static_cast<std::streamsize>(ret.page_pool.size()))) {
+            return std::nullopt;
+        }
+        for (const auto& entry : ret.region_entries) {
+            for (auto page_index : entry.pages) {
+                if (page_index != no_page && page_index >= page_count) {
+                    return std::nullopt;
+                }
+            }
+        }
+        return ret;
+    } catch (...) {
+        return std::nullopt;
+    }
+}
+
+std::vector<ChangedRange> orange::memory_reader::diff(const Snapshot& before, const Snapshot& after) {
+    constexpr auto page_size = Snapshot::page_size;
+    std::vector<ChangedRange> ret;
+    std::vector<ChangedRange> page_ranges;
+
+    // Regions are sorted by address in both snapshots, so walk them together.
+    const auto& regions_a = before.regions();
+    const auto& regions_b = after.regions();
+    std::size_t ia = 0, ib = 0;
+    while (ia < regions_a.size() && ib < regions_b.size()) {
+        const auto& a = regions_a[ia];
+        const auto& b = regions_b[ib];
+        const auto begin = (std::max)(a.region.base, b.region.base);
+        const auto end = (std::min)(a.region.base + a.region.size, b.region.base + b.region.size);
+        for (auto address = begin; address < end; address += page_size) {
+            const auto pa = a.pages[(address - a.region.base) / page_size];
+            const auto pb = b.pages[(address - b.region.base) / page_size];
+            if (pa == Snapshot::no_page && pb == Snapshot::no_page) {
+                continue;
+            }
+            if (pa == Snapshot::no_page || pb == Snapshot::no_page) {
+                append_range(ret, ChangedRange{.address = address, .size = page_size});
+                continue;
+            }
+            const auto data_a = before.page(pa).data();
+            const auto data_b = after.page(pb).data();
+            if (before.page_hash(pa) == after.page_hash(pb) && std::memcmp(data_a, data_b, page_size) == 0) {
+                continue;
+            }
+            page_ranges.clear();
+            diff_page(address, data_a, data_b, page_ranges);
+            for (const auto& range : page_ranges) {
+                append_range(ret, range);
+            }
+        }
+        if (a.region.base + a.region.size <= b.region.base + b.region.size) {
+            ia++;
+        } else {
+            ib++;
+        }
+    }
+    return ret;
+}
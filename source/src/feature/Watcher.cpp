@@ -0,0 +1,238 @@
+/**
+ * @file Watcher.cpp
+ * @author UnnamedOrange
+ * @brief Poll values on a single thread and notify subscribers of changes.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include "feature/Watcher.h"
+
+#include <algorithm>
+#include <tuple>
+#include <utility>
+
+#include "utils/macro.h"
+
+USING_MEMORY_READER_NAMESPACE;
+
+using Self = Watcher;
+
+Self::Watcher(const IReadMemory& reader) noexcept : reader(reader) {}
+
+Self::~Watcher() {
+    if (std::lock_guard _(m_state); true) {
+        should_exit = true;
+    }
+    cv_state.notify_all();
+    polling_thread.join();
+}
+
+void Self::polling_thread_routine() {
+    std::vector<std::shared_ptr<Entry>> due;
+    std::vector<std::pair<Callback, std::span<const std::byte>>> notifications;
+    std::function<void()> after_poll;
+
+    while (true) {
+        due.clear();
+        if (std::unique_lock lock(m_state); true) {
+            while (true) {
+                if (should_exit) {
+                    return;
+                }
+                auto now = clock::now();
+                auto next_due = clock::time_point::max();
+                for (const auto& entry : entries) {
+                    if (entry->next_due <= now) {
+                        entry->next_due = now + entry->period;
+                        due.push_back(entry);
+                    }
+                    next_due = (std::min)(next_due, entry->next_due);
+                }
+                if (!due.empty()) {
+                    break;
+                }
+                // Woken up by subscribe, unsubscribe or destruction as well.
+                if (next_due == clock::time_point::max()) {
+                    cv_state.wait(lock);
+                } else {
+                    cv_state.wait_until(lock, next_due);
+                }
+            }
+        }
+
+        // Read without holding the lock.
+        poll(due);
+
+        notifications.clear();
+        if (std::lock_guard _(m_state); true) {
+            after_poll = poll_callback;
+            for (const auto& entry : due) {
+                const bool changed = entry->incoming_ok ? !entry->value || *entry->value != entry->incoming //
+                                                        : entry->value.has_value();
+                if (changed) {
+                    if (entry->incoming_ok) {
+                        entry->value = entry->incoming;
+                    } else {
+                        entry->value.reset();
+                    }
+                }
+                // Before the first successful read, the value is regarded as unreadable.
+                auto value = entry->value ? std::span<const std::byte>(*entry->value) : std::span<const std::byte>{};
+                for (auto& subscriber : entry->subscribers) {
+                    if (changed || subscriber.fresh) {
+                        subscriber.fresh = false;
+                        notifications.emplace_back(subscriber.callback, value);
+                    }
+                }
+            }
+        }
+        // The values are only modified by this thread, so the spans are valid here.
+        for (const auto& [callback, value] : notifications) {
+            callback(value);
+        }
+        if (after_poll) {
+            after_poll();
+        }
+    }
+}
+void Self::poll(const std::vector<std::shared_ptr<Entry>>& due) const noexcept {
+    struct Item {
+        Entry* entry{};
+        std::uintptr_t address{};
+        std::size_t level{};
+        std::size_t size{};
+        std::size_t slot{};
+    };
+    std::vector<Item> items;
+    std::vector<std::size_t> order;
+    std::vector<ReadRequest> requests;
+    std::vector<std::size_t> request_offsets;
+    std::vector<std::byte> storage;
+
+    for (const auto& entry : due) {
+        const auto& target = entry->target;
+        entry->incoming.resize(target.size);
+        entry->incoming_ok = false;
+        auto first_offset = target.offsets.empty() ? std::intptr_t{} : target.offsets.front();
+        items.push_back(Item{
+            .entry = entry.get(),
+            .address = target.base + static_cast<std::uintptr_t>(first_offset),
+        });
+    }
+
+    // Each round reads one level of every chain still alive.
+    while (!items.empty()) {
+        for (auto& item : items) {
+            const auto& target = item.entry->target;
+            bool is_last = item.level + 1 >= target.offsets.size();
+            item.size = is_last ? target.size : static_cast<std::size_t>(target.width);
+        }
+
+        // Read identical ranges once.
+        order.resize(items.size());
+        for (std::size_t i = 0; i < order.size(); i++) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+            return std::tie(items[a].address, items[a].size) < std::tie(items[b].address, items[b].size);
+        });
+        requests.clear();
+        request_offsets.clear();
+        std::size_t total_size = 0;
+        for (std::size_t k = 0; k < order.size(); k++) {
+            auto& item = items[order[k]];
+            if (k == 0 || item.address != items[order[k - 1]].address || item.size != items[order[k - 1]].size) {
+                requests.push_back(ReadRequest{.address = item.address, .buf = nullptr, .size = item.size});
+                request_offsets.push_back(total_size);
+                total_size += item.size;
+            }
+            item.slot = requests.size() - 1;
+        }
+        storage.resize(total_size);
+        for (std::size_t k = 0; k < requests.size(); k++) {
+            requests[k].buf = storage.data() + request_offsets[k];
+        }
+        reader.read_to_bufs(requests);
+
+        std::size_t alive = 0;
+        for (auto& item : items) {
+            const auto& request = requests[item.slot];
+            if (!request.ok) {
+                continue;
+            }
+            const auto& target = item.entry->target;
+            if (item.level + 1 >= target.offsets.size()) {
+                std::memcpy(item.entry->incoming.data(), request.buf, item.size);
+                item.entry->incoming_ok = true;
+                continue;
+            }
+            std::uintptr_t ptr;
+            if (target.width == PtrWidth::IS_32) {
+                std::uint32_t buf;
+                std::memcpy(&buf, request.buf, sizeof(buf));
+                ptr = buf;
+            } else {
+                std::uint64_t buf;
+                std::memcpy(&buf, request.buf, sizeof(buf));
+                ptr = static_cast<std::uintptr_t>(buf);
+            }
+            item.level++;
+            item.address = ptr + static_cast<std::uintptr_t>(target.offsets[item.level]);
+            items[alive++] = item;
+        }
+        items.resize(alive);
+    }
+}
+
+Self::SubscriptionId Self::subscribe(const WatchTarget& target, clock::duration period, Callback callback) {
+    SubscriptionId id;
+    if (std::lock_guard _(m_state); true) {
+        id = next_id++;
+        auto it = std::find_if(entries.begin(), entries.end(),
+                               [&](const std::shared_ptr<Entry>& entry) { return entry->target == target; });
+        if (it == entries.end()) {
+            auto entry = std::make_shared<Entry>();
+            entry->target = target;
+            entry->period = period;
+            entries.push_back(std::move(entry));
+            it = entries.end() - 1;
+        }
+        auto& entry = **it;
+        entry.subscribers.push_back(Subscriber{.id = id, .period = period, .callback = std::move(callback)});
+        entry.period = (std::min)(entry.period, period);
+        // Let the new subscriber be notified as soon as possible.
+        entry.next_due = clock::time_point::min();
+    }
+    cv_state.notify_all();
+    return id;
+}
+void Self::unsubscribe(SubscriptionId id) {
+    if (std::lock_guard _(m_state); true) {
+        for (auto it = entries.begin(); it != entries.end(); ++it) {
+            auto& subscribers = (*it)->subscribers;
+            auto sub_it = std::find_if(subscribers.begin(), subscribers.end(),
+                                       [&](const Subscriber& subscriber) { return subscriber.id == id; });
+            if (sub_it == subscribers.end()) {
+                continue;
+            }
+            subscribers.erase(sub_it);
+            if (subscribers.empty()) {
+                entries.erase(it);
+            } else {
+                auto min_it = std::min_element(subscribers.begin(), subscribers.end(),
+                                               [](const Subscriber& a, const Subscriber& b) {
+                                                   return a.period < b.period;
+                                               });
+                (*it)->period = min_it->period;
+            }
+            break;
+        }
+    }
+    cv_state.notify_all();
+}
+void Self::set_poll_callback(std::function<void()> callback) {
+    std::lock_guard _(m_state);
+    poll_callback = std::move(callback);
+}
@@ -23,8 +23,9 @@ Self::AbstractProcess(Self&& other) noexcept {
 Self& Self::operator=(Self&& other) noexcept {
     // mutex and condition_variable cannot be moved, just default construct.
 
-    this->cache_hint = other.cache_hint;
-    other.cache_hint = 0;
+    this->generation = other.generation.exchange(0);
+    this->cache_hint = other.cache_hint.exchange(0);
+    this->validated_at = other.validated_at.exchange(0);
 
     this->has_interrupt = other.has_interrupt;
     other.interrupt_synchronize();
@@ -53,10 +54,25 @@ void Self::interrupt_synchronize() noexcept {
     cv_exit.notify_all();
 }
 
-int Self::get_cache_hint() const noexcept {
-    return cache_hint;
+std::uint64_t Self::get_cache_hint() const noexcept {
+    using clock = std::chrono::steady_clock;
+    const auto now = clock::now().time_since_epoch().count();
+    const auto interval = std::chrono::duration_cast<clock::duration>(identity_revalidation_interval).count();
+    // Concurrent callers may both revalidate. It does no harm.
+    if (now - validated_at.load(std::memory_order_relaxed) >= interval) {
+        revalidate_cache_hint();
+    }
+    return cache_hint.load(std::memory_order_relaxed);
 }
 
-void Self::update_cache_hint() noexcept {
-    cache_hint = ++global_cache_hint;
+std::uint64_t Self::identity() const noexcept {
+    return empty() ? 0 : generation.load(std::memory_order_relaxed);
+}
+void Self::update_cache_hint() const noexcept {
+    generation.store(++global_generation, std::memory_order_relaxed);
+    revalidate_cache_hint();
+}
+void Self::revalidate_cache_hint() const noexcept {
+    validated_at.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    cache_hint.store(identity(), std::memory_order_relaxed);
 }
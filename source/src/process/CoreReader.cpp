@@ -0,0 +1,304 @@
+/**
+ * @file CoreReader.cpp
+ * @author UnnamedOrange
+ * @brief Read memory captured in an ELF core file.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include "process/CoreReader.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "utils/macro.h"
+
+USING_MEMORY_READER_NAMESPACE;
+
+namespace {
+    constexpr std::uint8_t elf_class_32 = 1;
+    constexpr std::uint8_t elf_class_64 = 2;
+    constexpr std::uint8_t elf_data_little_endian = 1;
+    constexpr std::uint16_t elf_type_core = 4;
+    constexpr std::uint32_t program_type_load = 1;
+    constexpr std::uint32_t program_type_note = 4;
+    constexpr std::uint32_t note_type_file = 0x46494C45;
+    constexpr std::uint32_t program_flag_execute = 1;
+    constexpr std::uint32_t program_flag_write = 2;
+    constexpr std::uint32_t program_flag_read = 4;
+
+    /**
+     * @brief Fields of a program header common to both classes.
+     */
+    struct ProgramHeader {
+        std::uint32_t type;
+        std::uint32_t flags;
+        std::uint64_t offset;
+        std::uint64_t vaddr;
+        std::uint64_t filesz;
+        std::uint64_t memsz;
+    };
+
+    /**
+     * @brief A file mapping listed in the NT_FILE note.
+     */
+    struct FileMapping {
+        std::uint64_t start;
+        std::uint64_t end;
+        std::string path;
+    };
+
+    /**
+     * @brief Read a little-endian integer at @b offset of @b file.
+     */
+    template <typename T>
+    std::optional<T> load(std::span<const std::byte> file, std::uint64_t offset) noexcept {
+        if (offset > file.size() || file.size() - offset < sizeof(T)) {
+            return std::nullopt;
+        }
+        T ret;
+        std::memcpy(&ret, file.data() + offset, sizeof(T));
+        return ret;
+    }
+
+    std::optional<ProgramHeader> load_program_header(std::span<const std::byte> file, bool is_64,
+                                                     std::uint64_t offset) noexcept {
+        if (is_64) {
+            auto type = load<std::uint32_t>(file, offset);
+            auto flags = load<std::uint32_t>(file, offset + 0x04);
+            auto file_offset = load<std::uint64_t>(file, offset + 0x08);
+            auto vaddr = load<std::uint64_t>(file, offset + 0x10);
+            auto filesz = load<std::uint64_t>(file, offset + 0x20);
+            auto memsz = load<std::uint64_t>(file, offset + 0x28);
+            if (!type || !flags || !file_offset || !vaddr || !filesz || !memsz) {
+                return std::nullopt;
+            }
+            return ProgramHeader{*type, *flags, *file_offset, *vaddr, *filesz, *memsz};
+        }
+        auto type = load<std::uint32_t>(file, offset);
+        auto file_offset = load<std::uint32_t>(file, offset + 0x04);
+        auto vaddr = load<std::uint32_t>(file, offset + 0x08);
+        auto filesz = load<std::uint32_t>(file, offset + 0x10);
+        auto memsz = load<std::uint32_t>(file, offset + 0x14);
+        auto flags = load<std::uint32_t>(file, offset + 0x18);
+        if (!type || !flags || !file_offset || !vaddr || !filesz || !memsz) {
+            return std::nullopt;
+        }
+        return ProgramHeader{*type, *flags, *file_offset, *vaddr, *filesz, *memsz};
+    }
+
+    /**
+     * @brief Parse the description of an NT_FILE note:
+     * count, page size, count triples of (start, end, offset in pages), then count null-terminated paths.
+     * Malformed descriptions give as many mappings as can be parsed.
+     */
+    void parse_file_note(std::span<const std::byte> desc, bool is_64, std::vector<FileMapping>& out) {
+        const std::size_t word = is_64 ? 8 : 4;
+        auto load_word = [&](std::size_t offset) -> std::optional<std::uint64_t> {
+            if (is_64) {
+                return load<std::uint64_t>(desc, offset);
+            }
+            return load<std::uint32_t>(desc, offset);
+        };
+        auto count = load_word(0);
+        if (!count || *count > desc.size() / (3 * word)) {
+            return;
+        }
+        auto path_offset = 2 * word + *count * 3 * word;
+        for (std::uint64_t i = 0; i < *count && path_offset < desc.size(); i++) {
+            auto start = load_word(2 * word + i * 3 * word);
+            auto end = load_word(2 * word + i * 3 * word + word);
+            if (!start || !end) {
+                return;
+            }
+            auto path_begin = reinterpret_cast<const char*>(desc.data() + path_offset);
+            auto path_end = std::find(path_begin, reinterpret_cast<const char*>(desc.data() + desc.size()), '\0');
+            out.push_back(FileMapping{.start = *start, .end = *end, .path = std::string(path_begin, path_end)});
+            path_offset += static_cast<std::size_t>(path_end - path_begin) + 1;
+        }
+    }
+
+    void parse_notes(std::span<const std::byte> notes, bool is_64, std::vector<FileMapping>& out) {
+        // Notes of core files are aligned to 4 bytes in both classes.
+        auto align = [](std::uint64_t size) { return (size + 3) & ~std::uint64_t{3}; };
+        std::uint64_t offset = 0;
+        while (true) {
+            auto name_size = load<std::uint32_t>(notes, offset);
+            auto desc_size = load<std::uint32_t>(notes, offset + 4);
+            auto type = load<std::uint32_t>(notes, offset + 8);
+            if (!name_size || !desc_size || !type) {
+                return;
+            }
+            const auto desc_offset = offset + 12 + align(*name_size);
+            if (desc_offset > notes.size() || notes.size() - desc_offset < *desc_size) {
+                return;
+            }
+            if (*type == note_type_file) {
+                parse_file_note(notes.subspan(static_cast<std::size_t>(desc_offset), *desc_size), is_64, out);
+            }
+            offset = desc_offset + align(*desc_size);
+        }
+    }
+
+    std::atomic<std::uint64_t> next_cache_hint{1};
+} // namespace
+
+using Self = CoreReader;
+
+Self::CoreReader(Self&& other) noexcept
+    : view(std::exchange(other.view, nullptr)), view_size(std::exchange(other.view_size, 0)),
+      segments(std::move(other.segments)), cache_hint(std::exchange(other.cache_hint, 0)) {
+    other.segments.clear();
+}
+Self& Self::operator=(Self&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        view = std::exchange(other.view, nullptr);
+        view_size = std::exchange(other.view_size, 0);
+        segments = std::move(other.segments);
+        other.segments.clear();
+        cache_hint = std::exchange(other.cache_hint, 0);
+    }
+    return *this;
+}
+Self::~CoreReader() {
+    unmap();
+}
+
+Self Self::try_open(const std::filesystem::path& path) noexcept {
+    Self ret;
+    if (!ret.map_file(path)) {
+        return {};
+    }
+    try {
+        if (!ret.parse()) {
+            return {};
+        }
+    } catch (...) {
+        return {};
+    }
+    ret.cache_hint = next_cache_hint.fetch_add(1, std::memory_order_relaxed);
+    return ret;
+}
+
+bool Self::parse() {
+    const std::span<const std::byte> file(view, view_size);
+    constexpr std::array<std::byte, 4> magic{std::byte{0x7F}, std::byte{'E'}, std::byte{'L'}, std::byte{'F'}};
+    if (file.size() < 0x34 || !std::equal(magic.begin(), magic.end(), file.begin())) {
+        return false;
+    }
+    const auto elf_class = static_cast<std::uint8_t>(file[4]);
+    if ((elf_class != elf_class_32 && elf_class != elf_class_64) ||
+        static_cast<std::uint8_t>(file[5]) != elf_data_little_endian) {
+        return false;
+    }
+    const bool is_64 = elf_class == elf_class_64;
+    auto type = load<std::uint16_t>(file, 0x10);
+    std::optional<std::uint64_t> program_offset;
+    if (is_64) {
+        program_offset = load<std::uint64_t>(file, 0x20);
+    } else {
+        program_offset = load<std::uint32_t>(file, 0x1C);
+    }
+    auto program_entry_size = load<std::uint16_t>(file, is_64 ? 0x36 : 0x2A);
+    auto program_count = load<std::uint16_t>(file, is_64 ? 0x38 : 0x2C);
+    if (!type || *type != elf_type_core || !program_offset || !program_entry_size || !program_count) {
+        return false;
+    }
+
+    std::vector<FileMapping> files;
+    for (std::uint16_t i = 0; i < *program_count; i++) {
+        auto header = load_program_header(file, is_64, *program_offset + std::uint64_t{i} * *program_entry_size);
+        if (!header) {
+            return false;
+        }
+        if (header->offset > file.size()) {
+            continue;
+        }
+        // Truncated files keep what they have.
+        const auto stored = (std::min)(header->filesz, file.size() - header->offset);
+        if (header->type == program_type_note) {
+            parse_notes(file.subspan(static_cast<std::size_t>(header->offset), static_cast<std::size_t>(stored)),
+                        is_64, files);
+            continue;
+        }
+        // Bytes beyond filesz are not dumped, rather than zero-filled as in executables.
+        const auto size = (std::min)(stored, header->memsz);
+        if (header->type != program_type_load || !size) {
+            continue;
+        }
+        auto protection = RegionProtection::NONE;
+        if (header->flags & program_flag_read) {
+            protection = protection | RegionProtection::READ;
+        }
+        if (header->flags & program_flag_write) {
+            protection = protection | RegionProtection::WRITE;
+        }
+        if (header->flags & program_flag_execute) {
+            protection = protection | RegionProtection::EXECUTE;
+        }
+        segments.push_back(Segment{
+            .region = {.base = static_cast<std::uintptr_t>(header->vaddr),
+                       .size = static_cast<std::size_t>(size),
+                       .protection = protection},
+            .data = view + header->offset,
+        });
+    }
+
+    std::ranges::sort(segments, {}, [](const Segment& segment) { return segment.region.base; });
+    for (auto& segment : segments) {
+        auto it = std::find_if(files.begin(), files.end(), [&](const FileMapping& mapping) {
+            return mapping.start <= segment.region.base && segment.region.base < mapping.end;
+        });
+        if (it != files.end()) {
+            segment.region.path = it->path;
+        }
+    }
+    return true;
+}
+
+const Self::Segment* Self::find(std::uintptr_t address) const noexcept {
+    auto it = std::upper_bound(segments.begin(), segments.end(), address,
+                               [](std::uintptr_t lhs, const Segment& rhs) { return lhs < rhs.region.base; });
+    if (it == segments.begin()) {
+        return nullptr;
+    }
+    --it;
+    return address - it->region.base < it->region.size ? &*it : nullptr;
+}
+
+bool Self::read_to_buf(std::uintptr_t address, void* buf, std::size_t size) const noexcept {
+    auto out = static_cast<std::byte*>(buf);
+    // Adjacent segments are read through, like adjacent regions of a process.
+    while (size) {
+        auto segment = find(address);
+        if (!segment) {
+            return false;
+        }
+        const auto offset = address - segment->region.base;
+        const auto count = (std::min)(size, segment->region.size - offset);
+        std::memcpy(out, segment->data + offset, count);
+        out += count;
+        address += count;
+        size -= count;
+    }
+    return true;
+}
+std::vector<Region> Self::regions() const noexcept {
+    return query_regions(RegionFilter{.required = RegionProtection::EXECUTE});
+}
+std::vector<Region> Self::query_regions(const RegionFilter& filter) const noexcept {
+    std::vector<Region> ret;
+    for (const auto& segment : segments) {
+        if (filter.matches(segment.region)) {
+            ret.push_back(segment.region);
+        }
+    }
+    return ret;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file CoreReader_linux.cpp
+ * @author UnnamedOrange
+ * @brief Implement file mapping of @ref CoreReader on Linux.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#ifdef MEMORY_READER_TARGET_PLATFORM_LINUX
+
+#include "process/CoreReader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "utils/macro.h"
+
+USING_MEMORY_READER_NAMESPACE;
+
+using Self = CoreReader;
+
+bool Self::map_file(const std::filesystem::path& path) noexcept {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return false;
+    struct stat file {};
+    void* data = MAP_FAILED;
+    if (fstat(fd, &file) == 0 && file.st_size > 0)
+        data = mmap(nullptr, static_cast<std::size_t>(file.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps the file alive.
+    close(fd);
+    if (data == MAP_FAILED)
+        return false;
+
+    view = static_cast<const std::byte*>(data);
+    view_size = static_cast<std::size_t>(file.st_size);
+    return true;
+}
+
+void Self::unmap() noexcept {
+    if (view)
+        munmap(const_cast<std::byte*>(view), view_size);
+    view = nullptr;
+    view_size = 0;
+    segments.clear();
+}
+
+#endif
@@ -0,0 +1,52 @@
+/**
+ * @file CoreReader_windows.cpp
+ * @author UnnamedOrange
+ * @brief Implement file mapping of @ref CoreReader on Windows.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#ifdef MEMORY_READER_TARGET_PLATFORM_WIN32
+
+#include "process/CoreReader.h"
+
+#include <Windows.h>
+
+#include "utils/macro.h"
+
+USING_MEMORY_READER_NAMESPACE;
+
+using Self = CoreReader;
+
+bool Self::map_file(const std::filesystem::path& path) noexcept {
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER size{};
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+        mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    // The view keeps the mapping and the file alive.
+    if (mapping)
+        CloseHandle(mapping);
+    CloseHandle(file);
+    if (!data)
+        return false;
+
+    view = static_cast<const std::byte*>(data);
+    view_size = static_cast<std::size_t>(size.QuadPart);
+    return true;
+}
+
+void Self::unmap() noexcept {
+    if (view)
+        UnmapViewOfFile(view);
+    view = nullptr;
+    view_size = 0;
+    segments.clear();
+}
+
+#endif
@@ -0,0 +1,59 @@
+/**
+ * @file FileImageReader.cpp
+ * @author UnnamedOrange
+ * @brief Read a process, with the files of its executable regions mapped into the current process for scanning.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include "process/FileImageReader.h"
+
+#include <algorithm>
+
+#include "utils/macro.h"
+
+USING_MEMORY_READER_NAMESPACE;
+
+using Self = FileImageReader;
+
+Self::FileImageReader(const Process& process, const FileImageReaderOptions& options)
+    : process(process), options(options) {
+    refresh();
+}
+Self::~FileImageReader() {
+    unmap_all();
+}
+
+std::span<const std::byte> Self::find_image(std::uintptr_t address, std::size_t size) const noexcept {
+    if (images.empty() || process.get_cache_hint() != mapped_cache_hint) {
+        return {};
+    }
+    auto it = std::ranges::upper_bound(images, address, {}, &Image::base);
+    if (it == images.begin()) {
+        return {};
+    }
+    --it;
+    const auto offset = address - it->base;
+    if (offset >= it->size) {
+        return {};
+    }
+    return {it->data + offset, (std::min)(size, it->size - offset)};
+}
+
+bool Self::read_to_buf(std::uintptr_t address, void* buf, std::size_t size) const noexcept {
+    return process.read_to_buf(address, buf, size);
+}
+std::size_t Self::read_to_bufs(std::span<ReadRequest> requests) const noexcept {
+    return process.read_to_bufs(requests);
+}
+std::vector<Region> Self::regions() const noexcept {
+    return process.regions();
+}
+std::vector<Region> Self::query_regions(const RegionFilter& filter) const noexcept {
+    return process.query_regions(filter);
+}
+
+std::uint64_t Self::get_cache_hint() const noexcept {
+    return process.get_cache_hint();
+}
@@ -0,0 +1,53 @@
+/**
+ * @file FileImageReader_linux.cpp
+ * @author UnnamedOrange
+ * @brief Implement mapping of @ref FileImageReader on Linux.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#ifdef MEMORY_READER_TARGET_PLATFORM_LINUX
+
+#include "process/FileImageReader.h"
+
+#include <algorithm>
+
+#include <sys/mman.h>
+
+#include "ProcMaps_linux.h"
+#include "utils/macro.h"
+
+USING_MEMORY_READER_NAMESPACE;
+
+using Self = FileImageReader;
+
+void Self::refresh() {
+    unmap_all();
+    mapped_cache_hint = process.get_cache_hint();
+    const auto pid = process.pid();
+    if (!pid)
+        return;
+
+    for (const auto& entry : __detail::read_maps(pid)) {
+        // Shared mappings may be written through the file, so only private code is taken.
+        if (entry.perms[0] != 'r' || entry.perms[2] != 'x' || entry.perms[3] != 'p' || !entry.inode)
+            continue;
+        if (!entry.path.starts_with('/') || entry.path.ends_with(" (deleted)"))
+            continue;
+
+        auto data = __detail::map_backing_file(pid, entry, MAP_PRIVATE);
+        if (data.empty())
+            continue;
+        images.push_back(Image{.base = entry.start, .size = data.size(), .data = data.data()});
+    }
+    std::ranges::sort(images, {}, &Image::base);
+}
+
+void Self::unmap_all() noexcept {
+    for (const auto& image : images)
+        munmap(const_cast<std::byte*>(image.data), image.size);
+    images.clear();
+}
+
+#endif
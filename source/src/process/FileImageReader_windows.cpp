@@ -0,0 +1,31 @@
+/**
+ * @file FileImageReader_windows.cpp
+ * @author UnnamedOrange
+ * @brief Implement mapping of @ref FileImageReader on Windows.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#ifdef MEMORY_READER_TARGET_PLATFORM_WIN32
+
+#include "process/FileImageReader.h"
+
+#include "utils/macro.h"
+
+USING_MEMORY_READER_NAMESPACE;
+
+using Self = FileImageReader;
+
+void Self::refresh() {
+    // Sections of a loaded PE image are laid out by their virtual addresses rather than their file offsets,
+    // so the file cannot be scanned in place. Nothing is mapped.
+    unmap_all();
+    mapped_cache_hint = process.get_cache_hint();
+}
+
+void Self::unmap_all() noexcept {
+    images.clear();
+}
+
+#endif
@@ -0,0 +1,90 @@
+/**
+ * @file MappedReader.cpp
+ * @author UnnamedOrange
+ * @brief Read shared memory of a process by mapping it into the current process.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include "process/MappedReader.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "utils/macro.h"
+
+USING_MEMORY_READER_NAMESPACE;
+
+using Self = MappedReader;
+
+Self::MappedReader(const Process& process) : process(process) {
+    refresh();
+}
+Self::~MappedReader() {
+    unmap_all();
+}
+
+const Self::Mapping* Self::find(std::uintptr_t address, std::size_t size) const noexcept {
+    if (mappings.empty() || process.get_cache_hint() != mapped_cache_hint) {
+        return nullptr;
+    }
+    auto it = std::ranges::upper_bound(mappings, address, {}, &Mapping::base);
+    if (it == mappings.begin()) {
+        return nullptr;
+    }
+    --it;
+    const auto offset = address - it->base;
+    if (offset > it->size || it->size - offset < size) {
+        return nullptr;
+    }
+    return &*it;
+}
+
+bool Self::read_to_buf(std::uintptr_t address, void* buf, std::size_t size) const noexcept {
+    if (auto mapping = find(address, size)) {
+        std::memcpy(buf, mapping->data + (address - mapping->base), size);
+        return true;
+    }
+    return process.read_to_buf(address, buf, size);
+}
+std::size_t Self::read_to_bufs(std::span<ReadRequest> requests) const noexcept {
+    if (mappings.empty()) {
+        return process.read_to_bufs(requests);
+    }
+    std::size_t ret = 0;
+    std::vector<ReadRequest> rest;
+    std::vector<std::size_t> rest_indices;
+    try {
+        for (std::size_t i = 0; i < requests.size(); i++) {
+            auto& request = requests[i];
+            if (auto mapping = find(request.address, request.size)) {
+                std::memcpy(request.buf, mapping->data + (request.address - mapping->base), request.size);
+                request.ok = true;
+                ret++;
+            } else {
+                rest.push_back(request);
+                rest_indices.push_back(i);
+            }
+        }
+    } catch (...) {
+        // Out of memory. Let the process read everything.
+        return process.read_to_bufs(requests);
+    }
+    // Unmapped reads still go in one batch.
+    ret += process.read_to_bufs(rest);
+    for (std::size_t i = 0; i < rest.size(); i++) {
+        requests[rest_indices[i]].ok = rest[i].ok;
+    }
+    return ret;
+}
+std::vector<Region> Self::regions() const noexcept {
+    return process.regions();
+}
+std::vector<Region> Self::query_regions(const RegionFilter& filter) const noexcept {
+    return process.query_regions(filter);
+}
+
+std::uint64_t Self::get_cache_hint() const noexcept {
+    return process.get_cache_hint();
+}
@@ -0,0 +1,61 @@
+/**
+ * @file MappedReader_linux.cpp
+ * @author UnnamedOrange
+ * @brief Implement mapping of @ref MappedReader on Linux.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#ifdef MEMORY_READER_TARGET_PLATFORM_LINUX
+
+#include "process/MappedReader.h"
+
+#include <algorithm>
+#include <string_view>
+
+#include <sys/mman.h>
+
+#include "ProcMaps_linux.h"
+#include "utils/macro.h"
+
+USING_MEMORY_READER_NAMESPACE;
+
+using Self = MappedReader;
+
+/**
+ * @brief Whether the file backing a region can be mapped by another process.
+ */
+static bool is_shareable_file(std::string_view path) noexcept {
+    return path.starts_with("/dev/shm/") || path.starts_with("/memfd:");
+}
+
+void Self::refresh() {
+    unmap_all();
+    mapped_cache_hint = process.get_cache_hint();
+    const auto pid = process.pid();
+    if (!pid)
+        return;
+
+    for (const auto& entry : __detail::read_maps(pid)) {
+        // Private mappings may have diverged from the file by copy-on-write.
+        if (entry.perms[0] != 'r' || entry.perms[3] != 's')
+            continue;
+        if (!is_shareable_file(entry.path))
+            continue;
+
+        auto data = __detail::map_backing_file(pid, entry, MAP_SHARED);
+        if (data.empty())
+            continue;
+        mappings.push_back(Mapping{.base = entry.start, .size = data.size(), .data = data.data()});
+    }
+    std::ranges::sort(mappings, {}, &Mapping::base);
+}
+
+void Self::unmap_all() noexcept {
+    for (const auto& mapping : mappings)
+        munmap(const_cast<std::byte*>(mapping.data), mapping.size);
+    mappings.clear();
+}
+
+#endif
@@ -0,0 +1,30 @@
+/**
+ * @file MappedReader_windows.cpp
+ * @author UnnamedOrange
+ * @brief Implement mapping of @ref MappedReader on Windows.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#ifdef MEMORY_READER_TARGET_PLATFORM_WIN32
+
+#include "process/MappedReader.h"
+
+#include "utils/macro.h"
+
+USING_MEMORY_READER_NAMESPACE;
+
+using Self = MappedReader;
+
+void Self::refresh() {
+    // Sections of another process cannot be opened without knowing their names, so nothing is mapped.
+    unmap_all();
+    mapped_cache_hint = process.get_cache_hint();
+}
+
+void Self::unmap_all() noexcept {
+    mappings.clear();
+}
+
+#endif
@@ -0,0 +1,92 @@
+/**
+ * @file ProcMaps_linux.cpp
+ * @author UnnamedOrange
+ * @brief Parse /proc/<pid>/maps and map the files backing the regions listed there.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#ifdef MEMORY_READER_TARGET_PLATFORM_LINUX
+
+#include "ProcMaps_linux.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string_view>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <unistd.h>
+
+USING_MEMORY_READER_NAMESPACE;
+using namespace __detail;
+
+std::vector<MapsEntry> __detail::read_maps(std::uint32_t pid) {
+    std::vector<MapsEntry> ret;
+    std::ifstream ifs("/proc/" + std::to_string(pid) + "/maps");
+    if (ifs.fail())
+        return {};
+
+    std::string buf;
+    while (std::getline(ifs, buf)) {
+        // address perms offset dev inode pathname
+        MapsEntry entry;
+        int path_pos = 0;
+        auto result = std::sscanf(buf.c_str(), "%lx-%lx %4s %llx %x:%x %llu %n", &entry.start, &entry.end,
+                                  entry.perms.data(), &entry.offset, &entry.dev_major, &entry.dev_minor, &entry.inode,
+                                  &path_pos);
+        if (result != 7)
+            continue;
+        if (path_pos > 0 && static_cast<std::size_t>(path_pos) < buf.size())
+            entry.path = buf.substr(path_pos);
+        ret.push_back(std::move(entry));
+    }
+    return ret;
+}
+
+std::span<const std::byte> __detail::map_backing_file(std::uint32_t pid, const MapsEntry& entry, int flags) noexcept {
+    try {
+        std::array<char, 96> path;
+        std::snprintf(path.data(), path.size(), "/proc/%u/map_files/%lx-%lx", static_cast<unsigned>(pid), entry.start,
+                      entry.end);
+        int fd = open(path.data(), O_RDONLY | O_CLOEXEC);
+        // map_files works even if the file has been unlinked, e.g. memfd,
+        // while the path only works for linked files.
+        const bool by_path = fd == -1;
+        const std::string_view file_path = entry.path;
+        if (by_path && file_path.starts_with('/') && !file_path.ends_with(" (deleted)")) {
+            const auto root_path = "/proc/" + std::to_string(pid) + "/root" + entry.path;
+            fd = open(root_path.c_str(), O_RDONLY | O_CLOEXEC);
+        }
+        if (fd == -1)
+            return {};
+        struct stat file {};
+        if (fstat(fd, &file) != 0 || !S_ISREG(file.st_mode) ||
+            (by_path && (file.st_ino != entry.inode || major(file.st_dev) != entry.dev_major ||
+                         minor(file.st_dev) != entry.dev_minor))) {
+            // The file at the path has been replaced.
+            close(fd);
+            return {};
+        }
+        std::size_t size = 0;
+        if (static_cast<unsigned long long>(file.st_size) > entry.offset)
+            size = (std::min)(static_cast<std::size_t>(entry.end - entry.start),
+                              static_cast<std::size_t>(static_cast<unsigned long long>(file.st_size) - entry.offset));
+        void* data = MAP_FAILED;
+        if (size)
+            data = mmap(nullptr, size, PROT_READ, flags, fd, static_cast<off_t>(entry.offset));
+        close(fd);
+        if (data == MAP_FAILED)
+            return {};
+        return {static_cast<const std::byte*>(data), size};
+    } catch (...) {
+        return {};
+    }
+}
+
+#endif
@@ -0,0 +1,66 @@
+/**
+ * @file ProcMaps_linux.h
+ * @author UnnamedOrange
+ * @brief Parse /proc/<pid>/maps and map the files backing the regions listed there.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#pragma once
+
+#ifdef MEMORY_READER_TARGET_PLATFORM_LINUX
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "utils/macro.h"
+
+MEMORY_READER_NAMESPACE_BEGIN
+
+namespace __detail {
+    /**
+     * @brief A line of /proc/<pid>/maps.
+     */
+    struct MapsEntry {
+        std::uintptr_t start{};
+        std::uintptr_t end{};
+        /**
+         * @brief "rwxp" or "rwxs", with '-' for missing permissions.
+         */
+        std::array<char, 5> perms{};
+        unsigned long long offset{};
+        unsigned dev_major{};
+        unsigned dev_minor{};
+        unsigned long long inode{};
+        /**
+         * @brief The path of the backing file or a pseudo name like "[heap]". Empty if anonymous.
+         */
+        std::string path;
+    };
+
+    /**
+     * @brief Read all the lines of /proc/<pid>/maps. Empty on failure.
+     */
+    [[nodiscard]] std::vector<MapsEntry> read_maps(std::uint32_t pid);
+
+    /**
+     * @brief Map the file backing @b entry read-only, with @b flags being MAP_PRIVATE or MAP_SHARED.
+     *
+     * The file the process mapped is opened by /proc/<pid>/map_files, which may be denied without CAP_SYS_ADMIN.
+     * It then falls back to the path seen from the root of the process, if the file there is still the mapped one.
+     * Pages beyond the end of the file raise SIGBUS, so the mapping is cut at the end of the file.
+     *
+     * @return std::span<const std::byte> The mapped bytes, to be unmapped by munmap. Empty on failure.
+     */
+    [[nodiscard]] std::span<const std::byte> map_backing_file(std::uint32_t pid, const MapsEntry& entry,
+                                                             int flags) noexcept;
+} // namespace __detail
+
+MEMORY_READER_NAMESPACE_END
+
+#endif
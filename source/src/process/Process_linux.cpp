@@ -11,45 +11,97 @@
 
 #include "process/Process.h"
 
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <climits>
+#include <cstdio>
 #include <filesystem>
-#include <fstream>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
 
+#include <fcntl.h>
+#include <sys/stat.h>
 #include <sys/uio.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include "ProcMaps_linux.h"
 #include "utils/macro.h"
 
 USING_MEMORY_READER_NAMESPACE;
 
+/**
+ * @brief Read a small file under /proc at once, without iostreams.
+ *
+ * @return std::size_t The number of bytes read. 0 on failure.
+ */
+static std::size_t read_proc_file(pid_t pid, const char* name, char* buf, std::size_t size) noexcept {
+    std::array<char, 64> path;
+    std::snprintf(path.data(), path.size(), "/proc/%d/%s", static_cast<int>(pid), name);
+    int fd = open(path.data(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return 0;
+    std::size_t ret = 0;
+    while (ret < size) {
+        auto result = read(fd, buf + ret, size - ret);
+        if (result <= 0)
+            break;
+        ret += static_cast<std::size_t>(result);
+    }
+    close(fd);
+    return ret;
+}
+
+/**
+ * @brief Get the start time of the process, in clock ticks since boot. 0 on failure.
+ */
 static std::uint64_t get_start_time(pid_t pid) noexcept {
     if (!pid)
         return 0;
-    std::ifstream ifs("/proc/" + std::to_string(pid) + "/stat");
-    if (ifs.fail())
-        return 0;
+    std::array<char, 2048> buf;
+    auto size = read_proc_file(pid, "stat", buf.data(), buf.size());
+    std::string_view sv(buf.data(), size);
 
-    std::string buf;
-    std::getline(ifs, buf);
-    std::string_view sv(buf);
-    for (size_t i = 0; i < 21; ++i) {
-        auto pos = sv.find(' ');
+    // The command name may contain spaces and parentheses, so skip to the last ')'.
+    auto pos = sv.rfind(')');
+    if (pos == std::string_view::npos)
+        return 0;
+    sv.remove_prefix(pos + 1);
+    // The first field after the command name is field 3. The start time is field 22.
+    for (std::size_t i = 0; i < 20; ++i) {
+        pos = sv.find(' ');
         if (pos == std::string_view::npos)
             return 0;
         sv.remove_prefix(pos + 1);
     }
-    sv.remove_suffix(sv.size() - sv.find(' '));
 
-    std::uint64_t ret;
-    try {
-        ret = std::stoi(std::string(sv));
-    } catch (...) {
+    std::uint64_t ret{};
+    if (std::from_chars(sv.data(), sv.data() + sv.size(), ret).ec != std::errc{})
         return 0;
-    }
+    return ret;
+}
+
+/**
+ * @brief Get a value which changes on every exec in the process, even if the PID stays the same.
+ *
+ * The auxiliary vector holds addresses like AT_RANDOM and AT_BASE, which are set by each exec.
+ * The device and the inode of the executable are mixed in, in case address randomization is disabled.
+ */
+static std::uint64_t get_exec_generation(pid_t pid) noexcept {
+    std::uint64_t ret = 0;
+    std::array<std::uint64_t, 128> auxv{};
+    auto size = read_proc_file(pid, "auxv", reinterpret_cast<char*>(auxv.data()), sizeof(auxv));
+    for (std::size_t i = 0; i < size / sizeof(std::uint64_t); i++)
+        ret = ret * 0x100000001B3 ^ auxv[i];
+
+    std::array<char, 64> path;
+    std::snprintf(path.data(), path.size(), "/proc/%d/exe", static_cast<int>(pid));
+    struct stat exe {};
+    if (stat(path.data(), &exe) == 0)
+        ret = ret * 0x100000001B3 ^ (static_cast<std::uint64_t>(exe.st_dev) << 32 ^ exe.st_ino);
     return ret;
 }
 
@@ -84,6 +136,7 @@ Self& Self::operator=(Self&& other) noexcept {
 
         other.pimpl->pid = 0;
         other.pimpl->start_time = 0;
+        update_cache_hint();
     }
     return *this;
 }
@@ -137,12 +190,28 @@ Self Self::try_from_process_name(const std::string& process_name) noexcept {
     return {};
 }
 
+std::uint32_t Self::pid() const noexcept {
+    return static_cast<std::uint32_t>(pimpl->pid);
+}
 bool Self::empty() const noexcept {
     return !pimpl->pid;
 }
 void Self::reset() noexcept {
     pimpl->pid = 0;
     pimpl->start_time = 0;
+    update_cache_hint();
+}
+std::uint64_t Self::identity() const noexcept {
+    auto pid = pimpl->pid;
+    if (!pid)
+        return 0;
+    auto start_time = get_start_time(pid);
+    if (!start_time || start_time != pimpl->start_time)
+        return 0;
+    auto ret = combine_identity(static_cast<std::uint64_t>(pid), start_time);
+    ret = combine_identity(ret, get_exec_generation(pid));
+    // 0 is reserved for empty.
+    return ret ? ret : 1;
 }
 
 bool Self::read_to_buf(std::uintptr_t address, void* buf, std::size_t size) const noexcept {
@@ -160,26 +229,61 @@ bool Self::read_to_buf(std::uintptr_t address, void* buf, std::size_t size) cons
         return static_cast<std::size_t>(result) == size;
     return false;
 }
-std::vector<Region> Self::regions() const noexcept {
-    std::vector<Region> ret;
+std::size_t Self::read_to_bufs(std::span<ReadRequest> requests) const noexcept {
+    // A single process_vm_readv accepts at most IOV_MAX iovecs on each side.
+    constexpr std::size_t max_batch = IOV_MAX;
+    std::array<iovec, max_batch> local;
+    std::array<iovec, max_batch> remote;
 
-    std::ifstream ifs("/proc/" + std::to_string(pimpl->pid) + "/maps");
-    if (ifs.fail())
-        return {};
+    std::size_t ret = 0;
+    std::size_t i = 0;
+    while (i < requests.size()) {
+        std::size_t count = (std::min)(requests.size() - i, max_batch);
+        for (std::size_t j = 0; j < count; j++) {
+            const auto& request = requests[i + j];
+            local[j] = {.iov_base = request.buf, .iov_len = request.size};
+            remote[j] = {.iov_base = reinterpret_cast<void*>(request.address), .iov_len = request.size};
+        }
+        auto result = process_vm_readv(pimpl->pid, local.data(), count, remote.data(), count, 0);
+        auto transferred = result == -1 ? std::size_t{} : static_cast<std::size_t>(result);
 
-    std::string buf;
-    while (std::getline(ifs, buf)) {
-        std::uintptr_t start, end;
-        std::array<char, 5> perms;
-        auto result = std::sscanf(buf.c_str(), "%lx-%lx%4s", &start, &end, perms.data());
-        if (result != 3)
-            continue;
-        if (perms[0] == 'r' && perms[2] == 'x') {
-            ret.emplace_back(Region{
-                .base = start,
-                .size = static_cast<size_t>(end - start),
-            });
+        // The transfer stops at the first failed remote iovec.
+        // Requests before it have succeeded, and the one it stops at has failed.
+        std::size_t j = 0;
+        for (; j < count && transferred >= requests[i + j].size; j++) {
+            transferred -= requests[i + j].size;
+            requests[i + j].ok = true;
+            ret++;
         }
+        if (j < count) {
+            requests[i + j].ok = false;
+            j++;
+        }
+        // Continue after the failed one.
+        i += j;
+    }
+    return ret;
+}
+std::vector<Region> Self::regions() const noexcept {
+    return query_regions(RegionFilter{.required = RegionProtection::READ | RegionProtection::EXECUTE});
+}
+std::vector<Region> Self::query_regions(const RegionFilter& filter) const noexcept {
+    std::vector<Region> ret;
+    for (auto& entry : __detail::read_maps(pimpl->pid)) {
+        Region region{
+            .base = entry.start,
+            .size = static_cast<size_t>(entry.end - entry.start),
+        };
+        if (entry.perms[0] == 'r')
+            region.protection = region.protection | RegionProtection::READ;
+        if (entry.perms[1] == 'w')
+            region.protection = region.protection | RegionProtection::WRITE;
+        if (entry.perms[2] == 'x')
+            region.protection = region.protection | RegionProtection::EXECUTE;
+        region.path = std::move(entry.path);
+
+        if (filter.matches(region))
+            ret.push_back(std::move(region));
     }
     return ret;
 }
@@ -187,13 +291,9 @@ std::vector<Region> Self::regions() const noexcept {
 bool Self::still_alive() const noexcept {
     if (empty())
         return false;
-    namespace fs = std::filesystem;
-    auto pid = pimpl->pid;
-    if (!fs::exists("/proc/" + std::to_string(pid)))
-        return false;
-    if (get_start_time(pid) != pimpl->start_time)
-        return false;
-    return true;
+    // The start time cannot be read if the process has gone, and differs if the PID is reused.
+    auto start_time = get_start_time(pimpl->pid);
+    return start_time && start_time == pimpl->start_time;
 }
 
 #endif
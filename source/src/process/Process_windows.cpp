@@ -11,9 +11,12 @@
 
 #include "process/Process.h"
 
+#include <array>
+#include <string_view>
 #include <utility>
 
 #include <Windows.h>
+#include <psapi.h>
 #include <tlhelp32.h>
 
 #include "utils/codecvt.h"
@@ -37,6 +40,7 @@ Self& Self::operator=(Self&& other) noexcept {
         Self::reset();
         pimpl->handle = other.pimpl->handle;
         other.pimpl->handle = nullptr;
+        update_cache_hint();
     }
     return *this;
 }
@@ -97,6 +101,11 @@ Self Self::try_from_process_name(const std::string& process_name) noexcept {
     return {};
 }
 
+std::uint32_t Self::pid() const noexcept {
+    if (empty())
+        return 0;
+    return GetProcessId(pimpl->handle);
+}
 bool Self::empty() const noexcept {
     return !pimpl->handle;
 }
@@ -105,15 +114,56 @@ void Self::reset() noexcept {
         CloseHandle(handle);
         handle = nullptr;
     }
+    update_cache_hint();
+}
+std::uint64_t Self::identity() const noexcept {
+    if (empty())
+        return 0;
+    // There is no exec on Windows, so the PID and the creation time identify the image.
+    FILETIME creation_time{}, exit_time{}, kernel_time{}, user_time{};
+    if (!GetProcessTimes(pimpl->handle, &creation_time, &exit_time, &kernel_time, &user_time))
+        return 0;
+    auto creation = static_cast<std::uint64_t>(creation_time.dwHighDateTime) << 32 | creation_time.dwLowDateTime;
+    auto ret = combine_identity(GetProcessId(pimpl->handle), creation);
+    // 0 is reserved for empty.
+    return ret ? ret : 1;
 }
 
 bool Self::read_to_buf(std::uintptr_t address, void* buf, std::size_t size) const noexcept {
     SIZE_T read{};
     return ReadProcessMemory(pimpl->handle, reinterpret_cast<LPCVOID>(address), buf, size, &read) && read == size;
 }
+std::size_t Self::read_to_bufs(std::span<ReadRequest> requests) const noexcept {
+    // There is no vectored ReadProcessMemory.
+    return Super::read_to_bufs(requests);
+}
 std::vector<Region> Self::regions() const noexcept {
+    return query_regions(RegionFilter{.required = RegionProtection::READ | RegionProtection::EXECUTE});
+}
+std::vector<Region> Self::query_regions(const RegionFilter& filter) const noexcept {
+    constexpr auto to_protection = [](DWORD protect) noexcept {
+        using enum RegionProtection;
+        if (protect & (PAGE_GUARD | PAGE_NOACCESS))
+            return NONE;
+        if (protect & (PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY))
+            return READ | WRITE | EXECUTE;
+        if (protect & PAGE_EXECUTE_READ)
+            return READ | EXECUTE;
+        if (protect & PAGE_EXECUTE)
+            return EXECUTE;
+        if (protect & (PAGE_READWRITE | PAGE_WRITECOPY))
+            return READ | WRITE;
+        if (protect & PAGE_READONLY)
+            return READ;
+        return NONE;
+    };
+
     std::vector<Region> ret;
 
+    // The path is only queried for regions passing the other conditions.
+    RegionFilter filter_without_path = filter;
+    filter_without_path.path_contains.clear();
+
     SYSTEM_INFO sys_info;
     GetSystemInfo(&sys_info);
     auto min_address = sys_info.lpMinimumApplicationAddress;
@@ -126,12 +176,27 @@ std::vector<Region> Self::regions() const noexcept {
         if (!VirtualQueryEx(crt_handle, crt_address, &mem_info, sizeof(mem_info)))
             return {};
 
-        if ((mem_info.Protect & (PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE)) && //
-            (mem_info.State == MEM_COMMIT)) {
-            ret.emplace_back(Region{
+        if (mem_info.State == MEM_COMMIT) {
+            Region region{
                 .base = reinterpret_cast<std::uintptr_t>(mem_info.BaseAddress),
                 .size = static_cast<std::size_t>(mem_info.RegionSize),
-            });
+                .protection = to_protection(mem_info.Protect),
+            };
+            if (filter_without_path.matches(region) && (mem_info.Type & (MEM_IMAGE | MEM_MAPPED))) {
+                // The path is in the form of a device path, which is enough to identify the file.
+                std::array<wchar_t, MAX_PATH> path;
+                auto length = GetMappedFileNameW(crt_handle, mem_info.BaseAddress, path.data(),
+                                                 static_cast<DWORD>(path.size()));
+                if (length) {
+                    try {
+                        region.path = codecvt::to_string(std::wstring_view(path.data(), length));
+                    } catch (...) {
+                    }
+                }
+            }
+            if (filter.matches(region)) {
+                ret.push_back(std::move(region));
+            }
         }
         crt_address = (PVOID)((uintptr_t)(crt_address) + mem_info.RegionSize);
     }
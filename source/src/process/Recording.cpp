@@ -0,0 +1,546 @@
+/**
+ * @file Recording.cpp
+ * @author UnnamedOrange
+ * @brief Record the reads of a session to a file, and replay them without the process.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include "process/Recording.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "utils/macro.h"
+
+USING_MEMORY_READER_NAMESPACE;
+
+/*
+ * File format:
+ * The magic, then records until the end of the file. Integers are LEB128 varints.
+ * Each record is a tag byte, the time since the previous record, the duration of the call, then:
+ * - tag_read: address, size, ok byte, and the bytes if ok.
+ * - tag_reads: count, then count reads as above.
+ * - tag_regions: the filter queried with, as required and excluded protection bytes, min address, max address,
+ *   max size, path size and path, then count, then for each region base, size, protection byte, path size and path.
+ * - tag_cache_hint: the cache hint.
+ */
+namespace {
+    constexpr std::array<char, 8> file_magic{'M', 'R', 'R', 'E', 'C', '0', '0', '1'};
+    constexpr std::uint8_t tag_read = 1;
+    constexpr std::uint8_t tag_reads = 2;
+    constexpr std::uint8_t tag_regions = 3;
+    constexpr std::uint8_t tag_cache_hint = 4;
+    /**
+     * @brief Granularity of @ref Recording::page_index.
+     */
+    constexpr std::size_t index_page_size = 0x1000;
+    /**
+     * @brief Recorded for @ref IReadMemory::regions. Regions matching it are returned by every implementation.
+     */
+    const RegionFilter executable_filter{.required = RegionProtection::READ | RegionProtection::EXECUTE};
+
+    void put_varint(std::vector<std::byte>& out, std::uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<std::byte>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<std::byte>(value));
+    }
+    void put_bytes(std::vector<std::byte>& out, const void* data, std::size_t size) {
+        auto begin = static_cast<const std::byte*>(data);
+        out.insert(out.end(), begin, begin + size);
+    }
+    void put_read(std::vector<std::byte>& out, std::uintptr_t address, const void* buf, std::size_t size, bool ok) {
+        put_varint(out, address);
+        put_varint(out, size);
+        out.push_back(std::byte{ok});
+        if (ok) {
+            put_bytes(out, buf, size);
+        }
+    }
+
+    /**
+     * @brief Cursor over the bytes of a file. Every getter fails once the end is passed.
+     */
+    class Cursor {
+    private:
+        std::span<const std::byte> bytes;
+        std::size_t offset = 0;
+
+    public:
+        explicit Cursor(std::span<const std::byte> bytes) noexcept : bytes(bytes) {}
+
+        [[nodiscard]] bool at_end() const noexcept {
+            return offset == bytes.size();
+        }
+        std::optional<std::uint64_t> varint() noexcept {
+            std::uint64_t ret = 0;
+            for (unsigned shift = 0; shift < 64 && offset < bytes.size(); shift += 7) {
+                const auto byte = static_cast<std::uint8_t>(bytes[offset++]);
+                ret |= std::uint64_t{byte & 0x7Fu} << shift;
+                if (!(byte & 0x80)) {
+                    return ret;
+                }
+            }
+            return std::nullopt;
+        }
+        std::optional<std::uint8_t> byte() noexcept {
+            if (offset >= bytes.size()) {
+                return std::nullopt;
+            }
+            return static_cast<std::uint8_t>(bytes[offset++]);
+        }
+        std::optional<std::span<const std::byte>> take(std::uint64_t size) noexcept {
+            if (size > bytes.size() - offset) {
+                return std::nullopt;
+            }
+            auto ret = bytes.subspan(offset, static_cast<std::size_t>(size));
+            offset += static_cast<std::size_t>(size);
+            return ret;
+        }
+    };
+
+    std::size_t latency_bucket(std::size_t size) noexcept {
+        return static_cast<std::size_t>(std::bit_width(size));
+    }
+} // namespace
+
+RecordingReader::RecordingReader(const IReadMemory& reader, const std::filesystem::path& path)
+    : reader(reader), hinted_reader(dynamic_cast<const IReadMemoryWithCacheHint*>(&reader)), started(clock::now()),
+      ofs(path, std::ios::binary | std::ios::trunc) {
+    ofs.write(file_magic.data(), file_magic.size());
+}
+
+void RecordingReader::begin_record(std::uint8_t tag, clock::time_point start) const {
+    const auto now = clock::now();
+    const auto time = (std::max)(last_time, std::chrono::duration_cast<std::chrono::nanoseconds>(now - started));
+    record.clear();
+    record.push_back(std::byte{tag});
+    put_varint(record, static_cast<std::uint64_t>((time - last_time).count()));
+    put_varint(record, static_cast<std::uint64_t>(std::chrono::nanoseconds(now - start).count()));
+    last_time = time;
+}
+void RecordingReader::commit_record() const {
+    ofs.write(reinterpret_cast<const char*>(record.data()), static_cast<std::streamsize>(record.size()));
+}
+void RecordingReader::record_regions(const RegionFilter& filter, const std::vector<Region>& regions,
+                                     clock::time_point start) const noexcept {
+    std::lock_guard _(m_file);
+    try {
+        begin_record(tag_regions, start);
+        record.push_back(static_cast<std::byte>(filter.required));
+        record.push_back(static_cast<std::byte>(filter.excluded));
+        put_varint(record, filter.min_address);
+        put_varint(record, filter.max_address);
+        put_varint(record, filter.max_size);
+        put_varint(record, filter.path_contains.size());
+        put_bytes(record, filter.path_contains.data(), filter.path_contains.size());
+        put_varint(record, regions.size());
+        for (const auto& region : regions) {
+            put_varint(record, region.base);
+            put_varint(record, region.size);
+            record.push_back(static_cast<std::byte>(region.protection));
+            put_varint(record, region.path.size());
+            put_bytes(record, region.path.data(), region.path.size());
+        }
+        commit_record();
+    } catch (...) {
+        ofs.setstate(std::ios::badbit);
+    }
+}
+
+bool RecordingReader::good() const noexcept {
+    std::lock_guard _(m_file);
+    return ofs.good();
+}
+void RecordingReader::flush() noexcept {
+    std::lock_guard _(m_file);
+    ofs.flush();
+}
+
+bool RecordingReader::read_to_buf(std::uintptr_t address, void* buf, std::size_t size) const noexcept {
+    const auto start = clock::now();
+    const bool ret = reader.read_to_buf(address, buf, size);
+    std::lock_guard _(m_file);
+    try {
+        begin_record(tag_read, start);
+        put_read(record, address, buf, size, ret);
+        commit_record();
+    } catch (...) {
+        ofs.setstate(std::ios::badbit);
+    }
+    return ret;
+}
+std::size_t RecordingReader::read_to_bufs(std::span<ReadRequest> requests) const noexcept {
+    const auto start = clock::now();
+    const auto ret = reader.read_to_bufs(requests);
+    std::lock_guard _(m_file);
+    try {
+        begin_record(tag_reads, start);
+        put_varint(record, requests.size());
+        for (const auto& request : requests) {
+            put_read(record, request.address, request.buf, request.size, request.ok);
+        }
+        commit_record();
+    } catch (...) {
+        ofs.setstate(std::ios::badbit);
+    }
+    return ret;
+}
+std::vector<Region> RecordingReader::regions() const noexcept {
+    const auto start = clock::now();
+    auto ret = reader.regions();
+    record_regions(executable_filter, ret, start);
+    return ret;
+}
+std::vector<Region> RecordingReader::query_regions(const RegionFilter& filter) const noexcept {
+    const auto start = clock::now();
+    auto ret = reader.query_regions(filter);
+    record_regions(filter, ret, start);
+    return ret;
+}
+
+std::uint64_t RecordingReader::get_cache_hint() const noexcept {
+    const auto start = clock::now();
+    const auto ret = hinted_reader ? hinted_reader->get_cache_hint() : std::uint64_t{1};
+    std::lock_guard _(m_file);
+    try {
+        if (last_cache_hint == ret) {
+            return ret;
+        }
+        last_cache_hint = ret;
+        begin_record(tag_cache_hint, start);
+        put_varint(record, ret);
+        commit_record();
+    } catch (...) {
+        ofs.setstate(std::ios::badbit);
+    }
+    return ret;
+}
+
+std::optional<Recording> Recording::load(const std::filesystem::path& path) noexcept {
+    try {
+        std::ifstream ifs(path, std::ios::binary);
+        std::array<char, file_magic.size()> magic;
+        if (!ifs || !ifs.read(magic.data(), magic.size()) || magic != file_magic) {
+            return std::nullopt;
+        }
+        std::vector<std::byte> bytes;
+        std::transform(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>(),
+                       std::back_inserter(bytes), [](char c) { return static_cast<std::byte>(c); });
+
+        Recording ret;
+        Cursor cursor(bytes);
+        std::chrono::nanoseconds time{};
+        // Parse one record at a time, so that a truncated record is dropped as a whole.
+        auto parse_read = [](Cursor& record, std::vector<std::pair<Read, std::span<const std::byte>>>& out) {
+            auto address = record.varint();
+            auto size = record.varint();
+            auto ok = record.byte();
+            if (!address || !size || !ok) {
+                return false;
+            }
+            std::span<const std::byte> data;
+            if (*ok) {
+                auto taken = record.take(*size);
+                if (!taken) {
+                    return false;
+                }
+                data = *taken;
+            }
+            out.emplace_back(Read{.time = {},
+                                  .address = static_cast<std::uintptr_t>(*address),
+                                  .size = static_cast<std::size_t>(*size),
+                                  .data_offset = 0,
+                                  .ok = *ok != 0},
+                             data);
+            return true;
+        };
+
+        std::vector<std::pair<Read, std::span<const std::byte>>> reads;
+        while (!cursor.at_end()) {
+            auto record = cursor;
+            auto tag = record.byte();
+            auto delta = record.varint();
+            auto duration = record.varint();
+            if (!tag || !delta || !duration) {
+                break;
+            }
+            const auto record_time = time + std::chrono::nanoseconds(*delta);
+            const auto call_duration = std::chrono::nanoseconds(*duration);
+            bool ok = true;
+            reads.clear();
+            switch (*tag) {
+            case tag_read: ok = parse_read(record, reads); break;
+            case tag_reads: {
+                auto count = record.varint();
+                ok = count.has_value();
+                for (std::uint64_t i = 0; ok && i < *count; i++) {
+                    ok = parse_read(record, reads);
+                }
+                break;
+            }
+            case tag_regions: {
+                auto required = record.byte();
+                auto excluded = record.byte();
+                auto min_address = record.varint();
+                auto max_address = record.varint();
+                auto max_size = record.varint();
+                auto path_contains_size = record.varint();
+                auto path_contains = path_contains_size ? record.take(*path_contains_size) : std::nullopt;
+                auto count = record.varint();
+                ok = required && excluded && min_address && max_address && max_size && path_contains && count;
+                RegionList list{.time = record_time, .filter = {}, .regions = {}};
+                if (ok) {
+                    list.filter = RegionFilter{
+                        .required = static_cast<RegionProtection>(*required),
+                        .excluded = static_cast<RegionProtection>(*excluded),
+                        .min_address = static_cast<std::uintptr_t>(*min_address),
+                        .max_address = static_cast<std::uintptr_t>(*max_address),
+                        .max_size = static_cast<std::size_t>(*max_size),
+                        .path_contains = std::string(reinterpret_cast<const char*>(path_contains->data()),
+                                                     path_contains->size()),
+                    };
+                }
+                for (std::uint64_t i = 0; ok && i < *count; i++) {
+                    auto base = record.varint();
+                    auto size = record.varint();
+                    auto protection = record.byte();
+                    auto path_size = record.varint();
+                    auto path = path_size ? record.take(*path_size) : std::nullopt;
+                    if (!base || !size || !protection || !path) {
+                        ok = false;
+                        break;
+                    }
+                    list.regions.push_back(Region{
+                        .base = static_cast<std::uintptr_t>(*base),
+                        .size = static_cast<std::size_t>(*size),
+                        .protection = static_cast<RegionProtection>(*protection),
+                        .path = std::string(reinterpret_cast<const char*>(path->data()), path->size()),
+                    });
+                }
+                if (ok) {
+                    ret.region_lists.push_back(std::move(list));
+                }
+                break;
+            }
+            case tag_cache_hint: {
+                auto value = record.varint();
+                ok = value.has_value();
+                if (ok) {
+                    ret.cache_hints.push_back(CacheHint{.time = record_time, .value = *value});
+                }
+                break;
+            }
+            default: ok = false; break;
+            }
+            if (!ok) {
+                break;
+            }
+
+            time = record_time;
+            std::size_t total = 0;
+            for (auto& [read, data] : reads) {
+                read.time = time;
+                ret.add_read(read, data);
+                total += read.size;
+            }
+            if (*tag == tag_read || *tag == tag_reads) {
+                auto& bucket = ret.latency_table[*tag == tag_reads][latency_bucket(total)];
+                bucket.total += call_duration;
+                bucket.count++;
+            }
+            ret.total_duration = time;
+            cursor = record;
+        }
+        return ret;
+    } catch (...) {
+        return std::nullopt;
+    }
+}
+
+void Recording::add_read(Read read, std::span<const std::byte> data) {
+    const auto index = static_cast<std::uint32_t>(read_list.size());
+    if (read.ok) {
+        read.data_offset = data_pool.size();
+        data_pool.insert(data_pool.end(), data.begin(), data.end());
+        if (read.size) {
+            const auto first_page = read.address / index_page_size;
+            const auto last_page = (read.address + read.size - 1) / index_page_size;
+            for (auto page = first_page; page <= last_page; page++) {
+                page_index[page].push_back(index);
+            }
+        }
+    }
+    read_list.push_back(read);
+}
+
+bool Recording::read_at(std::chrono::nanoseconds position, std::uintptr_t address, void* buf,
+                   std::size_t size) const noexcept {
+    if (!size) {
+        return true;
+    }
+    try {
+        auto out = static_cast<std::byte*>(buf);
+        // Address ranges of the current page not filled yet.
+        std::vector<std::pair<std::uintptr_t, std::uintptr_t>> gaps;
+        std::vector<std::pair<std::uintptr_t, std::uintptr_t>> next_gaps;
+        auto apply = [&](const Read& read) {
+            next_gaps.clear();
+            for (auto [begin, end] : gaps) {
+                const auto copy_begin = (std::max)(begin, read.address);
+                const auto copy_end = (std::min)(end, read.address + read.size);
+                if (copy_begin >= copy_end) {
+                    next_gaps.emplace_back(begin, end);
+                    continue;
+                }
+                std::memcpy(out + (copy_begin - address),
+                            data_pool.data() + read.data_offset + (copy_begin - read.address), copy_end - copy_begin);
+                if (begin < copy_begin) {
+                    next_gaps.emplace_back(begin, copy_begin);
+                }
+                if (copy_end < end) {
+                    next_gaps.emplace_back(copy_end, end);
+                }
+            }
+            gaps.swap(next_gaps);
+        };
+
+        bool ret = true;
+        const auto first_page = address / index_page_size;
+        const auto last_page = (address + size - 1) / index_page_size;
+        for (auto page = first_page; page <= last_page; page++) {
+            auto it = page_index.find(page);
+            if (it == page_index.end()) {
+                ret = false;
+                continue;
+            }
+            gaps.assign(1, {(std::max)(address, page * index_page_size),
+                            (std::min)(address + size, (page + 1) * index_page_size)});
+            // Reads of the page are in order of time. Reads at or before the position go first,
+            // the latest preferred, then reads after it fill in bytes not seen yet, the earliest preferred.
+            const auto& indices = it->second;
+            const auto split = std::partition_point(indices.begin(), indices.end(), [&](std::uint32_t index) {
+                return read_list[index].time <= position;
+            });
+            for (auto i = split; i != indices.begin() && !gaps.empty();) {
+                apply(read_list[*--i]);
+            }
+            for (auto i = split; i != indices.end() && !gaps.empty(); ++i) {
+                apply(read_list[*i]);
+            }
+            ret = ret && gaps.empty();
+        }
+        return ret;
+    } catch (...) {
+        return false;
+    }
+}
+std::vector<Region> Recording::regions_at(std::chrono::nanoseconds position) const noexcept {
+    if (region_lists.empty()) {
+        return {};
+    }
+    std::map<std::uintptr_t, const Region*> merged;
+    for (const auto& list : region_lists) {
+        if (list.time > position && !merged.empty()) {
+            break;
+        }
+        // Regions the list would contain if they were still there have been unmapped or changed.
+        std::erase_if(merged, [&](const auto& entry) { return list.filter.matches(*entry.second); });
+        for (const auto& region : list.regions) {
+            merged[region.base] = &region;
+        }
+        if (list.time > position) {
+            break;
+        }
+    }
+    std::vector<Region> ret;
+    for (const auto& [base, region] : merged) {
+        ret.push_back(*region);
+    }
+    return ret;
+}
+std::uint64_t Recording::cache_hint_at(std::chrono::nanoseconds position) const noexcept {
+    if (cache_hints.empty()) {
+        return 1;
+    }
+    auto it = std::partition_point(cache_hints.begin(), cache_hints.end(),
+                                   [&](const CacheHint& hint) { return hint.time <= position; });
+    return it == cache_hints.begin() ? it->value : std::prev(it)->value;
+}
+std::chrono::nanoseconds Recording::latency(bool batch, std::size_t size) const noexcept {
+    const auto& bucket = latency_table[batch][latency_bucket(size)];
+    return bucket.count ? bucket.total / static_cast<std::int64_t>(bucket.count) : std::chrono::nanoseconds{};
+}
+
+ReplayReader::ReplayReader(const Recording& recording, const ReplayOptions& options) noexcept
+    : recording(recording), options(options), origin(clock::now().time_since_epoch().count()) {}
+
+std::chrono::nanoseconds ReplayReader::position() const noexcept {
+    if (options.speed == 0) {
+        return std::chrono::nanoseconds(manual_position.load(std::memory_order_relaxed));
+    }
+    const auto elapsed = clock::duration(clock::now().time_since_epoch().count() - origin.load());
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::duration<double, std::nano>(elapsed) * options.speed);
+}
+void ReplayReader::seek(std::chrono::nanoseconds position) noexcept {
+    if (options.speed == 0) {
+        manual_position.store(position.count(), std::memory_order_relaxed);
+        return;
+    }
+    const auto elapsed = std::chrono::duration_cast<clock::duration>(
+        std::chrono::duration<double, std::nano>(position) / options.speed);
+    origin.store((clock::now() - elapsed).time_since_epoch().count());
+}
+
+void ReplayReader::simulate_latency(bool batch, std::size_t size, clock::time_point start) const noexcept {
+    if (!options.simulate_latency) {
+        return;
+    }
+    // Sleeping is too coarse for reads of microseconds, so spin, yielding to other threads.
+    const auto until = start + recording.latency(batch, size);
+    while (clock::now() < until) {
+        std::this_thread::yield();
+    }
+}
+
+bool ReplayReader::read_to_buf(std::uintptr_t address, void* buf, std::size_t size) const noexcept {
+    const auto start = clock::now();
+    const bool ret = recording.read_at(position(), address, buf, size);
+    simulate_latency(false, size, start);
+    return ret;
+}
+std::size_t ReplayReader::read_to_bufs(std::span<ReadRequest> requests) const noexcept {
+    const auto start = clock::now();
+    const auto now = position();
+    std::size_t ret = 0;
+    std::size_t total = 0;
+    for (auto& request : requests) {
+        request.ok = recording.read_at(now, request.address, request.buf, request.size);
+        ret += request.ok;
+        total += request.size;
+    }
+    simulate_latency(true, total, start);
+    return ret;
+}
+std::vector<Region> ReplayReader::regions() const noexcept {
+    return query_regions(RegionFilter{.required = RegionProtection::EXECUTE});
+}
+std::vector<Region> ReplayReader::query_regions(const RegionFilter& filter) const noexcept {
+    auto ret = recording.regions_at(position());
+    std::erase_if(ret, [&](const Region& region) { return !filter.matches(region); });
+    return ret;
+}
+
+std::uint64_t ReplayReader::get_cache_hint() const noexcept {
+    return recording.cache_hint_at(position());
+}
@@ -64,11 +64,17 @@ bool Self::still_alive() const noexcept {
 bool Self::read_to_buf(std::uintptr_t address, void* buf, std::size_t size) const noexcept {
     return process.read_to_buf(address, buf, size);
 }
+std::size_t Self::read_to_bufs(std::span<ReadRequest> requests) const noexcept {
+    return process.read_to_bufs(requests);
+}
 std::vector<Region> Self::regions() const noexcept {
     return process.regions();
 }
+std::vector<Region> Self::query_regions(const RegionFilter& filter) const noexcept {
+    return process.query_regions(filter);
+}
 
-int Self::get_cache_hint() const noexcept {
+std::uint64_t Self::get_cache_hint() const noexcept {
     return process.get_cache_hint();
 }
 
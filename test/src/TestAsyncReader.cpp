@@ -0,0 +1,109 @@
+/**
+ * @file TestAsyncReader.cpp
+ * @author UnnamedOrange
+ * @brief Test @ref AsyncReader.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <memory-reader/all.h>
+
+#include "TestReaders.h"
+
+USING_MEMORY_READER_NAMESPACE;
+using namespace test_readers;
+
+namespace {
+    /**
+     * @brief Minimal coroutine type running eagerly and destroying itself on completion.
+     */
+    struct DetachedTask {
+        struct promise_type {
+            DetachedTask get_return_object() noexcept {
+                return {};
+            }
+            std::suspend_never initial_suspend() noexcept {
+                return {};
+            }
+            std::suspend_never final_suspend() noexcept {
+                return {};
+            }
+            void return_void() noexcept {}
+            void unhandled_exception() noexcept {
+                std::terminate();
+            }
+        };
+    };
+
+    DetachedTask read_one(AsyncReader& reader, std::uintptr_t address, std::optional<int>& out,
+                          std::atomic<std::size_t>& done) {
+        out = co_await reader.read<int>(address);
+        done++;
+    }
+    DetachedTask read_invalid(AsyncReader& reader, std::optional<bool>& out, std::atomic<std::size_t>& done) {
+        int buf;
+        out = co_await reader.read_to_buf(0, &buf, sizeof(buf));
+        done++;
+    }
+} // namespace
+
+TEST(TestAsyncReader, test_batched_reads) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+    // Reads issued during a slow batch are batched together.
+    SlowReader slow_reader(p, std::chrono::milliseconds(10));
+
+    // Coroutines are resumed on this thread, like in an event loop.
+    std::mutex m_ready;
+    std::vector<std::coroutine_handle<>> ready;
+    auto post = [&](std::coroutine_handle<> handle) {
+        std::lock_guard _(m_ready);
+        ready.push_back(handle);
+    };
+    AsyncReader reader(slow_reader, AsyncReaderOptions{.threads = 1, .max_batch = 1024, .resume = post});
+
+    constexpr std::size_t count = 100;
+    std::vector<int> values(count);
+    std::vector<std::optional<int>> results(count);
+    std::optional<bool> invalid_result;
+    std::atomic<std::size_t> done = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        values[i] = static_cast<int>(i * 7);
+        read_one(reader, reinterpret_cast<std::uintptr_t>(&values[i]), results[i], done);
+    }
+    read_invalid(reader, invalid_result, done);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (done < count + 1 && std::chrono::steady_clock::now() < deadline) {
+        std::vector<std::coroutine_handle<>> handles;
+        if (std::lock_guard _(m_ready); true) {
+            handles.swap(ready);
+        }
+        for (auto handle : handles) {
+            handle.resume();
+        }
+        std::this_thread::yield();
+    }
+    ASSERT_EQ(done, count + 1);
+    for (std::size_t i = 0; i < count; i++) {
+        ASSERT_EQ(results[i], values[i]);
+    }
+    ASSERT_EQ(invalid_result, false);
+    ASSERT_LT(slow_reader.batches, count / 2) << "Concurrent reads should be batched.";
+}
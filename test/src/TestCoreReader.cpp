@@ -0,0 +1,151 @@
+/**
+ * @file TestCoreReader.cpp
+ * @author UnnamedOrange
+ * @brief Test @ref CoreReader.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <memory-reader/all.h>
+
+USING_MEMORY_READER_NAMESPACE;
+
+namespace {
+    constexpr std::uint64_t code_base = 0x400000;
+    constexpr std::uint64_t data_base = 0x401000;
+    constexpr std::string_view code_path = "/usr/bin/target";
+
+    template <typename T>
+    void put(std::vector<std::byte>& out, std::size_t offset, T value) {
+        if (out.size() < offset + sizeof(T)) {
+            out.resize(offset + sizeof(T));
+        }
+        std::memcpy(out.data() + offset, &value, sizeof(T));
+    }
+
+    /**
+     * @brief Make a 64-bit core file with a code segment, a data segment stored only in part,
+     * and an NT_FILE note naming the file of the code segment.
+     */
+    std::vector<std::byte> make_core_file() {
+        constexpr std::size_t header_size = 0x40;
+        constexpr std::size_t program_header_size = 0x38;
+        constexpr std::size_t note_offset = header_size + 3 * program_header_size;
+
+        std::vector<std::byte> note;
+        put<std::uint32_t>(note, 0, 5);
+        put<std::uint32_t>(note, 8, 0x46494C45);
+        note.resize(20);
+        std::memcpy(note.data() + 12, "CORE", 5);
+        std::vector<std::byte> desc;
+        put<std::uint64_t>(desc, 0, 1);
+        put<std::uint64_t>(desc, 8, 0x1000);
+        put<std::uint64_t>(desc, 16, code_base);
+        put<std::uint64_t>(desc, 24, code_base + 0x1000);
+        put<std::uint64_t>(desc, 32, 0);
+        for (char c : code_path) {
+            desc.push_back(std::byte(c));
+        }
+        desc.resize((desc.size() + 1 + 3) / 4 * 4);
+        put<std::uint32_t>(note, 4, static_cast<std::uint32_t>(desc.size()));
+        note.insert(note.end(), desc.begin(), desc.end());
+
+        const std::size_t code_offset = (note_offset + note.size() + 0xFFF) / 0x1000 * 0x1000;
+        const std::size_t data_offset = code_offset + 0x1000;
+
+        std::vector<std::byte> file(header_size);
+        // 64-bit, little-endian, version 1.
+        std::memcpy(file.data(), "\x7F" "ELF\x02\x01\x01", 7);
+        put<std::uint16_t>(file, 0x10, 4);
+        put<std::uint16_t>(file, 0x12, 0x3E);
+        put<std::uint64_t>(file, 0x20, header_size);
+        put<std::uint16_t>(file, 0x34, header_size);
+        put<std::uint16_t>(file, 0x36, program_header_size);
+        put<std::uint16_t>(file, 0x38, 3);
+
+        auto put_program_header = [&](std::size_t index, std::uint32_t type, std::uint32_t flags,
+                                      std::uint64_t offset, std::uint64_t vaddr, std::uint64_t filesz,
+                                      std::uint64_t memsz) {
+            const auto at = header_size + index * program_header_size;
+            put(file, at, type);
+            put(file, at + 0x04, flags);
+            put(file, at + 0x08, offset);
+            put(file, at + 0x10, vaddr);
+            put(file, at + 0x20, filesz);
+            put(file, at + 0x28, memsz);
+        };
+        put_program_header(0, 4, 0, note_offset, 0, note.size(), 0);
+        put_program_header(1, 1, 5, code_offset, code_base, 0x1000, 0x1000);
+        // Only the first page of the data segment is dumped.
+        put_program_header(2, 1, 6, data_offset, data_base, 0x1000, 0x2000);
+
+        file.resize(note_offset);
+        file.insert(file.end(), note.begin(), note.end());
+        file.resize(data_offset + 0x1000);
+        // lea rax, [rip + 0x100] at code_base + 0x100.
+        constexpr std::uint8_t code[]{0x48, 0x8D, 0x05, 0x00, 0x01, 0x00, 0x00};
+        std::memcpy(file.data() + code_offset + 0x100, code, sizeof(code));
+        put<std::uint32_t>(file, data_offset + 0xFFC, 0x12345678);
+        return file;
+    }
+} // namespace
+
+TEST(TestCoreReader, test_open) {
+    auto path = std::filesystem::temp_directory_path() / "memory-reader-test-core.bin";
+    if (std::ofstream ofs(path, std::ios::binary); true) {
+        auto file = make_core_file();
+        ofs.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+    }
+    auto reader = CoreReader::try_open(path);
+    std::filesystem::remove(path);
+    ASSERT_FALSE(reader.empty());
+    ASSERT_NE(reader.get_cache_hint(), 0);
+
+    auto code = reader.regions();
+    ASSERT_EQ(code.size(), 1) << "regions() should only return executable regions.";
+    ASSERT_EQ(code[0].base, code_base);
+    ASSERT_EQ(code[0].path, code_path);
+    auto all = reader.query_regions({});
+    ASSERT_EQ(all.size(), 2);
+    ASSERT_EQ(all[1].base, data_base);
+    ASSERT_EQ(all[1].size, 0x1000) << "Pages not dumped should not be readable.";
+    ASSERT_EQ(all[1].protection, RegionProtection::READ | RegionProtection::WRITE);
+
+    ASSERT_EQ(reader.read<std::uint32_t>(data_base + 0xFFC), 0x12345678);
+    std::vector<std::byte> across(0x20);
+    ASSERT_TRUE(reader.read_to_buf(data_base - 0x10, across.data(), across.size()))
+        << "Adjacent segments should be read through.";
+    ASSERT_FALSE(reader.read<std::uint32_t>(data_base + 0xFFE));
+    ASSERT_FALSE(reader.read<std::uint8_t>(code_base - 1));
+
+    Signature<"48 8D 05 @?? ?? ?? ??", rel32()> signature;
+    ASSERT_EQ(signature.scan(reader), code_base + 0x100);
+    ASSERT_EQ(signature.resolve(reader), code_base + 0x107 + 0x100);
+
+    auto moved = std::move(reader);
+    ASSERT_TRUE(reader.empty());
+    ASSERT_EQ(moved.read<std::uint32_t>(data_base + 0xFFC), 0x12345678);
+}
+TEST(TestCoreReader, test_invalid) {
+    ASSERT_TRUE(CoreReader::try_open("/nonexistent/memory-reader-core").empty());
+
+    auto path = std::filesystem::temp_directory_path() / "memory-reader-test-not-core.bin";
+    if (std::ofstream ofs(path, std::ios::binary); true) {
+        ofs << "not an ELF file, but long enough to hold the header of one...";
+    }
+    auto reader = CoreReader::try_open(path);
+    std::filesystem::remove(path);
+    ASSERT_TRUE(reader.empty());
+    ASSERT_FALSE(reader.read<std::uint8_t>(code_base));
+}
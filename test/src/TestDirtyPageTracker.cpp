@@ -0,0 +1,55 @@
+/**
+ * @file TestDirtyPageTracker.cpp
+ * @author UnnamedOrange
+ * @brief Test @ref DirtyPageTracker.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <memory-reader/all.h>
+
+USING_MEMORY_READER_NAMESPACE;
+
+TEST(TestDirtyPageTracker, test_without_checkpoint) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+
+    DirtyPageTracker tracker(p);
+    ASSERT_FALSE(tracker.dirty_ranges()) << "Nothing should be reported before a checkpoint.";
+}
+TEST(TestDirtyPageTracker, test_dirty_ranges) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+    DirtyPageTracker tracker(p);
+    if (!tracker.supported()) {
+        GTEST_SKIP() << "Soft-dirty bits are not supported.";
+    }
+
+    const auto page_size = tracker.page_size();
+    auto storage = std::make_unique<std::byte[]>(4 * page_size);
+    auto data = reinterpret_cast<std::byte*>(
+        (reinterpret_cast<std::uintptr_t>(storage.get()) + page_size - 1) & ~(page_size - 1));
+    data[0] = std::byte{1};
+    data[2 * page_size] = std::byte{1};
+    if (!tracker.checkpoint()) {
+        GTEST_SKIP() << "Cannot clear soft-dirty bits.";
+    }
+
+    data[page_size] = std::byte{2};
+    auto address = reinterpret_cast<std::uintptr_t>(data);
+    auto dirty = tracker.dirty_ranges(std::vector<Region>{Region{.base = address, .size = 3 * page_size}});
+    ASSERT_TRUE(dirty);
+    ASSERT_EQ(*dirty, (std::vector<ChangedRange>{{.address = address + page_size, .size = page_size}}));
+}
@@ -0,0 +1,147 @@
+/**
+ * @file TestFileImageReader.cpp
+ * @author UnnamedOrange
+ * @brief Test @ref FileImageReader.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#ifdef MEMORY_READER_TARGET_PLATFORM_LINUX
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <memory-reader/all.h>
+
+USING_MEMORY_READER_NAMESPACE;
+
+namespace {
+    std::string to_pattern(const std::byte* data, std::size_t size) {
+        std::string ret;
+        for (std::size_t i = 0; i < size; i++) {
+            char buf[4];
+            std::snprintf(buf, sizeof(buf), "%02X ", std::to_integer<unsigned>(data[i]));
+            ret += buf;
+        }
+        return ret;
+    }
+} // namespace
+
+TEST(TestFileImageReader, test_images) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+    FileImageReader reader(p);
+    const auto images = reader.get_images();
+    ASSERT_FALSE(images.empty()) << "The code of the test program should be mapped.";
+
+    const auto& image = images.front();
+    std::vector<std::byte> bytes(64);
+    ASSERT_TRUE(p.read_to_buf(image.base, bytes.data(), bytes.size()));
+    ASSERT_EQ(std::memcmp(bytes.data(), image.data, bytes.size()), 0) << "The file should be what is mapped.";
+
+    auto found = reader.find_image(image.base + 8, 16);
+    ASSERT_EQ(found.data(), image.data + 8);
+    ASSERT_EQ(found.size(), 16);
+    ASSERT_EQ(reader.find_image(image.base + image.size - 4, 16).size(), 4) << "Should stop at the image end.";
+    ASSERT_TRUE(reader.find_image(image.base - 1, 16).empty());
+}
+
+TEST(TestFileImageReader, test_scan) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+    FileImageReader reader(p);
+    if (reader.get_images().empty()) {
+        GTEST_SKIP() << "No file is mapped.";
+    }
+
+    // Code in a file.
+    const auto& image = reader.get_images().back();
+    const auto offset = image.size / 2;
+    DynamicSignature in_file(DynamicPattern(to_pattern(image.data + offset, 32)));
+    auto match = in_file.scan(reader);
+    ASSERT_TRUE(match);
+    // Bytes covered by the images are only read from the process on a miss, which is off by default.
+    ASSERT_TRUE(std::ranges::any_of(reader.get_images(), [&](const FileImageReader::Image& covered) {
+        return *match >= covered.base && *match - covered.base + 32 <= covered.size;
+    })) << "The hit should come from a mapped image.";
+    std::vector<std::byte> bytes(32);
+    ASSERT_TRUE(p.read_to_buf(*match, bytes.data(), bytes.size()));
+    ASSERT_EQ(std::memcmp(bytes.data(), image.data + offset, bytes.size()), 0);
+
+    // Code not in any file is scanned in the process.
+    constexpr std::size_t size = 0x1000;
+    auto anonymous =
+        static_cast<std::byte*>(mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    ASSERT_NE(anonymous, MAP_FAILED);
+    constexpr char marker[] = "memory-reader FileImageReader anonymous code";
+    std::memcpy(anonymous + 0x100, marker, sizeof(marker));
+    if (mprotect(anonymous, size, PROT_READ | PROT_EXEC) == 0) {
+        DynamicSignature anonymous_signature(DynamicPattern(to_pattern(anonymous + 0x100, sizeof(marker))));
+        ASSERT_EQ(anonymous_signature.scan(reader), reinterpret_cast<std::uintptr_t>(anonymous + 0x100));
+    }
+    munmap(anonymous, size);
+
+    DynamicSignature missing(DynamicPattern("4D 45 4D 4F 52 59 2D 52 45 41 44 45 52 ?? ?? 00 FF 00 FF 00 FF 13 57"));
+    ASSERT_FALSE(missing.scan(reader));
+}
+
+TEST(TestFileImageReader, test_scan_process_on_miss) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+
+    // Code mapped from a file, then patched in the process only.
+    constexpr std::size_t size = 0x2000;
+    auto path = std::filesystem::temp_directory_path() / "memory-reader-test-file-image.bin";
+    if (std::ofstream ofs(path, std::ios::binary); true) {
+        ofs << std::string(size, '\xCC');
+    }
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    ASSERT_NE(fd, -1);
+    auto code = static_cast<std::byte*>(mmap(nullptr, size, PROT_READ | PROT_EXEC, MAP_PRIVATE, fd, 0));
+    close(fd);
+    if (code == MAP_FAILED) {
+        std::filesystem::remove(path);
+        GTEST_SKIP() << "Cannot map a file as code.";
+    }
+    constexpr char marker[] = "memory-reader FileImageReader patched code";
+    ASSERT_EQ(mprotect(code, size, PROT_READ | PROT_WRITE), 0);
+    std::memcpy(code + 0x100, marker, sizeof(marker));
+    ASSERT_EQ(mprotect(code, size, PROT_READ | PROT_EXEC), 0);
+
+    FileImageReader reader(p);
+    if (reader.find_image(reinterpret_cast<std::uintptr_t>(code), size).empty()) {
+        munmap(code, size);
+        std::filesystem::remove(path);
+        GTEST_SKIP() << "The file is not mapped.";
+    }
+    DynamicSignature patched(DynamicPattern(to_pattern(code + 0x100, sizeof(marker))));
+    ASSERT_FALSE(patched.scan(reader)) << "Bytes covered by the file should not be read from the process by default.";
+
+    FileImageReader fallback_reader(p, FileImageReaderOptions{.scan_process_on_miss = true});
+    DynamicSignature fallback(DynamicPattern(to_pattern(code + 0x100, sizeof(marker))));
+    ASSERT_EQ(fallback.scan(fallback_reader), reinterpret_cast<std::uintptr_t>(code + 0x100));
+    munmap(code, size);
+    std::filesystem::remove(path);
+}
+
+#endif
@@ -0,0 +1,71 @@
+/**
+ * @file TestMappedReader.cpp
+ * @author UnnamedOrange
+ * @brief Test @ref MappedReader.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#ifdef MEMORY_READER_TARGET_PLATFORM_LINUX
+
+#include <array>
+#include <cstdint>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <memory-reader/all.h>
+
+USING_MEMORY_READER_NAMESPACE;
+
+TEST(TestMappedReader, test_memfd) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+    constexpr std::size_t size = 0x2000;
+    int fd = memfd_create("memory-reader-test", MFD_CLOEXEC);
+    ASSERT_NE(fd, -1);
+    ASSERT_EQ(ftruncate(fd, size), 0);
+    auto shared = static_cast<int*>(mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+    close(fd);
+    ASSERT_NE(shared, MAP_FAILED);
+    const auto shared_address = reinterpret_cast<std::uintptr_t>(shared);
+    if (MappedReader probe(p); probe.get_mappings().empty()) {
+        munmap(shared, size);
+        GTEST_SKIP() << "Nothing can be mapped, e.g. map_files is denied.";
+    }
+
+    if (MappedReader reader(p); true) {
+        bool mapped = false;
+        for (const auto& mapping : reader.get_mappings()) {
+            mapped = mapped || (mapping.base == shared_address && mapping.size == size);
+        }
+        ASSERT_TRUE(mapped) << "The memfd region should be mapped.";
+
+        shared[0] = 114514;
+        ASSERT_EQ(reader.read<int>(shared_address), 114514);
+        shared[0] = 1919810;
+        ASSERT_EQ(reader.read<int>(shared_address), 1919810) << "Reads should see writes of the process.";
+
+        // Reads out of mappings fall back to the process, in the same batch.
+        int local = 727;
+        std::array<int, 2> read{};
+        std::array<ReadRequest, 3> requests{
+            ReadRequest{.address = shared_address, .buf = &read[0], .size = sizeof(int)},
+            ReadRequest{.address = 0, .buf = &read[1], .size = sizeof(int)},
+            ReadRequest{.address = reinterpret_cast<std::uintptr_t>(&local), .buf = &read[1], .size = sizeof(int)},
+        };
+        ASSERT_EQ(reader.read_to_bufs(requests), 2);
+        ASSERT_TRUE(requests[0].ok);
+        ASSERT_FALSE(requests[1].ok);
+        ASSERT_TRUE(requests[2].ok);
+        ASSERT_EQ(read, (std::array<int, 2>{1919810, 727}));
+    }
+    munmap(shared, size);
+}
+
+#endif
@@ -0,0 +1,65 @@
+/**
+ * @file TestOffsets.cpp
+ * @author UnnamedOrange
+ * @brief Test @ref ValueOffsets and @ref DynamicOffsets.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <memory-reader/all.h>
+
+USING_MEMORY_READER_NAMESPACE;
+
+TEST(TestOffsets, test_dynamic_offsets) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+
+    struct Leaf {
+        std::array<char, 0x14> padding;
+        int value;
+    };
+    struct Root {
+        std::array<char, 0x8> padding;
+        Leaf* leaf;
+    };
+    Leaf leaf{.padding = {}, .value = 727};
+    Root root{.padding = {}, .leaf = &leaf};
+    const auto base = reinterpret_cast<std::uintptr_t>(&root);
+    constexpr auto leaf_offset = static_cast<std::intptr_t>(offsetof(Root, leaf));
+    constexpr auto value_offset = static_cast<std::intptr_t>(offsetof(Leaf, value));
+
+    constexpr ValueOffsets<PtrWidth::IS_CURRENT, int, leaf_offset, value_offset> value_offsets;
+    DynamicOffsets<PtrWidth::IS_CURRENT, int> dynamic_offsets{leaf_offset, value_offset};
+    ASSERT_EQ(dynamic_offsets.size(), 2);
+    ASSERT_EQ(dynamic_offsets.read(p, base), 727);
+    ASSERT_EQ(dynamic_offsets.read(p, base), value_offsets.read(p, base));
+    ASSERT_EQ(DynamicOffsets(value_offsets), dynamic_offsets);
+
+    ASSERT_EQ((DynamicOffsets<PtrWidth::IS_CURRENT, int>{}.read(p, reinterpret_cast<std::uintptr_t>(&leaf.value))),
+              727)
+        << "Without offsets, the value should be read at the base.";
+    ASSERT_EQ((DynamicOffsets<PtrWidth::IS_CURRENT, int>{0, value_offset}.read(p, base)), std::nullopt)
+        << "Following an invalid pointer should fail.";
+
+    // More offsets than the inline capacity: each level points to the next one.
+    std::vector<std::uintptr_t> chain(12);
+    for (std::size_t i = 0; i + 1 < chain.size(); i++) {
+        chain[i] = reinterpret_cast<std::uintptr_t>(&chain[i + 1]);
+    }
+    chain.back() = 1919810;
+    std::vector<std::intptr_t> zeros(chain.size(), 0);
+    DynamicPtrOffsets<PtrWidth::IS_CURRENT> long_offsets(zeros);
+    ASSERT_GT(long_offsets.size(), long_offsets.inline_capacity);
+    ASSERT_EQ(long_offsets.read(p, reinterpret_cast<std::uintptr_t>(chain.data())), 1919810);
+}
@@ -8,6 +8,9 @@
  */
 
 #include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -48,3 +51,59 @@ TEST(TestPattern, test_dynamic_modification) {
     p = DynamicPattern(t);
     ASSERT_EQ(p.size(), 4);
 }
+TEST(TestPattern, test_extended_syntax) {
+    constexpr auto p = Pattern("E8 @?? [3] 4? ?F 40&F0  8b");
+    static_assert(p.size() == 9);
+    static_assert(p.marker() == 1);
+    ASSERT_EQ(p[1].is_mask, true);
+    ASSERT_EQ(p[4].is_mask, true);
+    ASSERT_EQ(p[5].byte, std::byte(0x40));
+    ASSERT_EQ(p[5].mask, std::byte(0xF0));
+    ASSERT_EQ(p[6].byte, std::byte(0x0F));
+    ASSERT_EQ(p[6].mask, std::byte(0x0F));
+    ASSERT_EQ(p[7].byte, std::byte(0x40));
+    ASSERT_EQ(p[7].mask, std::byte(0xF0));
+    ASSERT_EQ(p[8].byte, std::byte(0x8B));
+    ASSERT_EQ(p[8].mask, std::byte(0xFF));
+
+    auto dp = DynamicPattern("E8 @?? [3] 4? ?F 40&F0  8b");
+    ASSERT_EQ(dp.size(), p.size());
+    ASSERT_EQ(dp.marker(), p.marker());
+    for (std::size_t i = 0; i < dp.size(); i++) {
+        ASSERT_EQ(dp[i].byte, p[i].byte);
+        ASSERT_EQ(dp[i].is_mask, p[i].is_mask);
+        ASSERT_EQ(dp[i].is_mask || dp[i].mask == p[i].mask, true);
+    }
+
+    ASSERT_THROW(DynamicPattern("E8 @"), std::invalid_argument);
+    ASSERT_THROW(DynamicPattern("@E8 @00"), std::invalid_argument);
+    ASSERT_THROW(DynamicPattern("[x]"), std::invalid_argument);
+    ASSERT_THROW(DynamicPattern("123"), std::invalid_argument);
+    ASSERT_THROW(DynamicPattern("1G"), std::invalid_argument);
+}
+TEST(TestPattern, test_try_parse) {
+    auto dp = DynamicPattern::try_parse("\tE8\r\n@?? [2]  8B ");
+    ASSERT_TRUE(dp.has_value());
+    ASSERT_EQ(dp->size(), 5);
+    ASSERT_EQ(dp->marker(), 1);
+
+    PatternError error{};
+    ASSERT_EQ(DynamicPattern::try_parse("E8 1G 00", &error), std::nullopt);
+    ASSERT_EQ(error.position, 3) << "The error should point at the invalid token.";
+    ASSERT_EQ(DynamicPattern::try_parse("E8 @", &error), std::nullopt);
+    ASSERT_EQ(DynamicPattern::try_parse("E8 [99999]", &error), std::nullopt);
+    ASSERT_EQ(error.position, 3);
+}
+TEST(TestPattern, test_compiled_pattern) {
+    const std::vector<std::byte> data{std::byte(0x00), std::byte(0xE8), std::byte(0x12), std::byte(0x34),
+                                      std::byte(0x56), std::byte(0x78), std::byte(0x4A), std::byte(0x0F),
+                                      std::byte(0x4C), std::byte(0x8B), std::byte(0xE8), std::byte(0x00)};
+    auto compiled = CompiledPattern(Pattern("E8 @?? [3] 4? ?F 40&F0 8b"));
+    ASSERT_EQ(compiled.size(), 9);
+    ASSERT_EQ(compiled.find(data, 0, data.size()), 1);
+    ASSERT_EQ(compiled.find(data, 2, data.size()), std::nullopt);
+    ASSERT_EQ(compiled.find(data, 0, 1), std::nullopt);
+
+    auto wildcards = CompiledPattern(DynamicPattern("?? 0? [1]"));
+    ASSERT_EQ(wildcards.find(data, 0, data.size()), 6);
+}
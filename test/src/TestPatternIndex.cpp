@@ -0,0 +1,89 @@
+/**
+ * @file TestPatternIndex.cpp
+ * @author UnnamedOrange
+ * @brief Test @ref PatternIndex.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <memory-reader/all.h>
+
+#include "TestReaders.h"
+
+USING_MEMORY_READER_NAMESPACE;
+using namespace test_readers;
+
+namespace {
+    std::vector<std::uintptr_t> scan_all(const IReadMemory& reader, const DynamicPattern& pattern) {
+        std::vector<std::uintptr_t> ret;
+        for (auto address : SignatureMatches(reader, pattern)) {
+            ret.push_back(address);
+        }
+        return ret;
+    }
+} // namespace
+
+TEST(TestPatternIndex, test_same_as_scan) {
+    CodeReader reader;
+    // Found in both regions, but not across them.
+    reader.put(0x100, {0x48, 0x8B, 0x05, 0x78, 0x56, 0x34, 0x12});
+    reader.put(CodeReader::region_size + 0x200, {0x48, 0x8B, 0x05, 0x11, 0x22, 0x33, 0x44});
+    reader.put(CodeReader::region_size - 2, {0x48, 0x8B, 0x05, 0x00, 0x00, 0x00, 0x00});
+
+    std::vector<std::string> patterns{
+        "48 8B 05 ?? ?? ?? ??",
+        "48 8B 05 78 56 34 12",
+        "?? 8B [2] 78 56",
+        "11 22 33 44",
+        "00 ?? 11 ?? 22",
+        "48 8B 05 ?? ?? ?? 13",
+    };
+    // Random patterns taken from the data, with some bytes masked out.
+    std::mt19937 engine(1);
+    for (int i = 0; i < 50; i++) {
+        const auto offset = std::uniform_int_distribution<std::size_t>(0, reader.data.size() - 16)(engine);
+        std::string pattern;
+        for (std::size_t j = 0; j < 12; j++) {
+            char buf[4];
+            std::snprintf(buf, sizeof(buf), "%02X ", std::to_integer<unsigned>(reader.data[offset + j]));
+            pattern += j % 5 == 4 ? "?? " : buf;
+        }
+        patterns.push_back(pattern);
+    }
+
+    for (std::size_t stride : {1, 3}) {
+        auto index = PatternIndex::build(reader, PatternIndexOptions{.stride = stride});
+        ASSERT_EQ(index.size(), reader.data.size());
+        for (const auto& str : patterns) {
+            DynamicPattern pattern(str);
+            ASSERT_EQ(index.find_all(pattern), scan_all(reader, pattern)) << str << ", stride " << stride;
+        }
+    }
+}
+TEST(TestPatternIndex, test_find_and_resolve) {
+    CodeReader reader;
+    // lea rax, [rip + 0x100]
+    reader.put(0x300, {0x48, 0x8D, 0x05, 0x00, 0x01, 0x00, 0x00});
+    auto index = PatternIndex::build(reader);
+
+    ASSERT_EQ(index.find(Pattern("48 8D 05 00 01 00 00")), CodeReader::base + 0x300);
+    ASSERT_FALSE(index.find(Pattern("48 8D 05 00 01 00 01")));
+    ASSERT_TRUE(index.find_all(DynamicPattern()).empty());
+    constexpr std::array steps{rel32()};
+    ASSERT_EQ(index.resolve(Pattern("48 8D 05 @00 01 00 00"), steps), CodeReader::base + 0x307 + 0x100);
+
+    std::uint32_t displacement = 0;
+    ASSERT_TRUE(index.read_to_buf(CodeReader::base + 0x303, &displacement, sizeof(displacement)));
+    ASSERT_EQ(displacement, 0x100);
+    ASSERT_FALSE(index.read_to_buf(CodeReader::base - 1, &displacement, 1));
+    ASSERT_TRUE(PatternIndex().find_all(DynamicPattern("48")).empty());
+}
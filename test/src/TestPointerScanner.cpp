@@ -0,0 +1,83 @@
+/**
+ * @file TestPointerScanner.cpp
+ * @author UnnamedOrange
+ * @brief Test @ref PointerScanner.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <memory-reader/all.h>
+
+USING_MEMORY_READER_NAMESPACE;
+
+namespace {
+    struct Leaf {
+        std::byte padding[0x20];
+        int value;
+    };
+    struct Node {
+        std::byte padding[0x10];
+        Leaf* leaf;
+    };
+    Node* static_root = nullptr;
+} // namespace
+
+TEST(TestPointerScanner, test_pointer_map) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+
+    auto leaf = std::make_unique<Leaf>();
+    auto holder = std::make_unique<Leaf*>(leaf.get());
+    auto map = PointerMap::build(p, PointerScanOptions{.threads = 2});
+    auto value = reinterpret_cast<std::uintptr_t>(leaf.get());
+    auto entries = map.find(value, value);
+    ASSERT_TRUE(std::any_of(entries.begin(), entries.end(), [&](const PointerEntry& entry) {
+        return entry.address == reinterpret_cast<std::uintptr_t>(holder.get());
+    }));
+}
+TEST(TestPointerScanner, test_scan) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+
+    auto leaf = std::make_unique<Leaf>();
+    auto node = std::make_unique<Node>();
+    node->leaf = leaf.get();
+    static_root = node.get();
+    auto target = reinterpret_cast<std::uintptr_t>(&leaf->value);
+
+    PointerScanner scanner(p, PointerScanOptions{.max_depth = 2, .max_offset = 0x100});
+    auto paths = scanner.scan(target);
+    static_root = nullptr;
+
+    auto it = std::find_if(paths.begin(), paths.end(), [&](const PointerPath& path) {
+        return path.module_base + static_cast<std::uintptr_t>(path.offsets.front()) ==
+               reinterpret_cast<std::uintptr_t>(&static_root);
+    });
+    ASSERT_NE(it, paths.end()) << "The path from the static root should be found.";
+    ASSERT_EQ(it->offsets, (std::vector<std::intptr_t>{it->offsets.front(), 0x10, 0x20}));
+    ASSERT_EQ((PointerPath{.module = {}, .module_base = 0, .offsets = {0x1a8, 0x10, -0x8}})
+                  .declaration(PtrWidth::IS_64, "int"),
+              "ValueOffsets<PtrWidth::IS_64, int, 0x1a8, 0x10, -0x8>");
+
+    // Other paths may go through transient pointers, so only the planted one is resolved again.
+    static_root = node.get();
+    ASSERT_EQ(it->resolve(p, PtrWidth::IS_CURRENT), target);
+    static_root = nullptr;
+    ASSERT_FALSE(it->resolve(p, PtrWidth::IS_CURRENT)) << "A null root should not be followed.";
+    for (const auto& path : paths) {
+        ASSERT_LE(path.offsets.size(), 3);
+    }
+}
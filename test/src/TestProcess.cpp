@@ -41,10 +41,22 @@ TEST(TestProcess, test_cache_hint_movement_construct_and_assign) {
     ASSERT_NE(p.get_cache_hint(), 0) << "Cache hint should not be 0 after holding a process.";
 
     Process another;
-    int old_cache_hint = another.get_cache_hint();
+    auto old_cache_hint = another.get_cache_hint();
     another = std::move(p);
     ASSERT_NE(old_cache_hint, another.get_cache_hint()) << "Cache hint should be different after a process moves in.";
 }
+TEST(TestProcess, test_cache_hint_identity) {
+    auto p = Process::try_from_current_process();
+    auto another = Process::try_from_current_process();
+    if (p.empty() || another.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+    ASSERT_NE(p.get_cache_hint(), 0);
+    ASSERT_EQ(p.get_cache_hint(), another.get_cache_hint()) << "The same process should have the same cache hint.";
+
+    p.reset();
+    ASSERT_EQ(p.get_cache_hint(), 0) << "Cache hint should be 0 right after the process is reset.";
+}
 TEST(TestProcess, test_still_alive) {
     auto p = Process::try_from_current_process();
     if (p.empty()) {
@@ -120,3 +132,24 @@ TEST(TestProcess, test_read_bytes) {
     ASSERT_EQ(sizeof(ground_truth), read.size()) << "If read is successful, the size should be the same.";
     ASSERT_TRUE(std::memcmp(ground_truth.data(), read.data(), read.size()) == 0);
 }
+TEST(TestProcess, test_read_to_bufs) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+
+    std::array<int, 3> ground_truth{114, 514, 1919810};
+    std::array<int, 3> read{};
+    std::array<ReadRequest, 4> requests{
+        ReadRequest{.address = reinterpret_cast<std::uintptr_t>(&ground_truth[0]), .buf = &read[0], .size = 4},
+        ReadRequest{.address = 0, .buf = &read[1], .size = 4},
+        ReadRequest{.address = reinterpret_cast<std::uintptr_t>(&ground_truth[1]), .buf = &read[1], .size = 4},
+        ReadRequest{.address = reinterpret_cast<std::uintptr_t>(&ground_truth[2]), .buf = &read[2], .size = 4},
+    };
+    ASSERT_EQ(p.read_to_bufs(requests), 3) << "Requests after a failed one should still be read.";
+    ASSERT_TRUE(requests[0].ok);
+    ASSERT_FALSE(requests[1].ok) << "Reading address 0 should fail.";
+    ASSERT_TRUE(requests[2].ok);
+    ASSERT_TRUE(requests[3].ok);
+    ASSERT_EQ(read, ground_truth);
+}
@@ -0,0 +1,145 @@
+/**
+ * @file TestReaders.h
+ * @author UnnamedOrange
+ * @brief Fake readers shared by tests.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <memory-reader/all.h>
+
+namespace test_readers {
+    USING_MEMORY_READER_NAMESPACE;
+
+    /**
+     * @brief Bytes at a fake address, counting reads.
+     */
+    struct BufferReader : IReadMemoryWithCacheHint {
+        static constexpr std::uintptr_t base = 0x10000;
+        static constexpr std::size_t page_size = 0x1000;
+        std::vector<std::byte> data;
+        std::string path;
+        RegionProtection protection = RegionProtection::NONE;
+        /**
+         * @brief Sizes of the consecutive regions the bytes are split into. If empty, the bytes are one region.
+         */
+        std::vector<std::size_t> region_sizes;
+        /**
+         * @brief If set, reads touching the page at this address fail.
+         */
+        std::optional<std::uintptr_t> hole;
+        mutable std::size_t read_count = 0;
+        mutable std::size_t read_size = 0;
+        std::uint64_t cache_hint = 1;
+
+        bool read_to_buf(std::uintptr_t address, void* buf, std::size_t size) const noexcept override {
+            read_count++;
+            read_size += size;
+            if (address < base || address - base > data.size() || data.size() - (address - base) < size)
+                return false;
+            if (hole && address < *hole + page_size && *hole < address + size)
+                return false;
+            std::memcpy(buf, data.data() + (address - base), size);
+            return true;
+        }
+        std::vector<Region> regions() const noexcept override {
+            if (region_sizes.empty()) {
+                return {Region{.base = base, .size = data.size(), .protection = protection, .path = path}};
+            }
+            std::vector<Region> ret;
+            auto address = base;
+            for (auto size : region_sizes) {
+                ret.push_back(Region{.base = address, .size = size, .protection = protection, .path = path});
+                address += size;
+            }
+            return ret;
+        }
+        std::uint64_t get_cache_hint() const noexcept override {
+            return cache_hint;
+        }
+
+        void put(std::size_t offset, std::initializer_list<int> bytes) {
+            for (int byte : bytes) {
+                data[offset++] = std::byte(byte);
+            }
+        }
+    };
+
+    /**
+     * @brief Two executable regions of random bytes, the second one right after the first.
+     */
+    struct CodeReader : BufferReader {
+        static constexpr std::size_t region_size = 0x8000;
+
+        CodeReader() {
+            data.resize(2 * region_size);
+            // Few distinct bytes, so that grams repeat like in real code.
+            std::mt19937 engine(727);
+            std::uniform_int_distribution<int> distribution(0, 7);
+            for (auto& byte : data) {
+                byte = std::byte(distribution(engine) * 0x11);
+            }
+            protection = RegionProtection::READ | RegionProtection::EXECUTE;
+            region_sizes = {region_size, region_size};
+        }
+    };
+
+    /**
+     * @brief Forward to another reader, taking some time for each read, each batch and each query of regions.
+     */
+    struct SlowReader : IReadMemoryWithCacheHint {
+        const IReadMemory& inner;
+        std::chrono::milliseconds read_delay;
+        std::chrono::milliseconds regions_delay;
+        mutable std::atomic<std::size_t> batches = 0;
+        /**
+         * @brief The number of queries of regions, i.e. the number of scans started.
+         */
+        mutable std::atomic<std::size_t> scan_count = 0;
+        /**
+         * @brief May be changed while the reader is in use on other threads.
+         */
+        std::atomic<std::uint64_t> cache_hint = 1;
+
+        /**
+         * @note @b inner MUST have a longer life span than this object.
+         */
+        explicit SlowReader(const IReadMemory& inner, std::chrono::milliseconds read_delay = {},
+                            std::chrono::milliseconds regions_delay = {})
+            : inner(inner), read_delay(read_delay), regions_delay(regions_delay) {}
+
+        bool read_to_buf(std::uintptr_t address, void* buf, std::size_t size) const noexcept override {
+            std::this_thread::sleep_for(read_delay);
+            return inner.read_to_buf(address, buf, size);
+        }
+        std::size_t read_to_bufs(std::span<ReadRequest> requests) const noexcept override {
+            batches++;
+            std::this_thread::sleep_for(read_delay);
+            return inner.read_to_bufs(requests);
+        }
+        std::vector<Region> regions() const noexcept override {
+            scan_count++;
+            std::this_thread::sleep_for(regions_delay);
+            return inner.regions();
+        }
+        std::uint64_t get_cache_hint() const noexcept override {
+            return cache_hint;
+        }
+    };
+} // namespace test_readers
@@ -0,0 +1,125 @@
+/**
+ * @file TestRecording.cpp
+ * @author UnnamedOrange
+ * @brief Test @ref RecordingReader, @ref Recording and @ref ReplayReader.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <memory-reader/all.h>
+
+#include "TestReaders.h"
+
+USING_MEMORY_READER_NAMESPACE;
+using namespace test_readers;
+
+using namespace std::chrono_literals;
+
+TEST(TestRecording, test_record_and_replay) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+
+    auto path = std::filesystem::temp_directory_path() / "memory-reader-test-recording.bin";
+    auto values = std::make_unique<std::uint32_t[]>(2);
+    values[0] = 1;
+    values[1] = 10;
+    auto address = reinterpret_cast<std::uintptr_t>(values.get());
+    std::size_t region_count = 0;
+    if (RecordingReader recorder(p, path); true) {
+        ASSERT_EQ(recorder.read<std::uint32_t>(address), 1);
+        ASSERT_EQ(recorder.get_cache_hint(), p.get_cache_hint());
+        region_count = recorder.query_regions({}).size();
+        std::this_thread::sleep_for(1ms);
+        values[0] = 2;
+        values[1] = 20;
+        std::uint32_t first = 0, second = 0;
+        std::vector<ReadRequest> requests{
+            {.address = address, .buf = &first, .size = sizeof(first)},
+            {.address = address + sizeof(std::uint32_t), .buf = &second, .size = sizeof(second)},
+        };
+        ASSERT_EQ(recorder.read_to_bufs(requests), 2);
+        ASSERT_EQ(first, 2);
+        ASSERT_TRUE(recorder.good());
+    }
+
+    auto recording = Recording::load(path);
+    std::filesystem::remove(path);
+    ASSERT_TRUE(recording);
+    ASSERT_EQ(recording->reads().size(), 3);
+
+    ReplayReader replay(*recording, ReplayOptions{.speed = 0, .simulate_latency = false});
+    ASSERT_EQ(replay.read<std::uint32_t>(address), 1);
+    ASSERT_EQ(replay.read<std::uint32_t>(address + sizeof(std::uint32_t)), 20)
+        << "Bytes not read yet should come from later reads.";
+    replay.seek(recording->duration());
+    ASSERT_TRUE(replay.finished());
+    ASSERT_EQ(replay.read<std::uint32_t>(address), 2);
+    ASSERT_EQ(replay.read<std::uint64_t>(address), std::uint64_t{20} << 32 | 2);
+    ASSERT_FALSE(replay.read<std::uint32_t>(address + 2 * sizeof(std::uint32_t)));
+    ASSERT_EQ(replay.get_cache_hint(), p.get_cache_hint());
+    ASSERT_EQ(replay.query_regions({}).size(), region_count);
+    for (const auto& region : replay.regions()) {
+        ASSERT_EQ(region.protection & RegionProtection::EXECUTE, RegionProtection::EXECUTE);
+    }
+}
+TEST(TestRecording, test_latency_and_truncation) {
+    BufferReader buffer;
+    buffer.data.resize(4);
+    buffer.put(0, {0x00, 0x01, 0x02, 0x03});
+    SlowReader reader(buffer, 2ms);
+    auto path = std::filesystem::temp_directory_path() / "memory-reader-test-recording-slow.bin";
+    if (RecordingReader recorder(reader, path); true) {
+        for (std::uintptr_t address = BufferReader::base; address < BufferReader::base + 4; address++) {
+            ASSERT_EQ(recorder.read<std::uint8_t>(address), address & 0xFF);
+        }
+    }
+    // Cut the last record in the middle, as if the session crashed.
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    auto recording = Recording::load(path);
+    std::filesystem::remove(path);
+    ASSERT_TRUE(recording);
+    ASSERT_EQ(recording->reads().size(), 3);
+    ASSERT_GE(recording->latency(false, 1), 1ms);
+
+    ReplayReader replay(*recording, ReplayOptions{.speed = 0, .simulate_latency = true});
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(replay.read<std::uint8_t>(BufferReader::base + 2), 0x02);
+    ASSERT_GE(std::chrono::steady_clock::now() - start, 1ms) << "Reads should take as long as recorded.";
+    ASSERT_FALSE(replay.read<std::uint8_t>(BufferReader::base + 3));
+}
+TEST(TestRecording, test_unmapped_regions) {
+    BufferReader reader;
+    reader.data.resize(2 * BufferReader::page_size);
+    reader.protection = RegionProtection::READ | RegionProtection::WRITE;
+    reader.region_sizes = {BufferReader::page_size, BufferReader::page_size};
+    auto path = std::filesystem::temp_directory_path() / "memory-reader-test-recording-regions.bin";
+    if (RecordingReader recorder(reader, path); true) {
+        ASSERT_EQ(recorder.query_regions({}).size(), 2);
+        reader.region_sizes = {BufferReader::page_size};
+        ASSERT_TRUE(recorder.query_regions(RegionFilter{.required = RegionProtection::EXECUTE}).empty());
+        ASSERT_TRUE(recorder.read<std::uint8_t>(BufferReader::base));
+        std::this_thread::sleep_for(1ms);
+        ASSERT_EQ(recorder.query_regions({}).size(), 1);
+    }
+    auto recording = Recording::load(path);
+    std::filesystem::remove(path);
+    ASSERT_TRUE(recording);
+    ASSERT_EQ(recording->reads().size(), 1);
+
+    ASSERT_EQ(recording->regions_at(recording->reads().front().time).size(), 2)
+        << "A query not covering the regions should not drop them.";
+    ASSERT_EQ(recording->regions_at(recording->duration()).size(), 1) << "The unmapped region should be dropped.";
+}
@@ -0,0 +1,93 @@
+/**
+ * @file TestRegionReader.cpp
+ * @author UnnamedOrange
+ * @brief Test @ref split_regions and @ref RegionReader.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <memory-reader/all.h>
+
+#include "TestReaders.h"
+
+USING_MEMORY_READER_NAMESPACE;
+using namespace test_readers;
+
+namespace {
+    constexpr std::size_t page_size = 0x1000;
+} // namespace
+
+TEST(TestRegionReader, test_split_regions) {
+    std::vector<Region> regions{
+        Region{.base = 0x10000, .size = 0x2800},
+        Region{.base = 0x20000, .size = 0x1000},
+    };
+    auto chunks = split_regions(regions, RegionReaderOptions{.chunk_size = 0x1000, .overlap = 0x10});
+    ASSERT_EQ(chunks.size(), 4);
+    ASSERT_EQ(chunks[0].address, 0x10000);
+    ASSERT_EQ(chunks[0].overlap, 0x10);
+    ASSERT_EQ(chunks[2].address, 0x12000);
+    ASSERT_EQ(chunks[2].size, 0x800);
+    ASSERT_EQ(chunks[2].overlap, 0) << "The last chunk of a region should not overlap the next region.";
+    ASSERT_EQ(chunks[3].address, 0x20000);
+}
+TEST(TestRegionReader, test_read_ahead) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+    std::vector<std::uint32_t> values(0x4000);
+    for (std::size_t i = 0; i < values.size(); i++) {
+        values[i] = static_cast<std::uint32_t>(i);
+    }
+    const auto base = reinterpret_cast<std::uintptr_t>(values.data());
+    std::vector<Region> regions{
+        Region{.base = base, .size = values.size() * sizeof(std::uint32_t) / 2},
+        Region{.base = 0, .size = 0x1000},
+        Region{.base = base + values.size() * sizeof(std::uint32_t) / 2,
+               .size = values.size() * sizeof(std::uint32_t) / 2},
+    };
+    auto chunks = split_regions(regions, RegionReaderOptions{.chunk_size = 0x1000});
+
+    RegionReader region_reader(p, chunks, RegionReaderOptions{.read_ahead = 2});
+    std::size_t visited = 0;
+    std::uintptr_t expected = base;
+    while (auto view = region_reader.next()) {
+        ASSERT_EQ(view->chunk.address, expected) << "Chunks should be produced in order.";
+        ASSERT_EQ(std::memcmp(view->data.data(), reinterpret_cast<const void*>(expected), view->data.size()), 0);
+        expected += view->chunk.size;
+        visited++;
+    }
+    ASSERT_EQ(visited, chunks.size() - 1);
+    ASSERT_EQ(region_reader.failed_pages(), 1) << "The chunk at address 0 should fail.";
+}
+TEST(TestRegionReader, test_salvage_pages) {
+    constexpr std::size_t pages = 4;
+    constexpr auto base = BufferReader::base;
+    BufferReader reader;
+    reader.data.resize(pages * page_size);
+    reader.hole = base + page_size;
+
+    for (std::size_t read_ahead : {0, 2}) {
+        auto chunks = split_regions(reader.regions(), RegionReaderOptions{.chunk_size = pages * page_size});
+        RegionReader region_reader(reader, chunks, RegionReaderOptions{.read_ahead = read_ahead});
+        auto view = region_reader.next();
+        ASSERT_TRUE(view);
+        ASSERT_EQ(view->chunk.address, base);
+        ASSERT_EQ(view->data.size(), page_size) << "The page before the hole should be kept.";
+        view = region_reader.next();
+        ASSERT_TRUE(view);
+        ASSERT_EQ(view->chunk.address, base + 2 * page_size);
+        ASSERT_EQ(view->data.size(), 2 * page_size) << "The pages after the hole should be kept.";
+        ASSERT_FALSE(region_reader.next());
+        ASSERT_EQ(region_reader.failed_pages(), 1) << "Only the hole should be counted.";
+    }
+}
@@ -0,0 +1,111 @@
+/**
+ * @file TestSampler.cpp
+ * @author UnnamedOrange
+ * @brief Test @ref SpscRingBuffer and @ref Sampler.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <memory-reader/all.h>
+#include <memory-reader/utils/RingBuffer.h>
+
+USING_MEMORY_READER_NAMESPACE;
+
+TEST(TestSampler, test_ring_buffer) {
+    SpscRingBuffer<int> buffer(3);
+    ASSERT_EQ(buffer.capacity(), 4) << "Capacity should be rounded up to a power of 2.";
+    for (int i = 0; i < 4; i++) {
+        ASSERT_TRUE(buffer.try_push(i));
+    }
+    ASSERT_FALSE(buffer.try_push(4)) << "Pushing into a full buffer should fail.";
+
+    int out;
+    ASSERT_TRUE(buffer.try_pop(out));
+    ASSERT_EQ(out, 0);
+    ASSERT_TRUE(buffer.try_push(4));
+
+    int expected = 1;
+    auto count = buffer.drain([&](int value) { ASSERT_EQ(value, expected++); });
+    ASSERT_EQ(count, 4);
+    ASSERT_FALSE(buffer.try_pop(out)) << "Popping from an empty buffer should fail.";
+}
+TEST(TestSampler, test_ring_buffer_concurrent) {
+    constexpr std::uint32_t total = 100000;
+    SpscRingBuffer<std::uint32_t> buffer(64);
+    std::thread producer([&] {
+        for (std::uint32_t i = 0; i < total;) {
+            if (buffer.try_push(i)) {
+                i++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    std::uint32_t expected = 0;
+    while (expected < total) {
+        if (!buffer.drain([&](std::uint32_t value) { ASSERT_EQ(value, expected++); })) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+}
+TEST(TestSampler, test_sample) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+
+    using namespace std::literals;
+
+    struct Fields {
+        std::int32_t a;
+        std::int64_t b;
+    };
+    std::atomic<std::int32_t> a = 114;
+    std::atomic<std::int64_t> b = 514;
+
+    Sampler<Fields> sampler(p,
+                            {
+                                {reinterpret_cast<std::uintptr_t>(&a), offsetof(Fields, a), sizeof(std::int32_t)},
+                                {reinterpret_cast<std::uintptr_t>(&b), offsetof(Fields, b), sizeof(std::int64_t)},
+                            },
+                            1ms);
+    std::this_thread::sleep_for(50ms);
+
+    std::size_t count = 0;
+    std::uint64_t last_sequence = 0;
+    sampler.drain([&](const Sample<Fields>& sample) {
+        ASSERT_TRUE(sample.ok);
+        ASSERT_EQ(sample.value.a, 114);
+        ASSERT_EQ(sample.value.b, 514);
+        if (count) {
+            ASSERT_GT(sample.sequence, last_sequence) << "Sequence should be increasing.";
+        }
+        last_sequence = sample.sequence;
+        count++;
+    });
+    ASSERT_GT(count, 10) << "Sampler should have sampled at about 1 kHz.";
+
+    auto stats = sampler.stats();
+    ASSERT_GE(stats.samples, count);
+    ASSERT_EQ(stats.overruns, 0) << "The ring buffer should not be full.";
+}
+TEST(TestSampler, test_invalid_period) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+    using namespace std::literals;
+    ASSERT_THROW(Sampler<std::int32_t>(p, {}, 0ms), std::invalid_argument);
+    ASSERT_THROW(Sampler<std::int32_t>(p, {}, -1ms), std::invalid_argument);
+}
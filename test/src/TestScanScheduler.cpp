@@ -0,0 +1,141 @@
+/**
+ * @file TestScanScheduler.cpp
+ * @author UnnamedOrange
+ * @brief Test @ref ScanScheduler.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <memory-reader/all.h>
+
+#include "TestReaders.h"
+
+USING_MEMORY_READER_NAMESPACE;
+using namespace test_readers;
+
+namespace {
+    using clock = std::chrono::steady_clock;
+
+    std::vector<RegionChunk> chunks_of(const std::vector<std::byte>& buf, std::size_t chunk_size) {
+        std::vector<Region> regions{Region{.base = reinterpret_cast<std::uintptr_t>(buf.data()), .size = buf.size()}};
+        return split_regions(regions, RegionReaderOptions{.chunk_size = chunk_size});
+    }
+} // namespace
+
+TEST(TestScanScheduler, test_bandwidth) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+    using namespace std::literals;
+
+    std::vector<std::byte> buf(std::size_t{1} << 20);
+    ScanScheduler scheduler(ScanBudget{.bytes_per_second = std::size_t{8} << 20});
+    ASSERT_FALSE(scheduler.estimated_completion());
+    const auto start = clock::now();
+    std::size_t visited = 0;
+    if (RegionReader region_reader(p, chunks_of(buf, 0x10000), {.read_ahead = 1, .scheduler = &scheduler}); true) {
+        ASSERT_EQ(scheduler.total_bytes(), buf.size());
+        while (auto view = region_reader.next()) {
+            visited += view->chunk.size;
+            if (visited == buf.size() / 2) {
+                ASSERT_NEAR(scheduler.progress(), 0.5, 0.1);
+                auto completion = scheduler.estimated_completion();
+                ASSERT_TRUE(completion);
+                ASSERT_GT(*completion, clock::now());
+            }
+        }
+    }
+    ASSERT_EQ(visited, buf.size());
+    ASSERT_GE(clock::now() - start, 100ms) << "1 MiB at 8 MiB/s should take 125 ms.";
+    ASSERT_EQ(scheduler.done_bytes(), buf.size());
+    ASSERT_EQ(scheduler.progress(), 1);
+}
+TEST(TestScanScheduler, test_duty_cycle) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+    using namespace std::literals;
+
+    std::vector<std::byte> buf(0x10000);
+    ScanScheduler scheduler(ScanBudget{.duty_cycle = 0.5});
+    RegionReader region_reader(p, chunks_of(buf, 0x1000), {.scheduler = &scheduler});
+    clock::duration busy{};
+    const auto start = clock::now();
+    while (auto view = region_reader.next()) {
+        // Work on the chunk for a while.
+        const auto work_start = clock::now();
+        while (clock::now() - work_start < 2ms) {
+        }
+        busy += clock::now() - work_start;
+    }
+    const auto elapsed = clock::now() - start;
+    ASSERT_GE(elapsed, busy * 19 / 10) << "Half of the time should be spent sleeping.";
+}
+TEST(TestScanScheduler, test_clamp_duty_cycle) {
+    for (double duty_cycle : {0.0, -1.0, std::numeric_limits<double>::quiet_NaN()}) {
+        ASSERT_EQ(ScanScheduler(ScanBudget{.duty_cycle = duty_cycle}).get_budget().duty_cycle,
+                  ScanScheduler::min_duty_cycle);
+    }
+    ASSERT_EQ(ScanScheduler(ScanBudget{.duty_cycle = 2}).get_budget().duty_cycle, 1);
+    ASSERT_EQ(ScanScheduler(ScanBudget{.duty_cycle = 0.5}).get_budget().duty_cycle, 0.5);
+}
+TEST(TestScanScheduler, test_priority) {
+    ASSERT_TRUE(ScanScheduler().lower_current_thread()) << "The normal priority should be left as it is.";
+    for (auto priority : {WorkerPriority::LOW, WorkerPriority::IDLE}) {
+        bool applied = false;
+        std::thread([&] { applied = ScanScheduler(ScanBudget{.priority = priority}).lower_current_thread(); }).join();
+        ASSERT_TRUE(applied) << "Lowering the priority should be allowed.";
+    }
+}
+TEST(TestScanScheduler, test_value_scanner) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+    ScanScheduler scheduler;
+    ValueScanner<std::uint32_t> scanner(
+        p, ValueScannerOptions{.filter = {.required = RegionProtection::READ | RegionProtection::WRITE,
+                                          .max_size = std::size_t{1} << 24},
+                               .threads = 2,
+                               .scheduler = &scheduler});
+    scanner.first_scan(0x5CA45C4E);
+    ASSERT_GT(scheduler.total_bytes(), 0);
+    ASSERT_EQ(scheduler.progress(), 1) << "Shares should report to the same scheduler.";
+}
+TEST(TestScanScheduler, test_other_scans) {
+    BufferReader reader;
+    reader.data.resize(4 * BufferReader::page_size);
+    reader.protection = RegionProtection::READ | RegionProtection::WRITE | RegionProtection::EXECUTE;
+    reader.put(0x1234, {0xDE, 0xAD, 0xBE, 0xEF});
+
+    if (ScanScheduler scheduler; true) {
+        DynamicSignature signature(DynamicPattern("DE AD BE EF"));
+        signature.set_scan_options(RegionReaderOptions{.read_ahead = 1, .scheduler = &scheduler});
+        ASSERT_EQ(signature.scan(reader), BufferReader::base + 0x1234);
+        ASSERT_GT(scheduler.total_bytes(), 0) << "Cold signature scans should report to the scheduler.";
+    }
+    if (ScanScheduler scheduler; true) {
+        auto map = PointerMap::build(reader, PointerScanOptions{.scheduler = &scheduler});
+        ASSERT_EQ(scheduler.done_bytes(), reader.data.size()) << "Pointer maps should report to the scheduler.";
+    }
+    if (ScanScheduler scheduler; true) {
+        auto snapshot = Snapshot::capture(reader, {}, RegionReaderOptions{.scheduler = &scheduler});
+        ASSERT_EQ(scheduler.done_bytes(), reader.data.size()) << "Snapshots should report to the scheduler.";
+    }
+    if (ScanScheduler scheduler; true) {
+        auto index = PatternIndex::build(reader, PatternIndexOptions{.scheduler = &scheduler});
+        ASSERT_EQ(scheduler.done_bytes(), reader.data.size()) << "Pattern indices should report to the scheduler.";
+    }
+}
@@ -0,0 +1,117 @@
+/**
+ * @file TestSharedExport.cpp
+ * @author UnnamedOrange
+ * @brief Test @ref ExportServer and @ref ExportClient.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#ifdef MEMORY_READER_TARGET_PLATFORM_LINUX
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <memory-reader/all.h>
+
+#include "TestReaders.h"
+
+USING_MEMORY_READER_NAMESPACE;
+using namespace test_readers;
+
+namespace {
+    /**
+     * @brief Wait until @b pred holds or time out.
+     */
+    template <typename Pred>
+    bool wait_for(Pred pred) {
+        using namespace std::literals;
+        auto deadline = std::chrono::steady_clock::now() + 2s;
+        while (!pred()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(1ms);
+        }
+        return true;
+    }
+} // namespace
+
+TEST(TestSharedExport, test_publish) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+    using namespace std::literals;
+
+    std::atomic<int> score = 114;
+    std::array<std::uint16_t, 7> combo{1, 2, 3, 4, 5, 6, 7};
+    auto pointer = &combo;
+    const auto name = "/memory-reader-test-export-" + std::to_string(getpid());
+    const std::vector<ExportField> fields{
+        {.name = "score",
+         .target = {.base = reinterpret_cast<std::uintptr_t>(&score), .offsets = {}, .size = sizeof(int)},
+         .period = 1ms},
+        {.name = "combo",
+         .target = {.base = reinterpret_cast<std::uintptr_t>(&pointer), .offsets = {0, 0}, .size = sizeof(combo)},
+         .period = 1ms},
+        {.name = "unreadable", .target = {.base = 0, .offsets = {}, .size = 4}, .period = 1ms},
+    };
+
+    SlowReader reader(p);
+    ExportClient client;
+    if (ExportServer server(reader, name, fields); true) {
+        ASSERT_TRUE(server.good());
+        client = ExportClient::try_open(name);
+        ASSERT_FALSE(client.empty());
+        ASSERT_FALSE(client.closed());
+        ASSERT_EQ(client.size(), 3);
+        ASSERT_EQ(client.name(1), "combo");
+        ASSERT_EQ(client.value_size(1), sizeof(combo));
+        ASSERT_EQ(client.get_cache_hint(), 1);
+
+        ASSERT_TRUE(wait_for([&] { return client.read<int>("score") == 114; }));
+        score = 514;
+        ASSERT_TRUE(wait_for([&] { return client.read<int>("score") == 514; })) << "Changes should be published.";
+        const auto combo_id = client.find("combo");
+        ASSERT_TRUE(combo_id);
+        ASSERT_TRUE(wait_for([&] { return client.read<decltype(combo)>(*combo_id) == combo; }));
+
+        ASSERT_FALSE(client.read<int>("unreadable"));
+        ASSERT_FALSE(client.read<int>("missing"));
+        ASSERT_FALSE(client.read<std::uint64_t>("score")) << "Sizes should match.";
+
+        const auto heartbeats = client.heartbeat_count();
+        ASSERT_TRUE(wait_for([&] { return client.heartbeat_count() > heartbeats; }))
+            << "The server should beat without any value changing.";
+        ASSERT_TRUE(client.alive(1s));
+        reader.cache_hint = 2;
+        ASSERT_TRUE(wait_for([&] { return client.get_cache_hint() == 2; }))
+            << "The cache hint should be published on every poll.";
+    }
+    ASSERT_TRUE(client.closed()) << "The client should notice the server has stopped.";
+    ASSERT_FALSE(client.alive(1s));
+    ASSERT_EQ(client.read<int>("score"), 514) << "The last values should stay readable.";
+    ASSERT_TRUE(ExportClient::try_open(name).empty()) << "The name should be removed.";
+}
+TEST(TestSharedExport, test_invalid) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+    const std::vector<ExportField> fields{{.name = std::string(40, 'x'), .target = {.offsets = {}, .size = 4}}};
+    ExportServer server(p, "memory-reader-test-export-invalid", fields);
+    ASSERT_FALSE(server.good()) << "Names too long should be rejected.";
+    ASSERT_TRUE(ExportClient::try_open("memory-reader-test-export-invalid").empty());
+}
+
+#endif
@@ -0,0 +1,243 @@
+/**
+ * @file TestSignature.cpp
+ * @author UnnamedOrange
+ * @brief Test @ref Signature and @ref DynamicSignature.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <memory-reader/all.h>
+
+#include "TestReaders.h"
+
+USING_MEMORY_READER_NAMESPACE;
+using namespace test_readers;
+
+namespace {
+    /**
+     * @brief The current process with a constant cache hint.
+     */
+    struct CurrentProcess : IReadMemoryWithCacheHint {
+        Process process = Process::try_from_current_process();
+
+        bool read_to_buf(std::uintptr_t address, void* buf, std::size_t size) const noexcept override {
+            return process.read_to_buf(address, buf, size);
+        }
+        std::vector<Region> regions() const noexcept override {
+            return process.regions();
+        }
+        std::uint64_t get_cache_hint() const noexcept override {
+            return 1;
+        }
+    };
+
+    int marker_function(int x) {
+        volatile int y = x * 0x1145 + 0x1419;
+        return y ^ 0x1981;
+    }
+
+    /**
+     * @brief Make a pattern of the first @b size bytes of code at @b address.
+     */
+    std::string code_pattern(const IReadMemory& reader, std::uintptr_t address, std::size_t size) {
+        std::string ret;
+        for (auto byte : reader.read_bytes(address, size)) {
+            char buf[4];
+            std::snprintf(buf, sizeof(buf), "%02X ", static_cast<unsigned>(byte));
+            ret += buf;
+        }
+        ret.pop_back();
+        return ret;
+    }
+} // namespace
+
+TEST(TestSignature, test_scan_all) {
+    CurrentProcess p;
+    if (p.process.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+    auto address = reinterpret_cast<std::uintptr_t>(&marker_function);
+    ASSERT_EQ(marker_function(0), 0x1419 ^ 0x1981);
+
+    DynamicSignature signature(DynamicPattern(code_pattern(p, address, 16)));
+    std::vector<std::uintptr_t> matches;
+    for (auto match : signature.scan_all(p)) {
+        matches.push_back(match);
+    }
+    ASSERT_TRUE(std::find(matches.begin(), matches.end(), address) != matches.end());
+    ASSERT_EQ(signature.scan(p), matches.front()) << "scan should return the first match.";
+
+    auto limited = signature.scan_all(p, 1);
+    ASSERT_EQ(std::ranges::distance(limited), 1);
+    ASSERT_TRUE(DynamicSignature().scan_all(p).begin() == std::default_sentinel);
+}
+TEST(TestSignature, test_static_scan_all) {
+    BufferReader reader;
+    reader.data.resize(0x200);
+    const std::vector<std::size_t> offsets{0x10, 0x83, 0x1F8};
+    for (std::size_t i = 0; i < offsets.size(); i++) {
+        const int bytes[]{0x11, 0x45, 0x14, 0x19, 0x19, 0x81, static_cast<int>(i), 0x0D};
+        for (std::size_t j = 0; j < std::size(bytes); j++) {
+            reader.data[offsets[i] + j] = std::byte(bytes[j]);
+        }
+    }
+    // A partial match is not a match.
+    reader.data[0x100] = std::byte(0x11);
+    reader.data[0x101] = std::byte(0x45);
+
+    Signature<"11 45 14 19 19 81 ?? 0D"> signature;
+    std::vector<std::uintptr_t> matches;
+    for (auto match : signature.scan_all(reader)) {
+        matches.push_back(match);
+    }
+    ASSERT_EQ(matches, (std::vector<std::uintptr_t>{BufferReader::base + offsets[0], BufferReader::base + offsets[1],
+                                                    BufferReader::base + offsets[2]}));
+    matches.clear();
+    for (auto match : signature.scan_all(reader, 2)) {
+        matches.push_back(match);
+    }
+    ASSERT_EQ(matches, (std::vector<std::uintptr_t>{BufferReader::base + offsets[0], BufferReader::base + offsets[1]}));
+}
+TEST(TestSignature, test_resolve) {
+    BufferReader reader;
+    // lea rax, [rip + 0x100]; mov eax, [0x12345678]
+    for (int byte : {0x90, 0x48, 0x8D, 0x05, 0x00, 0x01, 0x00, 0x00, 0xA1, 0x78, 0x56, 0x34, 0x12}) {
+        reader.data.push_back(std::byte(byte));
+    }
+    reader.data.resize(0x200);
+
+    Signature<"48 8D 05 @?? ?? ?? ??", rel32()> signature_rel32;
+    ASSERT_EQ(signature_rel32.scan(reader), BufferReader::base + 1);
+    ASSERT_EQ(signature_rel32.resolve(reader), BufferReader::base + 8 + 0x100);
+    reader.read_count = 0;
+    ASSERT_EQ(signature_rel32.resolve(reader), BufferReader::base + 8 + 0x100);
+    ASSERT_EQ(reader.read_count, 0) << "Cache hits should not read.";
+    reader.cache_hint = 0;
+    ASSERT_EQ(signature_rel32.resolve(reader), BufferReader::base + 8 + 0x100);
+    ASSERT_GT(reader.read_count, 0) << "A cache hint of 0 should not be cached.";
+    ASSERT_EQ(signature_rel32.try_resolve(reader), std::nullopt);
+    reader.cache_hint = 1;
+
+    Signature<"A1 ?? ?? ?? ??", abs32(1), add(-0x8)> signature_abs32;
+    ASSERT_EQ(signature_abs32.resolve(reader), 0x12345678 - 0x8);
+
+    DynamicSignature dynamic_signature(DynamicPattern("8D 05 [4] @A1"), {to_marker(), abs32(1)});
+    ASSERT_EQ(dynamic_signature.resolve(reader), 0x12345678);
+    DynamicSignature no_marker(DynamicPattern("8D 05"), {rel32()});
+    ASSERT_EQ(no_marker.scan(reader), BufferReader::base + 2);
+    ASSERT_EQ(no_marker.resolve(reader), std::nullopt);
+}
+TEST(TestSignature, test_retry_steps) {
+    BufferReader reader;
+    // mov eax, [0x12345678]
+    for (int byte : {0x90, 0xA1, 0x78, 0x56, 0x34, 0x12}) {
+        reader.data.push_back(std::byte(byte));
+    }
+    reader.data.resize(0x200);
+
+    Signature<"A1 @?? ?? ?? ??", abs32(), abs32(0)> signature;
+    ASSERT_EQ(signature.resolve(reader), std::nullopt) << "The pointer does not point into the buffer yet.";
+    ASSERT_EQ(signature.scan(reader), BufferReader::base + 1) << "The match should be cached anyway.";
+
+    // Point to a pointer in the buffer.
+    const auto pointer = static_cast<std::uint32_t>(BufferReader::base + 0x100);
+    const auto target = std::uint32_t{0x87654321};
+    std::memcpy(reader.data.data() + 2, &pointer, sizeof(pointer));
+    std::memcpy(reader.data.data() + 0x100, &target, sizeof(target));
+    reader.read_size = 0;
+    ASSERT_EQ(signature.resolve(reader), target);
+    ASSERT_LT(reader.read_size, reader.data.size()) << "Only the steps should be applied again.";
+}
+
+TEST(TestSignature, test_history) {
+    BufferReader reader;
+    reader.path = "/usr/lib/module.so";
+    reader.data.resize(0x100000);
+    const std::array<std::byte, 6> bytes{std::byte(0xDE), std::byte(0xAD), std::byte(0xBE),
+                                         std::byte(0xEF), std::byte(0x13), std::byte(0x37)};
+    auto put = [&](std::size_t offset) {
+        std::ranges::fill(reader.data, std::byte{});
+        std::ranges::copy(bytes, reader.data.begin() + static_cast<std::ptrdiff_t>(offset));
+    };
+
+    Signature<"DE AD BE EF 13 37"> signature;
+    ASSERT_EQ(signature.history(), std::nullopt);
+    put(0x80000);
+    ASSERT_EQ(signature.scan(reader), BufferReader::base + 0x80000);
+    ASSERT_EQ(signature.history(), (SignatureHistory{.module = reader.path, .offset = 0x80000}));
+
+    // The last hit is verified by one read.
+    reader.cache_hint++;
+    reader.read_count = 0;
+    ASSERT_EQ(signature.scan(reader), BufferReader::base + 0x80000);
+    ASSERT_EQ(reader.read_count, 1);
+
+    // A slightly moved match is found in the neighborhood.
+    put(0x80040);
+    reader.cache_hint++;
+    reader.read_size = 0;
+    ASSERT_EQ(signature.scan(reader), BufferReader::base + 0x80040);
+    ASSERT_LT(reader.read_size, reader.data.size() / 4);
+
+    // A far away match is still found, and the history is restored in another signature.
+    put(0x10);
+    reader.cache_hint++;
+    ASSERT_EQ(signature.scan(reader), BufferReader::base + 0x10);
+    DynamicSignature dynamic_signature(DynamicPattern("DE AD BE EF 13 37"));
+    dynamic_signature.set_history(signature.history());
+    reader.read_count = 0;
+    ASSERT_EQ(dynamic_signature.scan(reader), BufferReader::base + 0x10);
+    ASSERT_EQ(reader.read_count, 1);
+}
+
+TEST(TestSignature, test_single_flight) {
+    using namespace std::literals;
+    BufferReader buffer;
+    buffer.data.resize(0x1000);
+    buffer.data[0x100] = std::byte(0xCC);
+    SlowReader reader(buffer, {}, 200ms);
+    Signature<"CC 00 00"> signature;
+    ASSERT_EQ(signature.try_scan(reader), std::nullopt) << "try_scan should not scan.";
+    ASSERT_EQ(reader.scan_count, 0);
+
+    std::array<std::optional<std::uintptr_t>, 4> results;
+    std::vector<std::thread> threads;
+    threads.emplace_back([&] { results[0] = signature.scan(reader); });
+    while (!reader.scan_count) {
+        std::this_thread::yield();
+    }
+    for (std::size_t i = 1; i < results.size(); i++) {
+        threads.emplace_back([&, i] { results[i] = signature.scan(reader); });
+    }
+    std::optional<std::uintptr_t> timed_out = 0;
+    threads.emplace_back([&] { timed_out = signature.scan(reader, 1ms); });
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(reader.scan_count, 1) << "Concurrent misses should be coalesced into one scan.";
+    for (const auto& result : results) {
+        ASSERT_EQ(result, BufferReader::base + 0x100);
+    }
+    ASSERT_EQ(timed_out, std::nullopt) << "Waiting for another scan should time out.";
+    ASSERT_EQ(signature.try_scan(reader), BufferReader::base + 0x100);
+    reader.cache_hint++;
+    ASSERT_EQ(signature.try_scan(reader), std::nullopt) << "try_scan should miss once the cache hint changes.";
+}
@@ -0,0 +1,75 @@
+/**
+ * @file TestSignatureManifest.cpp
+ * @author UnnamedOrange
+ * @brief Test @ref SignatureManifest.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <memory-reader/all.h>
+
+#include "TestReaders.h"
+
+USING_MEMORY_READER_NAMESPACE;
+using namespace test_readers;
+
+TEST(TestSignatureManifest, test_parse) {
+    constexpr std::string_view text = R"(
+# Signatures of the test buffer.
+lea_target = 48 8D 05 @?? ?? ?? ?? => rel32
+abs_value  = A1 ?? ?? ?? ??          => abs32(1) add(-0x8)
+marked     = 8D 05 [4] @A1           => to_marker abs32(1)
+plain=8D 05   # No steps.
+)";
+    ManifestError error{};
+    auto manifest = SignatureManifest::try_parse(text, &error);
+    ASSERT_TRUE(manifest.has_value()) << error.line << ":" << error.column << ": " << error.message;
+    ASSERT_EQ(manifest->size(), 4);
+    ASSERT_EQ(manifest->names(), (std::vector<std::string_view>{"abs_value", "lea_target", "marked", "plain"}));
+    ASSERT_EQ(manifest->find("missing"), nullptr);
+
+    BufferReader reader;
+    // lea rax, [rip + 0x100]; mov eax, [0x12345678]
+    for (int byte : {0x90, 0x48, 0x8D, 0x05, 0x00, 0x01, 0x00, 0x00, 0xA1, 0x78, 0x56, 0x34, 0x12}) {
+        reader.data.push_back(std::byte(byte));
+    }
+    reader.data.resize(0x200);
+    ASSERT_EQ(manifest->find("lea_target")->resolve(reader), BufferReader::base + 8 + 0x100);
+    ASSERT_EQ(manifest->find("abs_value")->resolve(reader), 0x12345678 - 0x8);
+    ASSERT_EQ(manifest->find("marked")->resolve(reader), 0x12345678);
+    ASSERT_EQ(manifest->find("plain")->resolve(reader), BufferReader::base + 2);
+}
+TEST(TestSignatureManifest, test_errors) {
+    ManifestError error{};
+    ASSERT_EQ(SignatureManifest::try_parse("a = E8\nb = E8 1G", &error), std::nullopt);
+    ASSERT_EQ(error.line, 2);
+    ASSERT_EQ(error.column, 8);
+    ASSERT_EQ(SignatureManifest::try_parse("a = E8 ?? => rel32", &error), std::nullopt)
+        << "rel32 without an offset needs a marker.";
+    ASSERT_EQ(SignatureManifest::try_parse("a = E8 => jump", &error), std::nullopt);
+    ASSERT_EQ(error.column, 11);
+    ASSERT_EQ(SignatureManifest::try_parse("a = E8\na = E9", &error), std::nullopt);
+    ASSERT_EQ(SignatureManifest::try_parse("a E8", &error), std::nullopt);
+    ASSERT_EQ(SignatureManifest::try_load("/nonexistent/manifest.txt", &error), std::nullopt);
+    ASSERT_EQ(error.line, 0);
+}
+TEST(TestSignatureManifest, test_integer_range) {
+    auto parse_add = [](const std::string& argument) {
+        return SignatureManifest::try_parse("a = E8 => add(" + argument + ")").has_value();
+    };
+    const auto max = static_cast<std::uintmax_t>(INTPTR_MAX);
+    ASSERT_TRUE(parse_add(std::to_string(max)));
+    ASSERT_TRUE(parse_add("-" + std::to_string(max)));
+    ASSERT_FALSE(parse_add(std::to_string(max + 1))) << "Values above INTPTR_MAX should be rejected.";
+    ASSERT_FALSE(parse_add("-" + std::to_string(max + 1))) << "INTPTR_MIN is reserved for the marker.";
+    ASSERT_FALSE(parse_add("0x" + std::string(2 * sizeof(std::uintmax_t) + 1, 'F'))) << "Overflow should be rejected.";
+}
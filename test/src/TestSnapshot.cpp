@@ -0,0 +1,165 @@
+/**
+ * @file TestSnapshot.cpp
+ * @author UnnamedOrange
+ * @brief Test @ref Snapshot and @ref diff.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <memory-reader/all.h>
+
+#include "TestReaders.h"
+
+USING_MEMORY_READER_NAMESPACE;
+using namespace test_readers;
+
+namespace {
+    /**
+     * @brief Page-aligned buffer of 4 pages, with the filter selecting only the region containing it.
+     */
+    struct AlignedPages {
+        static constexpr std::size_t count = 4;
+        std::unique_ptr<std::byte[]> storage = std::make_unique<std::byte[]>((count + 1) * Snapshot::page_size);
+        std::byte* data = reinterpret_cast<std::byte*>(
+            (reinterpret_cast<std::uintptr_t>(storage.get()) + Snapshot::page_size - 1) & ~(Snapshot::page_size - 1));
+
+        RegionFilter filter() const {
+            auto address = reinterpret_cast<std::uintptr_t>(data);
+            return RegionFilter{
+                .required = RegionProtection::READ | RegionProtection::WRITE,
+                .min_address = address - 0x1000000,
+                .max_address = address,
+            };
+        }
+    };
+} // namespace
+
+TEST(TestSnapshot, test_query_regions) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+
+    auto writable = p.query_regions(RegionFilter{.required = RegionProtection::READ | RegionProtection::WRITE});
+    ASSERT_FALSE(writable.empty()) << "There should be writable regions.";
+    for (const auto& region : writable) {
+        ASSERT_EQ(region.protection & RegionProtection::WRITE, RegionProtection::WRITE);
+    }
+    for (const auto& region : p.regions()) {
+        ASSERT_EQ(region.protection & RegionProtection::EXECUTE, RegionProtection::EXECUTE)
+            << "regions() should only return executable regions.";
+    }
+}
+TEST(TestSnapshot, test_capture_and_diff) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+
+    AlignedPages pages;
+    auto address = reinterpret_cast<std::uintptr_t>(pages.data);
+    auto before = Snapshot::capture(p, pages.filter());
+    ASSERT_FALSE(before.regions().empty());
+
+    std::vector<std::byte> read(AlignedPages::count * Snapshot::page_size);
+    ASSERT_TRUE(before.read_to_buf(address, read.data(), read.size()));
+    ASSERT_EQ(read, std::vector<std::byte>(read.size())) << "Pages should be captured as zeroed.";
+
+    pages.data[10] = std::byte{1};
+    pages.data[11] = std::byte{2};
+    pages.data[2 * Snapshot::page_size + 100] = std::byte{3};
+    auto after = Snapshot::capture(p, pages.filter());
+
+    auto changes = diff(before, after);
+    auto contains = [&](ChangedRange expected) {
+        for (const auto& range : changes) {
+            if (range == expected) {
+                return true;
+            }
+        }
+        return false;
+    };
+    ASSERT_TRUE(contains({.address = address + 10, .size = 2}));
+    ASSERT_TRUE(contains({.address = address + 2 * Snapshot::page_size + 100, .size = 1}));
+    ASSERT_TRUE(diff(after, after).empty()) << "A snapshot should not differ from itself.";
+}
+TEST(TestSnapshot, test_save_and_load) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+
+    AlignedPages pages;
+    pages.data[0] = std::byte{0x11};
+    auto snapshot = Snapshot::capture(p, pages.filter());
+
+    auto path = std::filesystem::temp_directory_path() / "memory-reader-test-snapshot.bin";
+    ASSERT_TRUE(snapshot.save(path));
+    auto loaded = Snapshot::load(path);
+    std::filesystem::remove(path);
+    ASSERT_TRUE(loaded);
+    ASSERT_EQ(loaded->regions().size(), snapshot.regions().size());
+    ASSERT_EQ(loaded->unique_pages(), snapshot.unique_pages());
+
+    std::byte read{};
+    ASSERT_TRUE(loaded->read_to_buf(reinterpret_cast<std::uintptr_t>(pages.data), &read, 1));
+    ASSERT_EQ(read, std::byte{0x11});
+}
+TEST(TestSnapshot, test_unreadable_page) {
+    constexpr auto page_size = Snapshot::page_size;
+    BufferReader reader;
+    reader.data.resize(4 * page_size);
+    reader.data[3 * page_size] = std::byte{0x22};
+    reader.protection = RegionProtection::READ | RegionProtection::WRITE;
+    reader.region_sizes = {3 * page_size, page_size};
+    reader.hole = BufferReader::base + page_size;
+
+    for (std::size_t read_ahead : {0, 2}) {
+        auto snapshot = Snapshot::capture(reader, {}, RegionReaderOptions{.chunk_size = 2 * page_size + 1,
+                                                                          .read_ahead = read_ahead});
+        ASSERT_EQ(snapshot.regions().size(), 2);
+        ASSERT_EQ(snapshot.regions()[0].pages.size(), 3);
+        ASSERT_EQ(snapshot.regions()[0].pages[1], Snapshot::no_page) << "The hole should be recorded.";
+        ASSERT_NE(snapshot.regions()[0].pages[2], Snapshot::no_page) << "The page after the hole should be kept.";
+        ASSERT_EQ(snapshot.regions()[1].pages.size(), 1);
+        ASSERT_EQ(snapshot.unique_pages(), 2) << "Zeroed pages should be stored once.";
+
+        std::byte read{};
+        ASSERT_FALSE(snapshot.read_to_buf(BufferReader::base + page_size, &read, 1));
+        ASSERT_TRUE(snapshot.read_to_buf(BufferReader::base + 3 * page_size, &read, 1));
+        ASSERT_EQ(read, std::byte{0x22});
+    }
+}
+TEST(TestSnapshot, test_capture_incremental) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+
+    AlignedPages pages;
+    auto address = reinterpret_cast<std::uintptr_t>(pages.data);
+    auto before = Snapshot::capture(p, pages.filter());
+
+    pages.data[0] = std::byte{1};
+    pages.data[2 * Snapshot::page_size + 5] = std::byte{2};
+    std::vector<ChangedRange> dirty{{.address = address + 2 * Snapshot::page_size, .size = Snapshot::page_size}};
+    auto after = Snapshot::capture_incremental(p, before, dirty);
+    ASSERT_EQ(after.regions().size(), before.regions().size());
+
+    std::byte read{};
+    ASSERT_TRUE(after.read_to_buf(address, &read, 1));
+    ASSERT_EQ(read, std::byte{0}) << "Clean pages should be taken from the previous snapshot.";
+    ASSERT_TRUE(after.read_to_buf(address + 2 * Snapshot::page_size + 5, &read, 1));
+    ASSERT_EQ(read, std::byte{2});
+    ASSERT_EQ(diff(before, after), (std::vector<ChangedRange>{{.address = address + 2 * Snapshot::page_size + 5,
+                                                               .size = 1}}));
+}
@@ -0,0 +1,172 @@
+/**
+ * @file TestStrings.cpp
+ * @author UnnamedOrange
+ * @brief Test @ref ClrString, @ref CString, @ref ClrArray and @ref ClrList.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <memory-reader/all.h>
+
+USING_MEMORY_READER_NAMESPACE;
+
+namespace {
+    /**
+     * @brief Lay out a System.String of the current process in a buffer.
+     */
+    std::vector<std::byte> make_clr_string(std::u16string_view str) {
+        std::vector<std::byte> ret(sizeof(std::uintptr_t) + sizeof(std::int32_t) + str.size() * sizeof(char16_t));
+        auto length = static_cast<std::int32_t>(str.size());
+        std::memcpy(ret.data() + sizeof(std::uintptr_t), &length, sizeof(length));
+        std::memcpy(ret.data() + sizeof(std::uintptr_t) + sizeof(length), str.data(), str.size() * sizeof(char16_t));
+        return ret;
+    }
+} // namespace
+
+TEST(TestStrings, test_clr_string) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+
+    for (auto ground_truth : {u"", u"osu!", u"A string much longer than the inline part of the first read."}) {
+        auto object = make_clr_string(ground_truth);
+        auto read = ClrString<PtrWidth::IS_CURRENT>{}.read_u16(p, reinterpret_cast<std::uintptr_t>(object.data()));
+        ASSERT_TRUE(read);
+        ASSERT_EQ(*read, ground_truth);
+    }
+
+    auto object = make_clr_string(u"osu!");
+    auto read = ClrString<PtrWidth::IS_CURRENT>{}.read(p, reinterpret_cast<std::uintptr_t>(object.data()));
+    ASSERT_TRUE(read);
+    ASSERT_EQ(*read, "osu!");
+    auto too_long = ClrString<PtrWidth::IS_CURRENT, 3>{}.read(p, reinterpret_cast<std::uintptr_t>(object.data()));
+    ASSERT_FALSE(too_long) << "Strings longer than max_length should be rejected.";
+}
+TEST(TestStrings, test_c_string) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+
+    std::string ground_truth(1000, 'x');
+    auto read = CString<char, 0x10000, 64>{}.read(p, reinterpret_cast<std::uintptr_t>(ground_truth.c_str()));
+    ASSERT_TRUE(read);
+    ASSERT_EQ(*read, ground_truth);
+
+    auto truncated = CString<char, 999>{}.read(p, reinterpret_cast<std::uintptr_t>(ground_truth.c_str()));
+    ASSERT_FALSE(truncated) << "Strings longer than max_length should be rejected.";
+
+    std::u16string wide = u"wide";
+    auto wide_read = CString<char16_t>{}.read(p, reinterpret_cast<std::uintptr_t>(wide.c_str()));
+    ASSERT_TRUE(wide_read);
+    ASSERT_EQ(*wide_read, "wide");
+}
+TEST(TestStrings, test_std_string) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+
+#if defined(__GLIBCXX__) && _GLIBCXX_USE_CXX11_ABI
+    for (std::string ground_truth : {"short", "a string which does not fit in the local buffer"}) {
+        auto read = LibstdcxxString<PtrWidth::IS_CURRENT>{}.read(p, reinterpret_cast<std::uintptr_t>(&ground_truth));
+        ASSERT_TRUE(read);
+        ASSERT_EQ(*read, ground_truth);
+    }
+#elif defined(_MSC_VER)
+    for (std::string ground_truth : {"short", "a string which does not fit in the local buffer"}) {
+        auto read = MsvcString<PtrWidth::IS_CURRENT>{}.read(p, reinterpret_cast<std::uintptr_t>(&ground_truth));
+        ASSERT_TRUE(read);
+        ASSERT_EQ(*read, ground_truth);
+    }
+#else
+    GTEST_SKIP() << "The standard library of the current process is not supported.";
+#endif
+}
+TEST(TestStrings, test_std_string_corrupted_size) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+
+    // Objects claiming inline storage, so that the size is the only thing to check.
+    struct {
+        std::uintptr_t ptr;
+        std::uintptr_t size;
+        char buf[16];
+    } libstdcxx{0, 0, "short"};
+    libstdcxx.ptr = reinterpret_cast<std::uintptr_t>(&libstdcxx.buf);
+    struct {
+        char buf[16];
+        std::uintptr_t size;
+        std::uintptr_t capacity;
+    } msvc{"short", 0, 15};
+
+    for (std::uintptr_t size : {5, 15, 16, 0x1000}) {
+        libstdcxx.size = size;
+        msvc.size = size;
+        auto libstdcxx_read =
+            LibstdcxxString<PtrWidth::IS_CURRENT>{}.read(p, reinterpret_cast<std::uintptr_t>(&libstdcxx));
+        auto msvc_read = MsvcString<PtrWidth::IS_CURRENT>{}.read(p, reinterpret_cast<std::uintptr_t>(&msvc));
+        if (size < 16) {
+            ASSERT_TRUE(libstdcxx_read);
+            ASSERT_EQ(libstdcxx_read->size(), size);
+            ASSERT_TRUE(msvc_read);
+            ASSERT_EQ(msvc_read->size(), size);
+        } else {
+            ASSERT_FALSE(libstdcxx_read) << "An inline string should leave room for the terminator.";
+            ASSERT_FALSE(msvc_read) << "An inline string should leave room for the terminator.";
+        }
+    }
+}
+TEST(TestStrings, test_clr_list) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+
+    // Backing array of capacity 4 holding 3 valid elements.
+    std::array<std::uintptr_t, 2 + 4> array{0, 4, 114, 514, 1919810, 0};
+    auto array_read =
+        ClrArray<PtrWidth::IS_CURRENT, std::uintptr_t>{}.read(p, reinterpret_cast<std::uintptr_t>(&array));
+    ASSERT_TRUE(array_read);
+    ASSERT_EQ(*array_read, (std::vector<std::uintptr_t>{114, 514, 1919810, 0}));
+
+    struct {
+        std::uintptr_t method_table;
+        std::uintptr_t items;
+        std::int32_t size;
+        std::int32_t version;
+    } list{0, reinterpret_cast<std::uintptr_t>(&array), 3, 0};
+    auto list_read = ClrList<PtrWidth::IS_CURRENT, std::uintptr_t>{ClrRuntime::CORE}.read(
+        p, reinterpret_cast<std::uintptr_t>(&list));
+    ASSERT_TRUE(list_read);
+    ASSERT_EQ(*list_read, (std::vector<std::uintptr_t>{114, 514, 1919810}));
+
+    // .NET Framework keeps a reference to the sync root before the count.
+    struct {
+        std::uintptr_t method_table;
+        std::uintptr_t items;
+        std::uintptr_t sync_root;
+        std::int32_t size;
+        std::int32_t version;
+    } framework_list{0, reinterpret_cast<std::uintptr_t>(&array), 1, 2, 0};
+    auto framework_read = ClrList<PtrWidth::IS_CURRENT, std::uintptr_t>{ClrRuntime::FRAMEWORK}.read(
+        p, reinterpret_cast<std::uintptr_t>(&framework_list));
+    ASSERT_TRUE(framework_read);
+    ASSERT_EQ(*framework_read, (std::vector<std::uintptr_t>{114, 514}));
+    auto core_read = ClrList<PtrWidth::IS_CURRENT, std::uintptr_t>{ClrRuntime::CORE}.read(
+        p, reinterpret_cast<std::uintptr_t>(&framework_list));
+    ASSERT_EQ(core_read, (std::vector<std::uintptr_t>{114}))
+        << "The sync root should be taken as the count with the layout of .NET Core.";
+}
@@ -0,0 +1,172 @@
+/**
+ * @file TestValueScanner.cpp
+ * @author UnnamedOrange
+ * @brief Test @ref ValueScanner.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <memory-reader/all.h>
+
+#include "TestReaders.h"
+
+USING_MEMORY_READER_NAMESPACE;
+using namespace test_readers;
+
+namespace {
+    constexpr std::size_t page_size = 0x1000;
+} // namespace
+
+TEST(TestValueScanner, test_first_and_next_scan) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+
+    constexpr std::size_t count = 0x4000;
+    constexpr std::int32_t magic = 0x5CA77E12;
+    constexpr std::size_t sparse = 997 * 14;
+    auto values = std::make_unique<std::int32_t[]>(count);
+    // Dense hits in the first half and sparse hits in the second half.
+    for (std::size_t i = 0; i < count; i++) {
+        values[i] = (i < count / 2 || i % 997 == 0) ? magic : static_cast<std::int32_t>(i);
+    }
+    auto address = reinterpret_cast<std::uintptr_t>(values.get());
+    auto is_ours = [&](std::uintptr_t a) { return a >= address && a < address + count * sizeof(std::int32_t); };
+
+    ValueScanner<std::int32_t> scanner(p, ValueScannerOptions{
+                                              .filter = {.required = RegionProtection::READ | RegionProtection::WRITE},
+                                              .alignment = 0,
+                                              .threads = 2,
+                                              .chunk_size = 0x4000,
+                                          });
+    scanner.first_scan(magic);
+    auto ours = [&] {
+        auto addresses = scanner.addresses();
+        return static_cast<std::size_t>(std::count_if(addresses.begin(), addresses.end(), is_ours));
+    };
+    ASSERT_EQ(ours(), count / 2 + (count - 1) / 997 - (count / 2 - 1) / 997);
+    auto addresses = scanner.addresses();
+    ASSERT_TRUE(std::is_sorted(addresses.begin(), addresses.end()));
+
+    values[0] = magic + 1;
+    values[sparse] = magic - 1;
+    scanner.next_scan(ScanCompare::CHANGED);
+    addresses = scanner.addresses();
+    ASSERT_TRUE(std::find(addresses.begin(), addresses.end(), address) != addresses.end());
+    ASSERT_TRUE(std::find(addresses.begin(), addresses.end(), address + sparse * sizeof(std::int32_t)) !=
+                addresses.end());
+    ASSERT_EQ(ours(), 2);
+
+    scanner.next_scan(ScanCompare::INCREASED);
+    ASSERT_EQ(ours(), 0) << "Nothing increased since the last scan.";
+
+    scanner.first_scan(magic);
+    values[1] = 7;
+    scanner.next_scan(ScanCompare::EXACT, 7);
+    addresses = scanner.addresses();
+    std::erase_if(addresses, [&](std::uintptr_t a) { return !is_ours(a); });
+    ASSERT_EQ(addresses, std::vector<std::uintptr_t>{address + sizeof(std::int32_t)});
+}
+TEST(TestValueScanner, test_unreadable_page) {
+    constexpr std::size_t pages = 4;
+    constexpr std::size_t per_page = page_size / sizeof(std::int32_t);
+    constexpr std::int32_t magic = 0x6A1E0B17;
+    constexpr auto address = BufferReader::base;
+    BufferReader reader;
+    reader.protection = RegionProtection::READ | RegionProtection::WRITE;
+    reader.data.resize(pages * page_size);
+    for (std::size_t i = 0; i < pages * per_page; i++) {
+        std::memcpy(reader.data.data() + i * sizeof(magic), &magic, sizeof(magic));
+    }
+
+    ValueScanner<std::int32_t> scanner(reader, ValueScannerOptions{.threads = 1, .chunk_size = pages * page_size});
+    reader.hole = address + page_size;
+    ASSERT_EQ(scanner.first_scan(magic), (pages - 1) * per_page) << "Readable pages should be scanned.";
+    reader.hole = address + 2 * page_size;
+    ASSERT_EQ(scanner.next_scan(ScanCompare::UNCHANGED), (pages - 2) * per_page)
+        << "Only candidates in the unreadable page should be dropped.";
+}
+TEST(TestValueScanner, test_unaligned) {
+    constexpr std::uint32_t magic = 0x3C5A9E71;
+    BufferReader reader;
+    reader.protection = RegionProtection::READ | RegionProtection::WRITE;
+    reader.data.resize(2 * page_size);
+    // The value crosses the end of a chunk.
+    std::memcpy(reader.data.data() + page_size - 2, &magic, sizeof(magic));
+
+    ValueScanner<std::uint32_t> scanner(reader,
+                                        ValueScannerOptions{.alignment = 1, .threads = 1, .chunk_size = page_size});
+    scanner.first_scan(magic);
+    ASSERT_EQ(scanner.addresses(), std::vector<std::uintptr_t>{BufferReader::base + page_size - 2});
+    ASSERT_EQ(scanner.next_scan(ScanCompare::UNCHANGED), 1);
+}
+TEST(TestValueScanner, test_next_scan_dirty) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+
+    constexpr std::size_t pages = 4;
+    constexpr std::size_t per_page = page_size / sizeof(std::int32_t);
+    constexpr std::int32_t magic = 0x2D1B7A55;
+    auto storage = std::make_unique<std::int32_t[]>((pages + 1) * per_page);
+    auto values = reinterpret_cast<std::int32_t*>(
+        (reinterpret_cast<std::uintptr_t>(storage.get()) + page_size - 1) & ~(page_size - 1));
+    std::fill(values, values + pages * per_page, magic);
+    auto address = reinterpret_cast<std::uintptr_t>(values);
+    auto ours = [&](const ValueScanner<std::int32_t>& scanner) {
+        auto addresses = scanner.addresses();
+        return static_cast<std::size_t>(std::count_if(addresses.begin(), addresses.end(), [&](std::uintptr_t a) {
+            return a >= address && a < address + pages * page_size;
+        }));
+    };
+
+    ValueScanner<std::int32_t> scanner(p, ValueScannerOptions{
+                                              .filter = {.required = RegionProtection::READ | RegionProtection::WRITE},
+                                              .alignment = 0,
+                                              .threads = 2,
+                                              .chunk_size = page_size,
+                                          });
+    scanner.first_scan(magic);
+    ASSERT_EQ(ours(scanner), pages * per_page);
+
+    values[0] = magic + 1;
+    values[2 * per_page] = magic + 1;
+    std::vector<ChangedRange> dirty{{.address = address + 2 * page_size, .size = page_size}};
+    scanner.next_scan(ScanCompare::EXACT, magic, dirty);
+    ASSERT_EQ(ours(scanner), pages * per_page - 1) << "Only the dirty page should be read.";
+
+    scanner.next_scan(ScanCompare::EXACT, magic);
+    ASSERT_EQ(ours(scanner), pages * per_page - 2);
+    scanner.next_scan(ScanCompare::CHANGED, 0, std::vector<ChangedRange>{});
+    ASSERT_EQ(ours(scanner), 0) << "Nothing changes without dirty pages.";
+}
+TEST(TestValueScanner, test_next_scan_dirty_overlap) {
+    constexpr std::uint32_t magic = 0x4E83B2D9;
+    BufferReader reader;
+    reader.protection = RegionProtection::READ | RegionProtection::WRITE;
+    reader.data.resize(2 * page_size);
+    // The value starts in the first block and ends in the second page.
+    std::memcpy(reader.data.data() + page_size - 2, &magic, sizeof(magic));
+
+    ValueScanner<std::uint32_t> scanner(reader,
+                                        ValueScannerOptions{.alignment = 1, .threads = 1, .chunk_size = page_size});
+    scanner.first_scan(magic);
+    ASSERT_EQ(scanner.count(), 1);
+
+    reader.data[page_size] = ~reader.data[page_size];
+    std::vector<ChangedRange> dirty{{.address = BufferReader::base + page_size, .size = page_size}};
+    ASSERT_EQ(scanner.next_scan(ScanCompare::UNCHANGED, 0, dirty), 0)
+        << "A value ending in a dirty page should be read again.";
+}
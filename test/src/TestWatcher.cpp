@@ -0,0 +1,139 @@
+/**
+ * @file TestWatcher.cpp
+ * @author UnnamedOrange
+ * @brief Test @ref Watcher.
+ *
+ * @copyright Copyright (c) UnnamedOrange. Licensed under the MIT License.
+ * See the LICENSE file in the repository root for full license text.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <memory-reader/all.h>
+
+USING_MEMORY_READER_NAMESPACE;
+
+namespace {
+    /**
+     * @brief Wait until @b pred holds or time out.
+     */
+    template <typename Pred>
+    bool wait_for(Pred pred) {
+        using namespace std::literals;
+        auto deadline = std::chrono::steady_clock::now() + 2s;
+        while (!pred()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(1ms);
+        }
+        return true;
+    }
+} // namespace
+
+TEST(TestWatcher, test_notify_on_change) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+
+    using namespace std::literals;
+
+    std::atomic<int> ground_truth = 114;
+    int* pointer = reinterpret_cast<int*>(&ground_truth);
+
+    std::mutex m;
+    std::vector<int> seen_direct;
+    std::vector<int> seen_chain;
+    std::vector<int> seen_dynamic;
+
+    Watcher watcher(p);
+    watcher.subscribe(ValueOffsets<PtrWidth::IS_CURRENT, int, 0>{}, reinterpret_cast<std::uintptr_t>(&ground_truth),
+                      1ms, [&](std::optional<int> value) {
+                          std::lock_guard _(m);
+                          seen_direct.push_back(value.value_or(-1));
+                      });
+    watcher.subscribe(ValueOffsets<PtrWidth::IS_CURRENT, int, 0, 0>{}, reinterpret_cast<std::uintptr_t>(&pointer),
+                      1ms, [&](std::optional<int> value) {
+                          std::lock_guard _(m);
+                          seen_chain.push_back(value.value_or(-1));
+                      });
+    watcher.subscribe(DynamicOffsets<PtrWidth::IS_CURRENT, int>{0, 0}, reinterpret_cast<std::uintptr_t>(&pointer),
+                      1ms, [&](std::optional<int> value) {
+                          std::lock_guard _(m);
+                          seen_dynamic.push_back(value.value_or(-1));
+                      });
+
+    ASSERT_TRUE(wait_for([&] {
+        std::lock_guard _(m);
+        return !seen_direct.empty() && !seen_chain.empty() && !seen_dynamic.empty();
+    })) << "Subscribers should be notified of the first read.";
+
+    ground_truth = 514;
+    ASSERT_TRUE(wait_for([&] {
+        std::lock_guard _(m);
+        return seen_direct.back() == 514 && seen_chain.back() == 514 && seen_dynamic.back() == 514;
+    })) << "Subscribers should be notified of the change.";
+
+    std::lock_guard _(m);
+    ASSERT_EQ(seen_direct, (std::vector<int>{114, 514})) << "Unchanged values should not be notified.";
+    ASSERT_EQ(seen_chain, (std::vector<int>{114, 514})) << "Unchanged values should not be notified.";
+    ASSERT_EQ(seen_dynamic, (std::vector<int>{114, 514})) << "Unchanged values should not be notified.";
+}
+TEST(TestWatcher, test_shared_and_unsubscribe) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+
+    using namespace std::literals;
+
+    std::atomic<int> ground_truth = 1919;
+    WatchTarget target{
+        .width = PtrWidth::IS_CURRENT,
+        .base = reinterpret_cast<std::uintptr_t>(&ground_truth),
+        .offsets = {},
+        .size = sizeof(int),
+    };
+
+    std::atomic<int> count_a = 0;
+    std::atomic<int> count_b = 0;
+    Watcher watcher(p);
+    auto id_a = watcher.subscribe(target, 1ms, [&](std::span<const std::byte>) { count_a++; });
+    watcher.subscribe(target, 10ms, [&](std::span<const std::byte>) { count_b++; });
+    ASSERT_TRUE(wait_for([&] { return count_a == 1 && count_b == 1; }));
+
+    watcher.unsubscribe(id_a);
+    std::this_thread::sleep_for(20ms);
+    ground_truth = 810;
+    ASSERT_TRUE(wait_for([&] { return count_b == 2; }));
+    ASSERT_EQ(count_a, 1) << "Unsubscribed callbacks should not be called.";
+}
+TEST(TestWatcher, test_poll_callback) {
+    auto p = Process::try_from_current_process();
+    if (p.empty()) {
+        GTEST_SKIP() << "Cannot get current process unexpectedly.";
+    }
+
+    using namespace std::literals;
+
+    std::atomic<int> ground_truth = 1919;
+    std::atomic<int> notifications = 0;
+    std::atomic<int> polls = 0;
+    Watcher watcher(p);
+    watcher.set_poll_callback([&] { polls++; });
+    watcher.subscribe(WatchTarget{.base = reinterpret_cast<std::uintptr_t>(&ground_truth),
+                                  .offsets = {},
+                                  .size = sizeof(int)},
+                      1ms, [&](std::span<const std::byte>) { notifications++; });
+    ASSERT_TRUE(wait_for([&] { return polls >= 5; })) << "Every poll should be reported.";
+    ASSERT_EQ(notifications, 1) << "Only the first read should be notified.";
+}